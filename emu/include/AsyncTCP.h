@@ -0,0 +1,2 @@
+#pragma once
+// EMULATOR: nothing of AsyncTCP is used directly
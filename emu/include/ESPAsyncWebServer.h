@@ -0,0 +1,162 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include <string>
+
+// =========================================================================
+// EMULATOR: ESPAsyncWebServer
+// Routes match like the library's (method mask, exact path or a path
+// below it). Requests arrive from the emulator's script, or over real
+// HTTP when emuSetHttpPort() picked a port, and run on that thread.
+// Form posts arrive as parameters; file uploads and WebSocket viewers
+// are not emulated.
+// =========================================================================
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, const String& filename, size_t index, uint8_t* data,
+                           size_t len, bool final)> ArUploadHandlerFunction;
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String& name, const String& value) : _name(name), _value(value) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+  bool isPost() const { return false; }
+  bool isFile() const { return false; }
+
+private:
+  String _name;
+  String _value;
+};
+
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse(int code, const String& contentType) : code(code), contentType(contentType) {}
+  void addHeader(const String& name, const String& value) { headers.push_back({name, value}); }
+
+  int code;
+  String contentType;
+  std::vector<std::pair<String, String>> headers;
+  std::string body;         // Fixed content...
+  AwsResponseFiller filler; // ...or chunks pulled until it returns 0
+};
+
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(WebRequestMethod method, const String& url);
+  ~AsyncWebServerRequest();
+
+  WebRequestMethod method() const { return _method; }
+  const String& url() const { return _url; }
+  size_t params() const { return _params.size(); }
+  bool hasParam(const String& name, bool post = false, bool file = false) const;
+  AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false);
+  AsyncWebParameter* getParam(size_t index) { return index < _params.size() ? &_params[index] : nullptr; }
+  String arg(const String& name);
+
+  void send(int code, const String& contentType = String(), const String& content = String());
+  void send(AsyncWebServerResponse* response);
+  void redirect(const String& url);
+  AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(), const String& content = String());
+  AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller filler);
+
+  AsyncWebServerResponse* emuResponse() { return _response; }
+
+private:
+  WebRequestMethod _method;
+  String _url;
+  std::vector<AsyncWebParameter> _params;
+  AsyncWebServerResponse* _response = nullptr;
+};
+
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() {}
+  virtual bool canHandle(AsyncWebServerRequest* request) = 0;
+  virtual void handleRequest(AsyncWebServerRequest* request) = 0;
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+  AsyncCallbackWebHandler(const String& uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                          ArUploadHandlerFunction onUpload)
+    : _uri(uri), _method(method), _onRequest(onRequest), _onUpload(onUpload) {}
+  bool canHandle(AsyncWebServerRequest* request) override;
+  void handleRequest(AsyncWebServerRequest* request) override;
+
+private:
+  String _uri;
+  WebRequestMethodComposite _method;
+  ArRequestHandlerFunction _onRequest;
+  ArUploadHandlerFunction _onUpload;
+};
+
+// --- WebSocket (accepts handlers and broadcasts; never has clients) ---
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+
+class AsyncWebSocket;
+class AsyncWebSocketClient {
+public:
+  uint32_t id() const { return 0; }
+};
+
+typedef std::function<void(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                           uint8_t* data, size_t len)> AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const String& url) : _url(url) {}
+  const char* url() const { return _url.c_str(); }
+  void onEvent(AwsEventHandler handler) { _handler = handler; }
+  void cleanupClients(uint16_t maxClients = 8) {}
+  size_t count() const { return 0; }
+  bool availableForWriteAll() { return true; }
+  void binaryAll(uint8_t* message, size_t len) {}
+  void textAll(const String& message) {}
+  bool canHandle(AsyncWebServerRequest* request) override { return request->url() == _url; }
+  void handleRequest(AsyncWebServerRequest* request) override;
+
+private:
+  String _url;
+  AwsEventHandler _handler;
+};
+
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port) : _port(port) {}
+  ~AsyncWebServer();
+
+  AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest);
+  AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload);
+  AsyncWebHandler& addHandler(AsyncWebHandler* handler);
+  void onNotFound(ArRequestHandlerFunction fn) { _notFound = fn; }
+  void begin();
+  void end() {}
+
+  // Runs one request through the handlers; the response body is
+  // collected in full (chunked fillers are drained)
+  int emuRequest(WebRequestMethod method, const String& url, String& contentType, std::string& body,
+                 std::vector<std::pair<String, String>>* headers = nullptr);
+
+private:
+  uint16_t _port;
+  std::vector<AsyncWebHandler*> _handlers;
+  std::vector<AsyncCallbackWebHandler*> _owned;
+  ArRequestHandlerFunction _notFound;
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+  bool begin(const char* hostName) { return true; }
+  void end() {}
+  bool addService(const char* service, const char* proto, uint16_t port) { return true; }
+};
+extern MDNSResponder MDNS;
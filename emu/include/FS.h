@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+
+// =========================================================================
+// EMULATOR: Arduino FS on a host directory
+// =========================================================================
+namespace fs {
+
+class File : public Stream {
+public:
+  File() {}
+  File(FILE* file, const String& path);
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t* buf, size_t size);
+  void flush() override;
+  bool seek(uint32_t pos);
+  size_t position() const;
+  size_t size() const;
+  void close() { file.reset(); }
+  operator bool() const { return file != nullptr; }
+  const char* path() const { return _path.c_str(); }
+  const char* name() const;
+
+private:
+  std::shared_ptr<FILE> file;
+  String _path;
+};
+
+class FS {
+public:
+  File open(const char* path, const char* mode = "r", bool create = false);
+  File open(const String& path, const char* mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool mkdir(const char* path);
+
+protected:
+  String hostPath(const char* path);
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
@@ -0,0 +1,56 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <vector>
+
+// =========================================================================
+// EMULATOR: HTTPClient
+// HTTP/1.1 over a WiFiClient, with keep-alive like the ESP32 core's. URLs
+// are rewritten for the fixture server: https://host/path?q becomes
+// GET /host/path?q on emuSetFixtureServer()'s host and port.
+// =========================================================================
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTP_CODE_OK 200
+
+class HTTPClient {
+public:
+  bool begin(WiFiClient& client, const String& url);
+  void end();
+  void setReuse(bool reuse) { _reuse = reuse; }
+  void setTimeout(uint16_t timeout) { _timeout = timeout; }
+  void collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+  String header(const char* name);
+
+  int GET();
+  int getSize() { return _size; }
+  WiFiClient& getStream() { return *_client; }
+  String getString();
+  static String errorToString(int error);
+
+private:
+  WiFiClient* _client = nullptr;
+  String _host;        // Where the socket goes
+  uint16_t _port = 80;
+  String _path;        // What is asked for there
+  String _hostHeader;
+  bool _reuse = true;
+  bool _canReuse = false;
+  int _size = -1;
+  bool _chunked = false;
+  uint16_t _timeout = 5000;
+  std::vector<String> _headerKeys;
+  std::vector<String> _headerValues;
+
+  bool readLine(String& line);
+};
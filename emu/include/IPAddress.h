@@ -0,0 +1,23 @@
+#pragma once
+#include "Print.h"
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : IPAddress(0, 0, 0, 0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+
+  uint8_t operator[](int index) const { return octets[index]; }
+  bool operator==(const IPAddress& rhs) const { return memcmp(octets, rhs.octets, 4) == 0; }
+
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+    return String(buf);
+  }
+  size_t printTo(Print& p) const override { return p.print(toString()); }
+
+private:
+  uint8_t octets[4];
+};
+
+#define INADDR_NONE IPAddress(0, 0, 0, 0)
@@ -0,0 +1,19 @@
+#pragma once
+#include <FS.h>
+
+namespace fs {
+
+// Files live under the directory given to emuSetFsRoot() (see emu.h)
+class LittleFSFS : public FS {
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+             const char* partitionLabel = "spiffs");
+  void end() {}
+  bool format();
+  size_t totalBytes() { return 1408 * 1024; }
+  size_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
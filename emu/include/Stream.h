@@ -0,0 +1,26 @@
+#pragma once
+#include "Print.h"
+
+// =========================================================================
+// EMULATOR: Stream
+// Blocking reads honour setTimeout() like the ESP32 core.
+// =========================================================================
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  String readString();
+  String readStringUntil(char terminator);
+
+protected:
+  unsigned long _timeout = 1000;
+  int timedRead();
+};
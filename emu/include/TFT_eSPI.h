@@ -0,0 +1,231 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// EMULATOR: TFT_eSPI
+// A software framebuffer with the TFT_eSPI calls the firmware makes. The
+// panel keeps native RGB565; 16-bit sprites keep the byte-swapped (panel)
+// order the real library uses and 4-bit sprites its packing (two palette
+// indices a byte, the left pixel in the high nibble), so code that
+// touches getPointer() sees the same bytes as on the board. Viewports, datums, swapBytes and the
+// sprite push paths follow the library's semantics.
+//
+// Fonts are stand-ins: every built-in and FreeFont is the classic 5x7
+// glyph set scaled to roughly the real font's height, so layouts land in
+// the right place but text is blockier than on the panel.
+// =========================================================================
+
+#define TFT_WIDTH 240
+#define TFT_HEIGHT 320
+
+// Stand-in for the Adafruit GFX font struct
+struct GFXfont {
+  const char* name;
+  float scale; // 5x7 glyph scale that matches the font's height
+  bool bold;
+};
+
+extern const GFXfont FreeSans9pt7b;
+extern const GFXfont FreeSans12pt7b;
+extern const GFXfont FreeSans18pt7b;
+extern const GFXfont FreeSans24pt7b;
+extern const GFXfont FreeSansBold9pt7b;
+extern const GFXfont FreeSansBold12pt7b;
+extern const GFXfont FreeSansBold18pt7b;
+extern const GFXfont FreeSansBold24pt7b;
+
+// Text datums
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+#define L_BASELINE 9
+#define C_BASELINE 10
+#define R_BASELINE 11
+
+// Default colours
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGREEN 0x03E0
+#define TFT_DARKCYAN 0x03EF
+#define TFT_MAROON 0x7800
+#define TFT_PURPLE 0x780F
+#define TFT_OLIVE 0x7BE0
+#define TFT_LIGHTGREY 0xD69A
+#define TFT_DARKGREY 0x7BEF
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_ORANGE 0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK 0xFE19
+#define TFT_BROWN 0x9A60
+#define TFT_GOLD 0xFEA0
+#define TFT_SILVER 0xC618
+#define TFT_SKYBLUE 0x867D
+#define TFT_VIOLET 0x915C
+#define TFT_TRANSPARENT 0x0120
+
+// ILI9341 commands
+#define TFT_SLPIN 0x10
+#define TFT_SLPOUT 0x11
+
+class TFT_eSPI : public Print {
+public:
+  TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+  virtual ~TFT_eSPI();
+
+  void init(uint8_t tc = 0);
+  void begin(uint8_t tc = 0) { init(tc); }
+  void setRotation(uint8_t r);
+  uint8_t getRotation() const { return rotation; }
+  void invertDisplay(bool i) { inverted = i; }
+  int16_t width() const { return _vpDatum ? _xWidth : _width; }
+  int16_t height() const { return _vpDatum ? _yHeight : _height; }
+
+  // --- Graphics primitives ---
+  virtual void drawPixel(int32_t x, int32_t y, uint32_t color);
+  virtual uint16_t readPixel(int32_t x, int32_t y);
+  virtual void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  virtual void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+  virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void fillScreen(uint32_t color);
+  void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+  void drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+  void fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+  void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+  void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+
+  // --- Text ---
+  void setTextColor(uint16_t color) { textcolor = textbgcolor = color; }
+  void setTextColor(uint16_t fg, uint16_t bg, bool bgfill = false) { textcolor = fg; textbgcolor = bg; }
+  void setTextSize(uint8_t size) { textsize = size > 0 ? size : 1; }
+  void setTextDatum(uint8_t datum) { textdatum = datum; }
+  uint8_t getTextDatum() const { return textdatum; }
+  void setTextPadding(uint16_t width) { padX = width; }
+  void setFreeFont(const GFXfont* f = nullptr);
+  void setTextFont(uint8_t font);
+  void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+  int16_t drawString(const String& string, int32_t x, int32_t y) { return drawString(string.c_str(), x, y); }
+  int16_t drawString(const char* string, int32_t x, int32_t y);
+  int16_t drawString(const char* string, int32_t x, int32_t y, uint8_t font);
+  int16_t drawNumber(long value, int32_t x, int32_t y) { return drawString(String(value), x, y); }
+  int16_t drawFloat(float value, uint8_t dp, int32_t x, int32_t y) { return drawString(String(value, (unsigned int)dp), x, y); }
+  int16_t textWidth(const String& string) { return textWidth(string.c_str()); }
+  int16_t textWidth(const char* string);
+  int16_t fontHeight();
+  size_t write(uint8_t c) override; // print() at the cursor, top-left datum
+  using Print::write;
+
+  // --- Viewport ---
+  void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+  void resetViewport();
+  int32_t getViewportX() const { return _xDatum; }
+  int32_t getViewportY() const { return _yDatum; }
+  int32_t getViewportWidth() const { return _xWidth; }
+  int32_t getViewportHeight() const { return _yHeight; }
+  bool getViewportDatum() const { return _vpDatum; }
+
+  // --- Pixel pushing ---
+  void startWrite() {}
+  void endWrite() {}
+  void setSwapBytes(bool swap) { swapBytes = swap; }
+  bool getSwapBytes() const { return swapBytes; }
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+  bool initDMA(bool ctrl_cs = false) { return true; }
+  void deInitDMA() {}
+  void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint16_t* buffer = nullptr);
+  void dmaWait() {}
+  bool dmaBusy() { return false; }
+  void writecommand(uint8_t c) { if (c == TFT_SLPIN || c == TFT_SLPOUT) asleep = c == TFT_SLPIN; }
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+  uint16_t alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc);
+
+  // --- Emulator only ---
+  const uint16_t* emuPixels() const { return buffer; } // Native RGB565, width() x height()
+  uint32_t emuVersion() const { return version; }      // Bumped by every write to the panel
+  unsigned long emuPixelsWritten() const { return pixelsWritten; }
+  bool emuInverted() const { return inverted; }
+  bool emuAsleep() const { return asleep; } // Between TFT_SLPIN and TFT_SLPOUT
+
+protected:
+  // Storage; sprites hold panel byte order
+  uint16_t* buffer = nullptr;
+  uint8_t* nibbles = nullptr; // 4-bit sprites instead: colours are palette indices
+  bool panelOrder = false;
+  int32_t _width, _height; // Of the buffer, after rotation
+  uint8_t rotation = 0;
+  bool inverted = false;
+  bool asleep = false;
+  bool swapBytes = false;
+  uint32_t version = 0;
+  unsigned long pixelsWritten = 0;
+
+  // Viewport: clip rect [_vpX, _vpW) x [_vpY, _vpH) and coordinate datum
+  int32_t _vpX = 0, _vpY = 0, _vpW = 0, _vpH = 0;
+  int32_t _xDatum = 0, _yDatum = 0, _xWidth = 0, _yHeight = 0;
+  bool _vpDatum = false;
+
+  // Text state
+  uint16_t textcolor = TFT_WHITE, textbgcolor = TFT_WHITE;
+  uint8_t textsize = 1, textdatum = TL_DATUM, textfont = 1;
+  const GFXfont* freeFont = nullptr;
+  uint16_t padX = 0;
+  int32_t cursorX = 0, cursorY = 0;
+
+  void allocate(int32_t w, int32_t h);
+  void fillClipped(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color); // Absolute coords
+  void blit(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data, int32_t stride, bool dataPanelOrder);
+  void fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint32_t color);
+  float glyphScale() const;
+  float glyphXScale() const;
+  bool glyphBold() const;
+  int16_t drawGlyph(char c, int32_t x, int32_t y, float xScale, float scale, bool bold);
+
+  static uint16_t swap16(uint16_t v) { return (v >> 8) | (v << 8); }
+
+  friend class TFT_eSprite;
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+  explicit TFT_eSprite(TFT_eSPI* tft);
+  ~TFT_eSprite() override;
+
+  void setColorDepth(int8_t depth) { colorDepth = depth; } // 4 is packed, anything else is stored as 16-bit
+  int8_t getColorDepth() const { return colorDepth; }
+  void* createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+  void deleteSprite();
+  bool created() const { return buffer != nullptr || nibbles != nullptr; }
+  void* getPointer() { return nibbles != nullptr ? (void*)nibbles : (void*)buffer; }
+
+  // 4-bit sprites: the RGB565 colour of each index, used by pushSprite() and readPixel()
+  void createPalette(const uint16_t* colors, uint8_t count = 16);
+  uint16_t readPixel(int32_t x, int32_t y) override;
+  uint16_t readPixelValue(int32_t x, int32_t y); // The stored index
+
+  void fillSprite(uint32_t color);
+  void pushSprite(int32_t x, int32_t y);
+  bool pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
+
+private:
+  TFT_eSPI* parent;
+  int8_t colorDepth = 16;
+  uint16_t palette[16] = {0};
+
+  void pushIndexed(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+// EMULATOR: there is no flash to update; every step fails cleanly
+class UpdateClass {
+public:
+  bool begin(size_t size = UPDATE_SIZE_UNKNOWN) { return false; }
+  size_t write(uint8_t* data, size_t len) { return 0; }
+  bool end(bool evenIfRemaining = false) { return false; }
+  void printError(Print& out) { out.println("OTA updates are not supported in the emulator"); }
+};
+extern UpdateClass Update;
@@ -0,0 +1,114 @@
+#pragma once
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+
+// =========================================================================
+// EMULATOR: Arduino String
+// The subset of the ESP32 core's String the firmware (and ArduinoJson's
+// Arduino adapters) use, backed by std::string.
+// =========================================================================
+class String {
+public:
+  String() {}
+  String(const char* cstr) : s(cstr ? cstr : "") {}
+  String(const char* cstr, unsigned int length) : s(cstr ? cstr : "", cstr ? length : 0) {}
+  String(const std::string& str) : s(str) {}
+  explicit String(char c) : s(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+
+  unsigned int length() const { return s.length(); }
+  bool isEmpty() const { return s.empty(); }
+  const char* c_str() const { return s.c_str(); }
+  bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+  bool concat(const String& str) { s += str.s; return true; }
+  bool concat(const char* cstr) { if (cstr) s += cstr; return cstr != nullptr; }
+  bool concat(const char* cstr, unsigned int length) { if (cstr) s.append(cstr, length); return cstr != nullptr; }
+  bool concat(char c) { s += c; return true; }
+  bool concat(unsigned char num) { return concat(String(num)); }
+  bool concat(int num) { return concat(String(num)); }
+  bool concat(unsigned int num) { return concat(String(num)); }
+  bool concat(long num) { return concat(String(num)); }
+  bool concat(unsigned long num) { return concat(String(num)); }
+  bool concat(long long num) { return concat(String(num)); }
+  bool concat(unsigned long long num) { return concat(String(num)); }
+  bool concat(float num) { return concat(String(num)); }
+  bool concat(double num) { return concat(String(num)); }
+
+  template <typename T> String& operator+=(const T& rhs) { concat(rhs); return *this; }
+
+  char charAt(unsigned int index) const { return index < s.length() ? s[index] : 0; }
+  void setCharAt(unsigned int index, char c) { if (index < s.length()) s[index] = c; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index) { return s[index]; }
+
+  bool equals(const String& str) const { return s == str.s; }
+  bool equals(const char* cstr) const { return s == (cstr ? cstr : ""); }
+  bool equalsIgnoreCase(const String& str) const;
+  int compareTo(const String& str) const { return s.compare(str.s); }
+  bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.length(), prefix.s) == 0; }
+  bool endsWith(const String& suffix) const;
+
+  int indexOf(char c, unsigned int from = 0) const { return find(s.find(c, from)); }
+  int indexOf(const String& str, unsigned int from = 0) const { return find(s.find(str.s, from)); }
+  int lastIndexOf(char c) const { return find(s.rfind(c)); }
+  int lastIndexOf(const String& str) const { return find(s.rfind(str.s)); }
+  String substring(unsigned int from) const { return substring(from, s.length()); }
+  String substring(unsigned int from, unsigned int to) const;
+
+  void replace(char find, char replacement);
+  void replace(const String& find, const String& replacement);
+  void remove(unsigned int index) { if (index < s.length()) s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < s.length()) s.erase(index, count); }
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s.c_str(), nullptr); }
+  double toDouble() const { return strtod(s.c_str(), nullptr); }
+
+  void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+    getBytes((unsigned char*)buf, bufsize, index);
+  }
+
+  bool operator==(const String& rhs) const { return s == rhs.s; }
+  bool operator==(const char* rhs) const { return equals(rhs); }
+  bool operator!=(const String& rhs) const { return s != rhs.s; }
+  bool operator!=(const char* rhs) const { return !equals(rhs); }
+  bool operator<(const String& rhs) const { return s < rhs.s; }
+  bool operator>(const String& rhs) const { return s > rhs.s; }
+
+  const std::string& str() const { return s; }
+
+private:
+  std::string s;
+  static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+
+inline String operator+(const String& lhs, const String& rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, const char* rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const char* lhs, const String& rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, char rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, int rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, unsigned int rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, long rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, unsigned long rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, float rhs) { String out(lhs); out.concat(rhs); return out; }
+inline String operator+(const String& lhs, double rhs) { String out(lhs); out.concat(rhs); return out; }
+inline bool operator==(const char* lhs, const String& rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char* lhs, const String& rhs) { return !rhs.equals(lhs); }
+
+// Only used for type checks (F() returns a plain pointer in the emulator)
+class __FlashStringHelper;
@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+// =========================================================================
+// EMULATOR: WebSocketsClient
+// Plain ws:// only (enough for tools/finnhub_ws_replay.py): text, ping
+// and close frames, unfragmented. wss:// logs once and stays
+// disconnected.
+// =========================================================================
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+class WebSocketsClient {
+public:
+  typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+  void begin(const char* host, uint16_t port, const char* url = "/", const char* protocol = "arduino");
+  void beginSSL(const char* host, uint16_t port, const char* url = "/", const char* fingerprint = "",
+                const char* protocol = "arduino");
+  void beginSslWithCA(const char* host, uint16_t port, const char* url = "/", const char* CA_cert = nullptr,
+                      const char* protocol = "arduino");
+  void onEvent(WebSocketClientEvent cbEvent) { _event = cbEvent; }
+  void setReconnectInterval(unsigned long time) { _reconnectInterval = time; }
+  void enableHeartbeat(uint32_t pingInterval, uint32_t pongTimeout, uint8_t disconnectTimeoutCount) {}
+  void disconnect();
+  void loop();
+  bool sendTXT(const char* payload, size_t length = 0);
+  bool sendTXT(const String& payload) { return sendTXT(payload.c_str(), payload.length()); }
+  bool isConnected() { return _connected; }
+
+private:
+  WiFiClient _client;
+  String _host;
+  uint16_t _port = 0;
+  String _url;
+  bool _active = false;
+  bool _connected = false;
+  unsigned long _reconnectInterval = 500;
+  unsigned long _lastAttempt = 0;
+  bool _attempted = false;
+  WebSocketClientEvent _event;
+
+  bool handshake();
+  bool sendFrame(uint8_t opcode, const uint8_t* payload, size_t length);
+  bool readFrame();
+  void dropConnection();
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <Arduino.h>
+#include <Client.h>
+
+// =========================================================================
+// EMULATOR: WiFi
+// Connected, as 127.0.0.1, to any network whose SSID does not start
+// with "unreachable"; those are never found. Events (WiFi.onEvent) come
+// from their own thread, as on the device. WiFiClient is a plain TCP
+// socket.
+// =========================================================================
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+typedef union {
+  struct {
+    uint8_t ssid[33];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t reason;
+    int8_t rssi;
+  } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+#define WiFiEvent_t arduino_event_id_t
+#define WiFiEventInfo_t arduino_event_info_t
+typedef void (*WiFiEventFuncCb)(arduino_event_id_t event, arduino_event_info_t info);
+typedef size_t wifi_event_id_t;
+
+// Disconnect reasons (esp_wifi_types.h)
+#define WIFI_REASON_ASSOC_LEAVE 8
+#define WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT 15
+#define WIFI_REASON_NO_AP_FOUND 201
+#define WIFI_REASON_AUTH_FAIL 202
+#define WIFI_REASON_HANDSHAKE_TIMEOUT 204
+
+typedef enum {
+  WIFI_PS_NONE,
+  WIFI_PS_MIN_MODEM,
+  WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+class WiFiClass {
+public:
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+  bool config(IPAddress local, IPAddress gateway, IPAddress subnet) { return true; }
+  bool setHostname(const char* name) { return true; }
+  bool disconnect(bool wifiOff = false);
+  wifi_event_id_t onEvent(WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+  wl_status_t status() { return status_; }
+  uint8_t waitForConnectResult(unsigned long timeoutLength = 60000) { return status_; }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+  String SSID() { return ssid_; }
+  int8_t RSSI() { return -55; }
+  bool setSleep(bool enabled) { return setSleep(enabled ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE); }
+  bool setSleep(wifi_ps_type_t type) { sleep_ = type; return true; }
+  wifi_ps_type_t getSleep() { return sleep_; }
+
+private:
+  wl_status_t status_ = WL_DISCONNECTED;
+  String ssid_;
+  wifi_ps_type_t sleep_ = WIFI_PS_NONE;
+};
+extern WiFiClass WiFi;
+
+class WiFiClient : public Client {
+public:
+  WiFiClient() {}
+  ~WiFiClient() override { stop(); }
+  WiFiClient(const WiFiClient&) = delete;
+  WiFiClient& operator=(const WiFiClient&) = delete;
+
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size) override;
+  int peek() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+  using Print::write;
+
+private:
+  int fd = -1;
+  int peeked = -1;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <WiFi.h>
+
+// =========================================================================
+// EMULATOR: TLS client
+// Plain TCP: HTTPClient sends every https:// URL to the fixture server
+// over http (see emuSetFixtureServer() in emu.h), so certificates are
+// accepted and ignored.
+// =========================================================================
+class WiFiClientSecure : public WiFiClient {
+public:
+  void setCACert(const char* rootCA) {}
+  void setInsecure() {}
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+
+// =========================================================================
+// EMULATOR: XPT2046 touch controller
+// Reports whatever the emulator's script pressed (see emuTouch() in
+// emu.h), in raw ADC units like the real controller.
+// =========================================================================
+class TS_Point {
+public:
+  TS_Point() : x(0), y(0), z(0) {}
+  TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+  bool operator==(const TS_Point& p) const { return x == p.x && y == p.y && z == p.z; }
+  bool operator!=(const TS_Point& p) const { return !(*this == p); }
+  int16_t x, y, z;
+};
+
+class XPT2046_Touchscreen {
+public:
+  XPT2046_Touchscreen(uint8_t cs, uint8_t tirq = 255) {}
+  bool begin() { return true; }
+  bool begin(SPIClass& spi) { return true; }
+  void setRotation(uint8_t r) {}
+  TS_Point getPoint();
+  bool tirqTouched();
+  bool touched();
+  bool bufferEmpty() { return !touched(); }
+};
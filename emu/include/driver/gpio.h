@@ -0,0 +1,22 @@
+#pragma once
+#include "../esp_err.h"
+
+// =========================================================================
+// EMULATOR: ESP-IDF GPIO driver, just the interrupt switches. A disabled
+// pin remembers an emuInterrupt() and raises it when it is enabled again,
+// as a level interrupt would.
+// =========================================================================
+typedef int gpio_num_t;
+
+typedef enum {
+  GPIO_INTR_DISABLE,
+  GPIO_INTR_POSEDGE,
+  GPIO_INTR_NEGEDGE,
+  GPIO_INTR_ANYEDGE,
+  GPIO_INTR_LOW_LEVEL,
+  GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio);
+esp_err_t gpio_intr_disable(gpio_num_t gpio);
+inline esp_err_t gpio_wakeup_enable(gpio_num_t gpio, gpio_int_type_t type) { return ESP_OK; }
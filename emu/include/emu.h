@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// EMULATOR CONTROL
+// What emu_main.cpp uses to drive the shims. Not part of any Arduino
+// library, and never included from src/.
+// =========================================================================
+
+// --- Touch: raw XPT2046 units. The finger moves in a straight line
+// from the first point to the second over moveMs and lets go holdMs
+// after it pressed; the controller follows the clock, not loop() ---
+void emuPress(int16_t rawX, int16_t rawY, int16_t toRawX, int16_t toRawY, unsigned long moveMs, unsigned long holdMs);
+
+// --- Interrupts: run the handler attached to `pin`, as its edge would ---
+void emuInterrupt(uint8_t pin);
+
+// --- Idle: the next loop() pass may block in ulTaskNotifyTake() for at
+// most `ms` (until the next script event); and how long it has, in all ---
+void emuLimitLoopIdle(unsigned long ms);
+unsigned long emuLoopIdleUs();
+
+// --- Network: where HTTPClient sends https:// requests (empty host = straight to the URL's host, http:// only) ---
+void emuSetFixtureServer(const String& host, uint16_t port);
+
+// --- Web server: also listen on this host port (0 = script requests only) ---
+void emuSetHttpPort(uint16_t port);
+
+// --- LittleFS: host directory that stands in for the flash partition ---
+void emuSetFsRoot(const String& dir);
+
+// --- Frames: RGB565 to an 8-bit RGB PNG ---
+bool emuWritePng(const char* path, const uint16_t* pixels, int width, int height);
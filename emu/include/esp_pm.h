@@ -0,0 +1,30 @@
+#pragma once
+#include "esp_err.h"
+
+// =========================================================================
+// EMULATOR: ESP-IDF power management
+// Accepts any configuration; the host clock does not change. Locks are
+// counted, nothing else.
+// =========================================================================
+typedef struct {
+  int max_freq_mhz;
+  int min_freq_mhz;
+  bool light_sleep_enable;
+} esp_pm_config_esp32_t;
+
+typedef enum {
+  ESP_PM_CPU_FREQ_MAX,
+  ESP_PM_APB_FREQ_MAX,
+  ESP_PM_NO_LIGHT_SLEEP,
+} esp_pm_lock_type_t;
+
+typedef struct EmuPmLock { int count; }* esp_pm_lock_handle_t;
+
+inline esp_err_t esp_pm_configure(const void* config) { return config != nullptr ? ESP_OK : ESP_ERR_INVALID_ARG; }
+
+inline esp_err_t esp_pm_lock_create(esp_pm_lock_type_t type, int arg, const char* name, esp_pm_lock_handle_t* out) {
+  *out = new EmuPmLock{0}; // Locks live as long as the emulator
+  return ESP_OK;
+}
+inline esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t lock) { lock->count++; return ESP_OK; }
+inline esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t lock) { lock->count--; return ESP_OK; }
@@ -0,0 +1,473 @@
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <random>
+#include <unistd.h>
+
+// =========================================================================
+// EMULATOR: Arduino core and FreeRTOS on the host
+// =========================================================================
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+// =====================================================
+// --- STRING ---
+// =====================================================
+
+// --- HELPER: Integer to text in any base ---
+static std::string integerText(unsigned long long value, bool negative, unsigned char base) {
+  if (base < 2 || base > 36) base = 10;
+  char buf[72];
+  int i = sizeof(buf) - 1;
+  buf[i] = 0;
+  do {
+    int digit = value % base;
+    buf[--i] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value > 0);
+  if (negative) buf[--i] = '-';
+  return std::string(buf + i);
+}
+
+String::String(unsigned char value, unsigned char base) : s(integerText(value, false, base)) {}
+String::String(int value, unsigned char base)
+  : s(integerText(value < 0 && base == 10 ? -(long long)value : (unsigned int)value, value < 0 && base == 10, base)) {}
+String::String(unsigned int value, unsigned char base) : s(integerText(value, false, base)) {}
+String::String(long value, unsigned char base)
+  : s(integerText(value < 0 && base == 10 ? -(long long)value : (unsigned long)value, value < 0 && base == 10, base)) {}
+String::String(unsigned long value, unsigned char base) : s(integerText(value, false, base)) {}
+String::String(long long value, unsigned char base)
+  : s(integerText(value < 0 && base == 10 ? -(unsigned long long)value : (unsigned long long)value, value < 0 && base == 10, base)) {}
+String::String(unsigned long long value, unsigned char base) : s(integerText(value, false, base)) {}
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+String::String(double value, unsigned int decimalPlaces) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  s = buf;
+}
+
+bool String::equalsIgnoreCase(const String& str) const {
+  if (s.length() != str.s.length()) return false;
+  for (size_t i = 0; i < s.length(); i++) {
+    if (tolower((unsigned char)s[i]) != tolower((unsigned char)str.s[i])) return false;
+  }
+  return true;
+}
+
+bool String::endsWith(const String& suffix) const {
+  return s.length() >= suffix.s.length() && s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= s.length()) return String();
+  if (to > s.length()) to = s.length();
+  return String(s.substr(from, to - from));
+}
+
+void String::replace(char find, char replacement) {
+  std::replace(s.begin(), s.end(), find, replacement);
+}
+
+void String::replace(const String& find, const String& replacement) {
+  if (find.s.empty()) return;
+  size_t pos = 0;
+  while ((pos = s.find(find.s, pos)) != std::string::npos) {
+    s.replace(pos, find.s.length(), replacement.s);
+    pos += replacement.s.length();
+  }
+}
+
+void String::toLowerCase() {
+  for (char& c : s) c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char& c : s) c = toupper((unsigned char)c);
+}
+
+void String::trim() {
+  size_t start = s.find_first_not_of(" \t\r\n\f\v");
+  if (start == std::string::npos) {
+    s.clear();
+    return;
+  }
+  size_t end = s.find_last_not_of(" \t\r\n\f\v");
+  s = s.substr(start, end - start + 1);
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+  if (bufsize == 0) return;
+  size_t n = 0;
+  if (index < s.length()) n = std::min((size_t)bufsize - 1, s.length() - index);
+  memcpy(buf, s.data() + index, n);
+  buf[n] = 0;
+}
+
+// =====================================================
+// --- PRINT / STREAM ---
+// =====================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char small[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(small, sizeof(small), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof(small)) return write((const uint8_t*)small, len);
+
+  std::vector<char> big(len + 1);
+  va_start(args, format);
+  vsnprintf(big.data(), big.size(), format, args);
+  va_end(args);
+  return write((const uint8_t*)big.data(), len);
+}
+
+size_t Print::print(long n, int base) {
+  return print(String(n, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long n, int base) {
+  return print(String(n, (unsigned char)base));
+}
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) return c;
+    delay(1);
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0) break;
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+String Stream::readString() {
+  String out;
+  int c;
+  while ((c = timedRead()) >= 0) out += (char)c;
+  return out;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String out;
+  int c;
+  while ((c = timedRead()) >= 0 && c != terminator) out += (char)c;
+  return out;
+}
+
+// Serial output from every task goes out in whole writes
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  static std::mutex lock;
+  std::lock_guard<std::mutex> guard(lock);
+  fwrite(buffer, 1, size, stdout);
+  fflush(stdout);
+  return size;
+}
+
+void EspClass::restart() {
+  Serial.println("[emu] ESP.restart() called, exiting");
+  exit(0);
+}
+
+// =====================================================
+// --- TIME, MATH, GPIO ---
+// =====================================================
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+static std::mt19937 rng(1);
+
+long random(long howBig) {
+  if (howBig <= 0) return 0;
+  return rng() % howBig;
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+  rng.seed(seed);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+int digitalRead(uint8_t pin) { return HIGH; }
+
+// Handlers by pin; a disabled pin keeps the interrupt until it is enabled
+static void (*interruptHandlers[64])() = {};
+static bool interruptDisabled[64] = {};
+static bool interruptPending[64] = {};
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  if (pin >= 64) return;
+  interruptHandlers[pin] = (mode == RISING || mode == ONHIGH || mode == ONHIGH_WE) ? nullptr : handler;
+  interruptDisabled[pin] = interruptPending[pin] = false;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < 64) interruptHandlers[pin] = nullptr;
+}
+
+void emuInterrupt(uint8_t pin) {
+  if (pin >= 64 || interruptHandlers[pin] == nullptr) return;
+  if (interruptDisabled[pin]) interruptPending[pin] = true;
+  else interruptHandlers[pin]();
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio) {
+  if (gpio < 0 || gpio >= 64) return ESP_ERR_INVALID_ARG;
+  interruptDisabled[gpio] = true;
+  return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio) {
+  if (gpio < 0 || gpio >= 64) return ESP_ERR_INVALID_ARG;
+  interruptDisabled[gpio] = false;
+  if (interruptPending[gpio]) {
+    interruptPending[gpio] = false;
+    emuInterrupt(gpio);
+  }
+  return ESP_OK;
+}
+
+static uint32_t cpuMhz = 240;
+
+uint32_t getCpuFrequencyMhz() {
+  return cpuMhz;
+}
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+  cpuMhz = mhz;
+  return true;
+}
+
+void configTzTime(const char* tz, const char* server1, const char* server2, const char* server3) {
+  setenv("TZ", tz, 1);
+  tzset();
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+  time_t now = time(nullptr);
+  localtime_r(&now, info);
+  return true;
+}
+
+// =====================================================
+// --- FREERTOS ---
+// =====================================================
+
+struct EmuTask {
+  std::mutex lock;
+  std::condition_variable wake;
+  uint32_t notifications = 0;
+};
+
+struct EmuSemaphore {
+  std::timed_mutex mutex;
+};
+
+struct EmuQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  size_t length;
+  size_t itemSize;
+};
+
+// loop() and any thread the emulator starts get a handle on first use
+static thread_local EmuTask* currentTask = nullptr;
+
+// --- HELPER: Wait on a condition for up to `ticks` (portMAX_DELAY = forever) ---
+template <typename Predicate>
+static bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& guard, TickType_t ticks, Predicate ready) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(guard, ready);
+    return true;
+  }
+  return cv.wait_for(guard, std::chrono::milliseconds(ticks), ready);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+  EmuTask* task = new EmuTask(); // Tasks live as long as the emulator
+  if (created != nullptr) *created = task;
+  std::thread([task, code, param]() {
+    currentTask = task;
+    code(param);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* created) {
+  return xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (currentTask == nullptr) currentTask = new EmuTask();
+  return currentTask;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  // A task that deletes itself just stops running; its thread parks forever
+  for (;;) std::this_thread::sleep_for(std::chrono::hours(1));
+}
+
+TickType_t xTaskGetTickCount() {
+  return millis();
+}
+
+// loop()'s idle limit (see emuLimitLoopIdle())
+static EmuTask* limitedTask = nullptr;
+static TickType_t loopIdleLimit = portMAX_DELAY;
+static unsigned long loopIdleUs = 0;
+
+void emuLimitLoopIdle(unsigned long ms) {
+  limitedTask = xTaskGetCurrentTaskHandle();
+  loopIdleLimit = ms;
+}
+
+unsigned long emuLoopIdleUs() {
+  return loopIdleUs;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  EmuTask* task = xTaskGetCurrentTaskHandle();
+  bool limited = task == limitedTask;
+  if (limited && (ticksToWait == portMAX_DELAY || ticksToWait > loopIdleLimit)) ticksToWait = loopIdleLimit;
+  unsigned long started = micros();
+  std::unique_lock<std::mutex> guard(task->lock);
+  waitFor(task->wake, guard, ticksToWait, [task]() { return task->notifications > 0; });
+  uint32_t value = task->notifications;
+  if (value > 0) task->notifications = clearOnExit ? 0 : value - 1;
+  if (limited) loopIdleUs += micros() - started;
+  return value;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+  if (task != nullptr) xTaskNotifyGive(task);
+  if (higherPriorityTaskWoken != nullptr) *higherPriorityTaskWoken = pdFALSE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notifications++;
+  }
+  task->wake.notify_all();
+  return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new EmuSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticksToWait) {
+  if (ticksToWait == portMAX_DELAY) {
+    sem->mutex.lock();
+    return pdTRUE;
+  }
+  return sem->mutex.try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  sem->mutex.unlock();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+  delete sem;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  EmuQueue* queue = new EmuQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  if (!waitFor(queue->changed, guard, ticksToWait, [queue]() { return queue->items.size() < queue->length; })) {
+    return pdFALSE;
+  }
+  const uint8_t* bytes = (const uint8_t*)item;
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  if (!waitFor(queue->changed, guard, ticksToWait, [queue]() { return !queue->items.empty(); })) {
+    return pdFALSE;
+  }
+  memcpy(buffer, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->length - queue->items.size();
+}
@@ -0,0 +1,45 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <XPT2046_Touchscreen.h>
+#include <ESPmDNS.h>
+#include <Update.h>
+#include "emu.h"
+#include <mutex>
+
+// =========================================================================
+// EMULATOR: SPI bus, touch controller, mDNS, OTA
+// =========================================================================
+
+SPIClass SPI;
+MDNSResponder MDNS;
+UpdateClass Update;
+
+// Current press (script thread writes, the touch task reads)
+struct EmuPress {
+  int16_t fromX, fromY, toX, toY;
+  unsigned long start, moveMs, holdMs;
+  bool down;
+};
+static std::mutex pressLock;
+static EmuPress press = {};
+
+void emuPress(int16_t rawX, int16_t rawY, int16_t toRawX, int16_t toRawY, unsigned long moveMs, unsigned long holdMs) {
+  std::lock_guard<std::mutex> guard(pressLock);
+  press = {rawX, rawY, toRawX, toRawY, millis(), moveMs, holdMs, true};
+}
+
+TS_Point XPT2046_Touchscreen::getPoint() {
+  std::lock_guard<std::mutex> guard(pressLock);
+  unsigned long held = millis() - press.start;
+  if (!press.down || held >= press.holdMs) return TS_Point();
+  float t = press.moveMs > 0 ? std::min(1.0f, (float)held / press.moveMs) : 1.0f;
+  return TS_Point(press.fromX + (press.toX - press.fromX) * t, press.fromY + (press.toY - press.fromY) * t, 1000);
+}
+
+bool XPT2046_Touchscreen::tirqTouched() {
+  return touched();
+}
+
+bool XPT2046_Touchscreen::touched() {
+  return getPoint().z > 0;
+}
@@ -0,0 +1,134 @@
+#include <LittleFS.h>
+#include "emu.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <cerrno>
+
+// =========================================================================
+// EMULATOR: LittleFS on a host directory
+// =========================================================================
+
+fs::LittleFSFS LittleFS;
+
+static String fsRoot = "emu_fs";
+
+void emuSetFsRoot(const String& dir) {
+  fsRoot = dir;
+  while (fsRoot.endsWith("/") && fsRoot.length() > 1) fsRoot.remove(fsRoot.length() - 1);
+}
+
+namespace fs {
+
+File::File(FILE* f, const String& path) : file(f, fclose), _path(path) {}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+  return file ? fwrite(buf, 1, size, file.get()) : 0;
+}
+
+int File::available() {
+  if (!file) return 0;
+  long here = ftell(file.get());
+  return (int)(size() - here);
+}
+
+int File::read() {
+  return file ? fgetc(file.get()) : -1;
+}
+
+int File::peek() {
+  if (!file) return -1;
+  int c = fgetc(file.get());
+  if (c != EOF) ungetc(c, file.get());
+  return c;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+  return file ? fread(buf, 1, size, file.get()) : 0;
+}
+
+void File::flush() {
+  if (file) fflush(file.get());
+}
+
+bool File::seek(uint32_t pos) {
+  return file && fseek(file.get(), pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+  return file ? ftell(file.get()) : 0;
+}
+
+size_t File::size() const {
+  if (!file) return 0;
+  struct stat info;
+  fflush(file.get());
+  return fstat(fileno(file.get()), &info) == 0 ? info.st_size : 0;
+}
+
+const char* File::name() const {
+  int slash = _path.lastIndexOf('/');
+  return _path.c_str() + slash + 1;
+}
+
+String FS::hostPath(const char* path) {
+  return fsRoot + (path[0] == '/' ? "" : "/") + path;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+  String host = hostPath(path);
+  String hostMode = String(mode).indexOf('b') == -1 ? String(mode) + "b" : String(mode);
+  FILE* f = fopen(host.c_str(), hostMode.c_str());
+  return f ? File(f, path) : File();
+}
+
+bool FS::exists(const char* path) {
+  struct stat info;
+  return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+  return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+  return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+// Creates the directory on first mount, like formatOnFail on a blank chip
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+  if (::mkdir(fsRoot.c_str(), 0755) != 0 && errno != EEXIST) {
+    Serial.printf("[emu] Cannot create LittleFS directory %s\n", fsRoot.c_str());
+    return false;
+  }
+  Serial.printf("[emu] LittleFS is %s/\n", fsRoot.c_str());
+  return true;
+}
+
+bool LittleFSFS::format() {
+  DIR* dir = opendir(fsRoot.c_str());
+  if (dir == nullptr) return false;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') continue;
+    ::remove((fsRoot + "/" + entry->d_name).c_str());
+  }
+  closedir(dir);
+  return true;
+}
+
+size_t LittleFSFS::usedBytes() {
+  size_t used = 0;
+  DIR* dir = opendir(fsRoot.c_str());
+  if (dir == nullptr) return 0;
+  while (struct dirent* entry = readdir(dir)) {
+    struct stat info;
+    if (stat((fsRoot + "/" + entry->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) used += info.st_size;
+  }
+  closedir(dir);
+  return used;
+}
+
+} // namespace fs
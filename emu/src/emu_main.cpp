@@ -0,0 +1,234 @@
+#include <Arduino.h>
+#include "emu.h"
+#include "../../src/globals.h" // For tft, server
+#include "../../src/config.h"  // For TOUCH_* calibration
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+
+// =========================================================================
+// EMULATOR ENTRY POINT
+// Runs the firmware's setup() and loop() on the host. After every loop()
+// iteration that changed the panel it records the iteration's time and
+// pixel count, and optionally writes the panel to a PNG. A script can
+// press the touchscreen, call web endpoints and save screenshots at
+// given times (see README "Emulator").
+// =========================================================================
+
+void setup();
+void loop();
+
+struct ScriptEvent {
+  unsigned long at; // ms after setup() returned
+  String command;
+  std::vector<String> args;
+};
+
+struct FrameTiming {
+  unsigned long at;
+  unsigned long loopUs;
+  unsigned long pixels;
+};
+
+static void usage() {
+  printf("Usage: program [options]\n"
+         "  --run-ms N         Stop after N ms of loop() (default 20000)\n"
+         "  --frames DIR       Write every changed frame to DIR/frame_NNNNN.png\n"
+         "  --script FILE      Timed input, one \"<ms> <command> [args]\" per line:\n"
+         "                       touch X Y [HOLD_MS]  press at screen pixel X,Y (default 100 ms)\n"
+         "                       swipe X1 Y1 X2 Y2 [MS]  drag from X1,Y1 to X2,Y2 (default 150 ms)\n"
+         "                       get /path?query      call a web endpoint, print the response\n"
+         "                       png FILE             save the panel now\n"
+         "                       quit                 stop early\n"
+         "  --fs DIR           LittleFS directory (default emu_fs)\n"
+         "  --fixtures H:P     Fixture server for HTTPS fetches (default 127.0.0.1:8089; none = direct http)\n"
+         "  --http PORT        Also serve the web GUI on 127.0.0.1:PORT\n"
+         "  --timings FILE     Write per-frame timings as CSV\n");
+}
+
+// --- HELPER: Parse the script, sorted by time ---
+static bool loadScript(const char* path, std::vector<ScriptEvent>& events) {
+  std::ifstream in(path);
+  if (!in) return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream words(line);
+    ScriptEvent event;
+    std::string word;
+    if (!(words >> event.at >> word)) continue;
+    event.command = word.c_str();
+    while (words >> word) event.args.push_back(word.c_str());
+    events.push_back(event);
+  }
+  std::stable_sort(events.begin(), events.end(), [](const ScriptEvent& a, const ScriptEvent& b) { return a.at < b.at; });
+  return true;
+}
+
+// --- HELPER: Screen pixels to raw XPT2046 units (inverse of touch_input.cpp's map) ---
+static int16_t rawX(int x) { return TOUCH_X_MIN + (long)x * (TOUCH_X_MAX - TOUCH_X_MIN) / SCREEN_WIDTH; }
+static int16_t rawY(int y) { return TOUCH_Y_MIN + (long)y * (TOUCH_Y_MAX - TOUCH_Y_MIN) / SCREEN_HEIGHT; }
+
+// --- HELPER: Put a finger down (and let it go later); the controller raises TOUCH_IRQ ---
+static void pressAt(int x, int y, int toX, int toY, unsigned long moveMs, unsigned long holdMs) {
+  emuPress(rawX(x), rawY(y), rawX(toX), rawY(toY), moveMs, holdMs);
+  emuInterrupt(TOUCH_IRQ);
+}
+
+static void webGet(const String& url) {
+  String contentType;
+  std::string body;
+  std::vector<std::pair<String, String>> headers;
+  int code = server.emuRequest(HTTP_GET, url, contentType, body, &headers);
+  printf("[emu] GET %s -> %d %s, %zu bytes\n", url.c_str(), code, contentType.c_str(), body.size());
+  for (const auto& header : headers) printf("[emu]   %s: %s\n", header.first.c_str(), header.second.c_str());
+  bool text = contentType.startsWith("text/") || contentType.startsWith("application/json");
+  if (text && !contentType.startsWith("text/html")) printf("%s\n", body.c_str());
+}
+
+// Creates `path` and any missing parents, like mkdir -p
+static bool makeDirs(const String& path) {
+  for (int slash = path.indexOf('/', 1); ; slash = path.indexOf('/', slash + 1)) {
+    String dir = slash < 0 ? path : path.substring(0, slash);
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    if (slash < 0) break;
+  }
+  struct stat info;
+  if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) return true;
+  errno = ENOTDIR; // A file of that name is in the way
+  return false;
+}
+
+static unsigned long percentile(std::vector<unsigned long> values, int pct) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1, values.size() * pct / 100)];
+}
+
+int main(int argc, char** argv) {
+  unsigned long runMs = 20000;
+  String framesDir, scriptPath, timingsPath;
+
+  for (int i = 1; i < argc; i++) {
+    String arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--run-ms" && hasValue) runMs = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--frames" && hasValue) framesDir = argv[++i];
+    else if (arg == "--script" && hasValue) scriptPath = argv[++i];
+    else if (arg == "--fs" && hasValue) emuSetFsRoot(argv[++i]);
+    else if (arg == "--http" && hasValue) emuSetHttpPort(atoi(argv[++i]));
+    else if (arg == "--timings" && hasValue) timingsPath = argv[++i];
+    else if (arg == "--fixtures" && hasValue) {
+      String target = argv[++i];
+      int colon = target.lastIndexOf(':');
+      if (target == "none") emuSetFixtureServer("", 0);
+      else if (colon > 0) emuSetFixtureServer(target.substring(0, colon), target.substring(colon + 1).toInt());
+      else emuSetFixtureServer(target, 80);
+    } else {
+      usage();
+      return arg == "--help" ? 0 : 2;
+    }
+  }
+
+  if (framesDir.length() > 0 && !makeDirs(framesDir)) {
+    fprintf(stderr, "Cannot create frames directory %s: %s\n", framesDir.c_str(), strerror(errno));
+    return 2;
+  }
+
+  std::vector<ScriptEvent> events;
+  if (scriptPath.length() > 0 && !loadScript(scriptPath.c_str(), events)) {
+    fprintf(stderr, "Cannot read script %s\n", scriptPath.c_str());
+    return 2;
+  }
+  size_t nextEvent = 0;
+
+  std::vector<FrameTiming> frames;
+  uint32_t shownVersion = 0;
+  unsigned long shownPixels = 0;
+  auto recordFrame = [&](unsigned long at, unsigned long loopUs) {
+    FrameTiming frame = {at, loopUs, tft.emuPixelsWritten() - shownPixels};
+    frames.push_back(frame);
+    shownVersion = tft.emuVersion();
+    shownPixels = tft.emuPixelsWritten();
+    printf("[emu] frame %zu at %lu ms: %lu.%03lu ms, %lu px\n", frames.size(), at, loopUs / 1000, loopUs % 1000, frame.pixels);
+    if (framesDir.length() > 0) {
+      char path[512];
+      snprintf(path, sizeof(path), "%s/frame_%05zu.png", framesDir.c_str(), frames.size());
+      if (!emuWritePng(path, tft.emuPixels(), tft.width(), tft.height())) fprintf(stderr, "Cannot write %s\n", path);
+    }
+  };
+
+  // --- 1. Boot ---
+  unsigned long started = micros();
+  setup();
+  recordFrame(0, micros() - started);
+  unsigned long bootMs = millis();
+  printf("[emu] setup() done in %lu ms\n", (micros() - started) / 1000);
+
+  // --- 2. Run ---
+  bool quit = false;
+  while (!quit && millis() - bootMs < runMs) {
+    unsigned long now = millis() - bootMs;
+
+    // a. Script events that are due
+    while (nextEvent < events.size() && events[nextEvent].at <= now) {
+      const ScriptEvent& event = events[nextEvent++];
+      if (event.command == "touch" && event.args.size() >= 2) {
+        int x = event.args[0].toInt(), y = event.args[1].toInt();
+        pressAt(x, y, x, y, 0, event.args.size() >= 3 ? event.args[2].toInt() : 100);
+      } else if (event.command == "swipe" && event.args.size() >= 4) {
+        unsigned long ms = event.args.size() >= 5 ? event.args[4].toInt() : 150;
+        pressAt(event.args[0].toInt(), event.args[1].toInt(), event.args[2].toInt(), event.args[3].toInt(), ms, ms + 20);
+      } else if (event.command == "get" && event.args.size() >= 1) {
+        webGet(event.args[0]);
+      } else if (event.command == "png" && event.args.size() >= 1) {
+        if (!emuWritePng(event.args[0].c_str(), tft.emuPixels(), tft.width(), tft.height())) {
+          fprintf(stderr, "Cannot write %s\n", event.args[0].c_str());
+        }
+      } else if (event.command == "quit") {
+        quit = true;
+      } else {
+        fprintf(stderr, "Unknown script command at %lu ms: %s\n", event.at, event.command.c_str());
+      }
+    }
+
+    // b. One loop() pass; a pass that changed the panel is a frame. It may
+    // sleep in powerIdle() until the next script event, which is not timed
+    unsigned long untilMs = nextEvent < events.size() ? events[nextEvent].at - now : runMs - now;
+    emuLimitLoopIdle(untilMs);
+    unsigned long idleBefore = emuLoopIdleUs();
+    started = micros();
+    loop();
+    unsigned long loopUs = micros() - started - (emuLoopIdleUs() - idleBefore);
+    if (tft.emuVersion() != shownVersion) recordFrame(now, loopUs);
+    else if (emuLoopIdleUs() == idleBefore) delay(1); // Passes that did not sleep would otherwise spin a host core
+  }
+
+  // --- 3. Report ---
+  std::vector<unsigned long> loopUs;
+  for (const FrameTiming& frame : frames) loopUs.push_back(frame.loopUs);
+  unsigned long total = 0;
+  for (unsigned long us : loopUs) total += us;
+  printf("[emu] %zu frames: mean %.3f ms, p50 %.3f ms, p95 %.3f ms, max %.3f ms\n", frames.size(),
+         frames.empty() ? 0.0 : total / 1000.0 / frames.size(), percentile(loopUs, 50) / 1000.0,
+         percentile(loopUs, 95) / 1000.0, percentile(loopUs, 100) / 1000.0);
+
+  if (timingsPath.length() > 0) {
+    FILE* csv = fopen(timingsPath.c_str(), "w");
+    if (csv != nullptr) {
+      fprintf(csv, "frame,at_ms,loop_us,pixels\n");
+      for (size_t i = 0; i < frames.size(); i++) {
+        fprintf(csv, "%zu,%lu,%lu,%lu\n", i + 1, frames[i].at, frames[i].loopUs, frames[i].pixels);
+      }
+      fclose(csv);
+    }
+  }
+  fflush(stdout);
+  _exit(0); // Firmware tasks never return; don't wait for them
+}
@@ -0,0 +1,499 @@
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <WebSocketsClient.h>
+#include "emu.h"
+#include <netdb.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// =========================================================================
+// EMULATOR: WiFi, TCP, HTTP and WebSocket clients on host sockets
+// =========================================================================
+
+WiFiClass WiFi;
+
+static String fixtureHost = "127.0.0.1";
+static uint16_t fixturePort = 8089;
+
+void emuSetFixtureServer(const String& host, uint16_t port) {
+  fixtureHost = host;
+  fixturePort = port;
+}
+
+// =====================================================
+// --- WIFI ---
+// =====================================================
+
+static std::vector<std::pair<WiFiEventFuncCb, arduino_event_id_t>> eventHandlers; // Registered in setup()
+static std::atomic<unsigned> attempt(0); // Each begin() / disconnect() ends the events of the one before
+
+// --- HELPER: Deliver an event on its own thread after `delayMs` ---
+static void raiseEvent(arduino_event_id_t event, uint8_t reason, unsigned long delayMs) {
+  unsigned current = attempt;
+  std::thread([event, reason, delayMs, current]() {
+    delay(delayMs);
+    if (attempt != current && reason != WIFI_REASON_ASSOC_LEAVE) return; // Leaving is reported whatever comes next
+    arduino_event_info_t info = {};
+    info.wifi_sta_disconnected.reason = reason;
+    for (const auto& handler : eventHandlers) {
+      if (handler.second == ARDUINO_EVENT_MAX || handler.second == event) handler.first(event, info);
+    }
+  }).detach();
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback, arduino_event_id_t event) {
+  eventHandlers.push_back({callback, event});
+  return eventHandlers.size();
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase) {
+  ssid_ = ssid;
+  attempt++;
+  if (ssid_.startsWith("unreachable")) {
+    status_ = WL_NO_SSID_AVAIL;
+    Serial.printf("[emu] WiFi \"%s\" not found\n", ssid);
+    for (int scan = 1; scan <= 3; scan++) raiseEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_NO_AP_FOUND, scan * 1000);
+    return status_;
+  }
+  status_ = WL_CONNECTED;
+  Serial.printf("[emu] WiFi \"%s\" connected (host network)\n", ssid);
+  raiseEvent(ARDUINO_EVENT_WIFI_STA_CONNECTED, 0, 100);
+  raiseEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP, 0, 300);
+  return status_;
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+  bool wasConnected = status_ == WL_CONNECTED;
+  status_ = WL_DISCONNECTED;
+  attempt++;
+  if (wasConnected) raiseEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE, 10);
+  return true;
+}
+
+// =====================================================
+// --- TCP CLIENT ---
+// =====================================================
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+  struct addrinfo hints = {}, *result = nullptr;
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  char service[8];
+  snprintf(service, sizeof(service), "%u", port);
+  if (getaddrinfo(host, service, &hints, &result) != 0) return 0;
+
+  for (struct addrinfo* ai = result; ai != nullptr; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) continue;
+    if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+    ::close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+  if (fd < 0) return 0;
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return 1;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+  if (fd < 0) return 0;
+  size_t sent = 0;
+  while (sent < size) {
+    ssize_t n = send(fd, buf + sent, size - sent, MSG_NOSIGNAL);
+    if (n <= 0) {
+      stop();
+      break;
+    }
+    sent += n;
+  }
+  return sent;
+}
+
+int WiFiClient::available() {
+  if (fd < 0) return peeked >= 0 ? 1 : 0;
+  int pending = 0;
+  if (ioctl(fd, FIONREAD, &pending) < 0) pending = 0;
+  return pending + (peeked >= 0 ? 1 : 0);
+}
+
+// Never blocks: -1 when nothing has arrived yet
+int WiFiClient::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+  if (size == 0) return 0;
+  size_t got = 0;
+  if (peeked >= 0) {
+    buf[got++] = (uint8_t)peeked;
+    peeked = -1;
+  }
+  if (fd >= 0 && got < size) {
+    ssize_t n = recv(fd, buf + got, size - got, MSG_DONTWAIT);
+    if (n > 0) got += n;
+  }
+  return got > 0 ? (int)got : -1;
+}
+
+int WiFiClient::peek() {
+  if (peeked < 0) peeked = read();
+  return peeked;
+}
+
+void WiFiClient::stop() {
+  if (fd >= 0) ::close(fd);
+  fd = -1;
+  peeked = -1;
+}
+
+// True while the socket is open or unread data remains
+uint8_t WiFiClient::connected() {
+  if (peeked >= 0) return 1;
+  if (fd < 0) return 0;
+  uint8_t probe;
+  ssize_t n = recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (n == 0) {
+    stop(); // Orderly close with nothing left to read
+    return 0;
+  }
+  if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    stop();
+    return 0;
+  }
+  return 1;
+}
+
+// =====================================================
+// --- HTTP CLIENT ---
+// =====================================================
+
+bool HTTPClient::begin(WiFiClient& client, const String& url) {
+  _client = &client;
+  _size = -1;
+  _chunked = false;
+
+  int schemeEnd = url.indexOf("://");
+  if (schemeEnd == -1) return false;
+  String scheme = url.substring(0, schemeEnd);
+  int pathStart = url.indexOf('/', schemeEnd + 3);
+  String hostPort = (pathStart == -1) ? url.substring(schemeEnd + 3) : url.substring(schemeEnd + 3, pathStart);
+  String path = (pathStart == -1) ? String("/") : url.substring(pathStart);
+
+  if (fixtureHost.length() > 0) {
+    // Every upstream shares the fixture server, one directory per host
+    int colon = hostPort.indexOf(':');
+    String upstream = (colon == -1) ? hostPort : hostPort.substring(0, colon);
+    _host = fixtureHost;
+    _port = fixturePort;
+    _path = "/" + upstream + path;
+  } else {
+    if (!scheme.equalsIgnoreCase("http")) {
+      Serial.printf("[emu] %s:// needs the fixture server\n", scheme.c_str());
+      return false;
+    }
+    int colon = hostPort.indexOf(':');
+    _host = (colon == -1) ? hostPort : hostPort.substring(0, colon);
+    _port = (colon == -1) ? 80 : hostPort.substring(colon + 1).toInt();
+    _path = path;
+  }
+  _hostHeader = hostPort;
+  return true;
+}
+
+void HTTPClient::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+  _headerKeys.assign(headerKeys, headerKeys + headerKeysCount);
+  _headerValues.assign(headerKeysCount, String());
+}
+
+String HTTPClient::header(const char* name) {
+  for (size_t i = 0; i < _headerKeys.size(); i++) {
+    if (_headerKeys[i].equalsIgnoreCase(name)) return _headerValues[i];
+  }
+  return String();
+}
+
+// --- HELPER: One CRLF line, false on timeout or close ---
+bool HTTPClient::readLine(String& line) {
+  line = "";
+  unsigned long start = millis();
+  while (millis() - start < _timeout) {
+    int c = _client->read();
+    if (c < 0) {
+      if (!_client->connected()) return false;
+      delay(1);
+      continue;
+    }
+    if (c == '\n') return true;
+    if (c != '\r') line += (char)c;
+  }
+  return false;
+}
+
+int HTTPClient::GET() {
+  if (_client == nullptr) return HTTPC_ERROR_NOT_CONNECTED;
+  if (!_client->connected() && !_client->connect(_host.c_str(), _port)) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+  String request = "GET " + _path + " HTTP/1.1\r\n";
+  request += "Host: " + _hostHeader + "\r\n";
+  request += "User-Agent: ESP32HTTPClient\r\n";
+  request += String("Connection: ") + (_reuse ? "keep-alive" : "close") + "\r\n";
+  request += "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n\r\n";
+  if (_client->write((const uint8_t*)request.c_str(), request.length()) != request.length()) {
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+  }
+
+  // Status line, then headers up to the blank line
+  String line;
+  if (!readLine(line)) return _client->connected() ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+  int space = line.indexOf(' ');
+  int code = (space == -1) ? 0 : line.substring(space + 1).toInt();
+  if (code <= 0) return HTTPC_ERROR_NO_HTTP_SERVER;
+
+  _size = -1;
+  _chunked = false;
+  _canReuse = _reuse;
+  for (String& value : _headerValues) value = "";
+  while (readLine(line) && line.length() > 0) {
+    int colon = line.indexOf(':');
+    if (colon == -1) continue;
+    String name = line.substring(0, colon);
+    String value = line.substring(colon + 1);
+    value.trim();
+    if (name.equalsIgnoreCase("Content-Length")) _size = value.toInt();
+    if (name.equalsIgnoreCase("Transfer-Encoding") && value.equalsIgnoreCase("chunked")) _chunked = true;
+    if (name.equalsIgnoreCase("Connection") && value.equalsIgnoreCase("close")) _canReuse = false;
+    for (size_t i = 0; i < _headerKeys.size(); i++) {
+      if (_headerKeys[i].equalsIgnoreCase(name)) _headerValues[i] = value;
+    }
+  }
+  return code;
+}
+
+String HTTPClient::getString() {
+  String body;
+  uint8_t buf[512];
+  if (_chunked) {
+    String line;
+    while (readLine(line)) {
+      long chunk = strtol(line.c_str(), nullptr, 16);
+      if (chunk <= 0) {
+        while (readLine(line) && line.length() > 0) {} // Trailers
+        break;
+      }
+      while (chunk > 0) {
+        int n = _client->read(buf, min((long)sizeof(buf), chunk));
+        if (n < 0) {
+          if (!_client->connected()) return body;
+          delay(1);
+          continue;
+        }
+        body.concat((const char*)buf, n);
+        chunk -= n;
+      }
+      readLine(line); // CRLF after the chunk
+    }
+    return body;
+  }
+
+  long remaining = _size;
+  unsigned long lastByte = millis();
+  while (remaining != 0 && millis() - lastByte < _timeout) {
+    int n = _client->read(buf, remaining > 0 ? min((long)sizeof(buf), remaining) : sizeof(buf));
+    if (n < 0) {
+      if (!_client->connected()) break; // Read-until-close body
+      delay(1);
+      continue;
+    }
+    body.concat((const char*)buf, n);
+    if (remaining > 0) remaining -= n;
+    lastByte = millis();
+  }
+  return body;
+}
+
+// Keeps the socket for the next request when both sides agreed to
+void HTTPClient::end() {
+  if (_client != nullptr && !_canReuse) _client->stop();
+}
+
+String HTTPClient::errorToString(int error) {
+  switch (error) {
+    case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+    case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+    case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+    case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+    case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+    case HTTPC_ERROR_NO_STREAM: return "no stream";
+    case HTTPC_ERROR_NO_HTTP_SERVER: return "no HTTP server";
+    case HTTPC_ERROR_TOO_LESS_RAM: return "too less ram";
+    case HTTPC_ERROR_ENCODING: return "Transfer-Encoding not supported";
+    case HTTPC_ERROR_STREAM_WRITE: return "Stream write error";
+    case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+    default: return String();
+  }
+}
+
+// =====================================================
+// --- WEBSOCKET CLIENT ---
+// =====================================================
+
+void WebSocketsClient::begin(const char* host, uint16_t port, const char* url, const char* protocol) {
+  _host = host;
+  _port = port;
+  _url = url;
+  _active = true;
+  _attempted = false;
+}
+
+void WebSocketsClient::beginSSL(const char* host, uint16_t port, const char* url, const char* fingerprint,
+                                const char* protocol) {
+  Serial.printf("[emu] wss://%s is not supported in the emulator; point the stream at a ws:// URL\n", host);
+  _active = false;
+}
+
+void WebSocketsClient::beginSslWithCA(const char* host, uint16_t port, const char* url, const char* CA_cert,
+                                      const char* protocol) {
+  beginSSL(host, port, url);
+}
+
+void WebSocketsClient::disconnect() {
+  if (_connected) sendFrame(0x8, nullptr, 0);
+  dropConnection();
+  _active = false;
+}
+
+void WebSocketsClient::dropConnection() {
+  bool was = _connected;
+  _client.stop();
+  _connected = false;
+  if (was && _event) _event(WStype_DISCONNECTED, nullptr, 0);
+}
+
+// --- HELPER: HTTP upgrade; the accept key is not checked ---
+bool WebSocketsClient::handshake() {
+  if (!_client.connect(_host.c_str(), _port)) return false;
+  String request = "GET " + _url + " HTTP/1.1\r\n";
+  request += "Host: " + _host + ":" + String(_port) + "\r\n";
+  request += "Upgrade: websocket\r\nConnection: Upgrade\r\n";
+  request += "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+  _client.write((const uint8_t*)request.c_str(), request.length());
+
+  _client.setTimeout(3000);
+  String status = _client.readStringUntil('\n');
+  if (status.indexOf(" 101") == -1) {
+    _client.stop();
+    return false;
+  }
+  String line;
+  do {
+    line = _client.readStringUntil('\n');
+    line.trim();
+  } while (line.length() > 0 && _client.connected());
+  return _client.connected();
+}
+
+// Client frames are always masked
+bool WebSocketsClient::sendFrame(uint8_t opcode, const uint8_t* payload, size_t length) {
+  uint8_t header[14];
+  size_t n = 0;
+  header[n++] = 0x80 | opcode;
+  if (length < 126) {
+    header[n++] = 0x80 | length;
+  } else if (length < 65536) {
+    header[n++] = 0x80 | 126;
+    header[n++] = length >> 8;
+    header[n++] = length & 0xFF;
+  } else {
+    header[n++] = 0x80 | 127;
+    for (int shift = 56; shift >= 0; shift -= 8) header[n++] = (uint64_t)length >> shift;
+  }
+  uint8_t mask[4];
+  for (uint8_t& m : mask) m = random(256);
+  memcpy(header + n, mask, 4);
+  n += 4;
+
+  std::string frame((const char*)header, n);
+  for (size_t i = 0; i < length; i++) frame += (char)(payload[i] ^ mask[i & 3]);
+  return _client.write((const uint8_t*)frame.data(), frame.size()) == frame.size();
+}
+
+bool WebSocketsClient::sendTXT(const char* payload, size_t length) {
+  if (!_connected) return false;
+  if (length == 0) length = strlen(payload);
+  return sendFrame(0x1, (const uint8_t*)payload, length);
+}
+
+// --- HELPER: Read one whole frame once its first byte is waiting ---
+bool WebSocketsClient::readFrame() {
+  uint8_t head[2];
+  if (_client.readBytes(head, 2) != 2) return false;
+  uint8_t opcode = head[0] & 0x0F;
+  bool masked = head[1] & 0x80;
+  uint64_t length = head[1] & 0x7F;
+  if (length >= 126) {
+    uint8_t ext[8];
+    int bytes = (length == 126) ? 2 : 8;
+    if (_client.readBytes(ext, bytes) != (size_t)bytes) return false;
+    length = 0;
+    for (int i = 0; i < bytes; i++) length = (length << 8) | ext[i];
+  }
+  uint8_t mask[4] = {0};
+  if (masked && _client.readBytes(mask, 4) != 4) return false;
+
+  std::string payload(length, '\0');
+  if (length > 0 && _client.readBytes((uint8_t*)&payload[0], length) != length) return false;
+  if (masked) {
+    for (size_t i = 0; i < length; i++) payload[i] ^= mask[i & 3];
+  }
+
+  switch (opcode) {
+    case 0x1:
+    case 0x2:
+      if (_event) _event(opcode == 0x1 ? WStype_TEXT : WStype_BIN, (uint8_t*)&payload[0], length);
+      break;
+    case 0x8:
+      return false; // Close
+    case 0x9:
+      sendFrame(0xA, (const uint8_t*)payload.data(), length);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+void WebSocketsClient::loop() {
+  if (!_active) return;
+
+  if (!_connected) {
+    if (_attempted && millis() - _lastAttempt < _reconnectInterval) return;
+    _attempted = true;
+    _lastAttempt = millis();
+    if (!handshake()) return;
+    _connected = true;
+    if (_event) _event(WStype_CONNECTED, (uint8_t*)_url.c_str(), _url.length());
+    return;
+  }
+
+  if (!_client.connected()) {
+    dropConnection();
+    return;
+  }
+  while (_client.available() > 0) {
+    if (!readFrame()) {
+      dropConnection();
+      return;
+    }
+  }
+}
@@ -0,0 +1,90 @@
+#include "emu.h"
+#include <vector>
+
+// =========================================================================
+// EMULATOR: PNG frame dumps
+// Uncompressed (stored) deflate, so no zlib: a 320x240 frame is ~230 KB.
+// =========================================================================
+
+static uint32_t crcTable[256];
+
+static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+  if (crcTable[1] == 0) {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      crcTable[n] = c;
+    }
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+// --- HELPER: Length, type, data, CRC over type + data ---
+static void putChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+  putU32(out, data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  putU32(out, crc32(out.data() + start, out.size() - start));
+}
+
+bool emuWritePng(const char* path, const uint16_t* pixels, int width, int height) {
+  // 1. Filter-type-0 scanlines of 8-bit RGB, low bits filled by replication
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)height * (width * 3 + 1));
+  for (int y = 0; y < height; y++) {
+    raw.push_back(0);
+    for (int x = 0; x < width; x++) {
+      uint16_t c = pixels[y * width + x];
+      uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+      raw.push_back((r << 3) | (r >> 2));
+      raw.push_back((g << 2) | (g >> 4));
+      raw.push_back((b << 3) | (b >> 2));
+    }
+  }
+
+  // 2. zlib stream of stored blocks
+  std::vector<uint8_t> z = {0x78, 0x01};
+  for (size_t pos = 0; pos < raw.size() || pos == 0; ) {
+    size_t len = std::min<size_t>(65535, raw.size() - pos);
+    bool last = pos + len == raw.size();
+    z.push_back(last ? 1 : 0);
+    z.push_back(len & 0xFF);
+    z.push_back(len >> 8);
+    z.push_back(~len & 0xFF);
+    z.push_back((~len >> 8) & 0xFF);
+    z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+    pos += len;
+    if (last) break;
+  }
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : raw) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  putU32(z, (b << 16) | a);
+
+  // 3. Signature, IHDR, IDAT, IEND
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> ihdr;
+  putU32(ihdr, width);
+  putU32(ihdr, height);
+  ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0}); // 8-bit RGB, deflate, no interlace
+  putChunk(png, "IHDR", ihdr);
+  putChunk(png, "IDAT", z);
+  putChunk(png, "IEND", {});
+
+  FILE* f = fopen(path, "wb");
+  if (f == nullptr) return false;
+  bool ok = fwrite(png.data(), 1, png.size(), f) == png.size();
+  return fclose(f) == 0 && ok;
+}
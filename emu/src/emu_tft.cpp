@@ -0,0 +1,546 @@
+#include <TFT_eSPI.h>
+#include <vector>
+
+// =========================================================================
+// EMULATOR: TFT_eSPI software framebuffer
+// =========================================================================
+
+// Classic 5x7 glyphs for ' '..'~', one byte per column, LSB at the top
+static const uint8_t font5x7[95][5] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, // ' ' ! "
+  {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, // # $ %
+  {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00}, // & ' (
+  {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08}, // ) * +
+  {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, // , - .
+  {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, // / 0 1
+  {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10}, // 2 3 4
+  {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03}, // 5 6 7
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00}, // 8 9 :
+  {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, // ; < =
+  {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E}, // > ? @
+  {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22}, // A B C
+  {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01}, // D E F
+  {0x3E, 0x41, 0x49, 0x49, 0x7A}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, // G H I
+  {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40}, // J K L
+  {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E}, // M N O
+  {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, // P Q R
+  {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, // S T U
+  {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63}, // V W X
+  {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00}, // Y Z [
+  {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, // \ ] ^
+  {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, // _ ` a
+  {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F}, // b c d
+  {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E}, // e f g
+  {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00}, // h i j
+  {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, // k l m
+  {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08}, // n o p
+  {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20}, // q r s
+  {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, // t u v
+  {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, // w x y
+  {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00}, // z { |
+  {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},                                   // } ~
+};
+
+// Glyph scales that give each font about its real cap height
+const GFXfont FreeSans9pt7b = {"FreeSans9pt7b", 1.8f, false};
+const GFXfont FreeSans12pt7b = {"FreeSans12pt7b", 2.4f, false};
+const GFXfont FreeSans18pt7b = {"FreeSans18pt7b", 3.6f, false};
+const GFXfont FreeSans24pt7b = {"FreeSans24pt7b", 4.8f, false};
+const GFXfont FreeSansBold9pt7b = {"FreeSansBold9pt7b", 1.8f, true};
+const GFXfont FreeSansBold12pt7b = {"FreeSansBold12pt7b", 2.4f, true};
+const GFXfont FreeSansBold18pt7b = {"FreeSansBold18pt7b", 3.6f, true};
+const GFXfont FreeSansBold24pt7b = {"FreeSansBold24pt7b", 4.8f, true};
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h) : _width(w), _height(h) {}
+
+TFT_eSPI::~TFT_eSPI() {
+  delete[] buffer;
+}
+
+void TFT_eSPI::allocate(int32_t w, int32_t h) {
+  delete[] buffer;
+  _width = w;
+  _height = h;
+  buffer = new uint16_t[w * h]();
+  resetViewport();
+}
+
+void TFT_eSPI::init(uint8_t tc) {
+  allocate(_width, _height);
+  version++;
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+  rotation = r & 3;
+  int32_t shortSide = min(_width, _height), longSide = max(_width, _height);
+  allocate((rotation & 1) ? longSide : shortSide, (rotation & 1) ? shortSide : longSide); // The panel is blank again
+  version++;
+}
+
+// =====================================================
+// --- CLIPPING & STORAGE ---
+// =====================================================
+
+void TFT_eSPI::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum) {
+  _xDatum = x;
+  _yDatum = y;
+  _xWidth = w;
+  _yHeight = h;
+  _vpX = max(x, (int32_t)0);
+  _vpY = max(y, (int32_t)0);
+  _vpW = min(x + w, _width);
+  _vpH = min(y + h, _height);
+  _vpDatum = vpDatum;
+  if (!vpDatum) {
+    _xDatum = 0;
+    _yDatum = 0;
+    _xWidth = _width;
+    _yHeight = _height;
+  }
+}
+
+void TFT_eSPI::resetViewport() {
+  _vpX = _vpY = 0;
+  _vpW = _width;
+  _vpH = _height;
+  _xDatum = _yDatum = 0;
+  _xWidth = _width;
+  _yHeight = _height;
+  _vpDatum = false;
+}
+
+void TFT_eSPI::fillClipped(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color) {
+  if (buffer == nullptr && nibbles == nullptr) return;
+  int32_t x0 = max(x, _vpX), y0 = max(y, _vpY);
+  int32_t x1 = min(x + w, _vpW), y1 = min(y + h, _vpH);
+  if (x1 <= x0 || y1 <= y0) return;
+
+  if (nibbles != nullptr) {
+    uint8_t index = color & 0x0F;
+    for (int32_t row = y0; row < y1; row++) {
+      for (int32_t col = x0; col < x1; col++) {
+        uint8_t& pair = nibbles[(row * _width + col) >> 1];
+        pair = (col & 1) ? (uint8_t)((pair & 0xF0) | index) : (uint8_t)((pair & 0x0F) | (index << 4));
+      }
+    }
+    return;
+  }
+
+  uint16_t stored = panelOrder ? swap16(color) : color;
+  for (int32_t row = y0; row < y1; row++) {
+    std::fill(buffer + row * _width + x0, buffer + row * _width + x1, stored);
+  }
+  if (!panelOrder) {
+    version++;
+    pixelsWritten += (x1 - x0) * (y1 - y0);
+  }
+}
+
+void TFT_eSPI::blit(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data, int32_t stride, bool dataPanelOrder) {
+  if (buffer == nullptr) return;
+  x += _xDatum;
+  y += _yDatum;
+  int32_t x0 = max(x, _vpX), y0 = max(y, _vpY);
+  int32_t x1 = min(x + w, _vpW), y1 = min(y + h, _vpH);
+  if (x1 <= x0 || y1 <= y0) return;
+
+  bool swap = dataPanelOrder != panelOrder;
+  for (int32_t row = y0; row < y1; row++) {
+    const uint16_t* src = data + (row - y) * stride + (x0 - x);
+    uint16_t* dst = buffer + row * _width + x0;
+    for (int32_t col = x0; col < x1; col++) *dst++ = swap ? swap16(*src++) : *src++;
+  }
+  if (!panelOrder) {
+    version++;
+    pixelsWritten += (x1 - x0) * (y1 - y0);
+  }
+}
+
+// =====================================================
+// --- PRIMITIVES ---
+// =====================================================
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) {
+  fillClipped(x + _xDatum, y + _yDatum, 1, 1, color);
+}
+
+uint16_t TFT_eSPI::readPixel(int32_t x, int32_t y) {
+  x += _xDatum;
+  y += _yDatum;
+  if (buffer == nullptr || x < _vpX || y < _vpY || x >= _vpW || y >= _vpH) return 0;
+  uint16_t stored = buffer[y * _width + x];
+  return panelOrder ? swap16(stored) : stored;
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+  fillClipped(x + _xDatum, y + _yDatum, w, 1, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+  fillClipped(x + _xDatum, y + _yDatum, 1, h, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  fillClipped(x + _xDatum, y + _yDatum, w, h, color);
+}
+
+void TFT_eSPI::fillScreen(uint32_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y + 1, h - 2, color);
+  drawFastVLine(x + w - 1, y + 1, h - 2, color);
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  int32_t dx = x1 - x0, dy = abs(y1 - y0);
+  int32_t err = dx >> 1, ystep = (y0 < y1) ? 1 : -1;
+  for (; x0 <= x1; x0++) {
+    if (steep) drawPixel(y0, x0, color);
+    else drawPixel(x0, y0, color);
+    err -= dy;
+    if (err < 0) {
+      err += dx;
+      y0 += ystep;
+    }
+  }
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+  drawPixel(x0, y0 + r, color);
+  drawPixel(x0, y0 - r, color);
+  drawPixel(x0 + r, y0, color);
+  drawPixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    drawPixel(x0 + x, y0 + y, color);
+    drawPixel(x0 - x, y0 + y, color);
+    drawPixel(x0 + x, y0 - y, color);
+    drawPixel(x0 - x, y0 - y, color);
+    drawPixel(x0 + y, y0 + x, color);
+    drawPixel(x0 - y, y0 + x, color);
+    drawPixel(x0 + y, y0 - x, color);
+    drawPixel(x0 - y, y0 - x, color);
+  }
+}
+
+// Same span pattern as TFT_eSPI::fillCircle
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+  int32_t x = 0, dx = 1, dy = r + r, p = -(r >> 1);
+  drawFastHLine(x0 - r, y0, dy + 1, color);
+  while (x < r) {
+    if (p >= 0) {
+      drawFastHLine(x0 - x, y0 + r, dx, color);
+      drawFastHLine(x0 - x, y0 - r, dx, color);
+      dy -= 2;
+      p -= dy;
+      r--;
+    }
+    dx += 2;
+    p += dx;
+    x++;
+    drawFastHLine(x0 - r, y0 + x, dy + 1, color);
+    drawFastHLine(x0 - r, y0 - x, dy + 1, color);
+  }
+}
+
+void TFT_eSPI::fillCircleHelper(int32_t x0, int32_t y0, int32_t r, uint8_t corners, int32_t delta, uint32_t color) {
+  int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+  delta++;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < y + 1) {
+      if (corners & 1) drawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2) drawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py) {
+      if (corners & 1) drawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2) drawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void TFT_eSPI::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+  r = min(r, min(w, h) / 2);
+  fillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+void TFT_eSPI::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+  // Sort by y, then fill one span per row between the long edge and the short ones
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+  if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+  for (int32_t y = y0; y <= y2; y++) {
+    int32_t a = (y2 == y0) ? x0 : x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+    int32_t b;
+    if (y < y1) b = (y1 == y0) ? x0 : x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+    else b = (y2 == y1) ? x1 : x1 + (x2 - x1) * (y - y1) / (y2 - y1);
+    if (a > b) std::swap(a, b);
+    drawFastHLine(a, y, b - a + 1, color);
+  }
+}
+
+uint16_t TFT_eSPI::alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc) {
+  // Same rounding as TFT_eSPI (6-bit channels plus one)
+  uint16_t fgR = ((fgc >> 10) & 0x3E) + 1, fgG = ((fgc >> 4) & 0x7E) + 1, fgB = ((fgc << 1) & 0x3E) + 1;
+  uint16_t bgR = ((bgc >> 10) & 0x3E) + 1, bgG = ((bgc >> 4) & 0x7E) + 1, bgB = ((bgc << 1) & 0x3E) + 1;
+  uint16_t r = ((fgR * alpha) + (bgR * (255 - alpha))) >> 9;
+  uint16_t g = ((fgG * alpha) + (bgG * (255 - alpha))) >> 9;
+  uint16_t b = ((fgB * alpha) + (bgB * (255 - alpha))) >> 9;
+  return (r << 11) | (g << 5) | b;
+}
+
+// =====================================================
+// --- PIXEL PUSHING ---
+// =====================================================
+
+// swapBytes off means the data already holds panel byte order
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+  blit(x, y, w, h, data, w, !swapBytes);
+}
+
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* data, uint16_t* buffer) {
+  blit(x, y, w, h, data, w, !swapBytes);
+}
+
+// =====================================================
+// --- TEXT ---
+// =====================================================
+
+void TFT_eSPI::setFreeFont(const GFXfont* f) {
+  freeFont = f;
+  textfont = 1;
+}
+
+void TFT_eSPI::setTextFont(uint8_t font) {
+  freeFont = nullptr;
+  textfont = font;
+}
+
+float TFT_eSPI::glyphScale() const {
+  float scale = 1.0f;
+  if (freeFont != nullptr) {
+    scale = freeFont->scale;
+  } else {
+    switch (textfont) {
+      case 2: scale = 2.0f; break;   // 16 px
+      case 4: scale = 3.25f; break;  // 26 px
+      case 6: scale = 6.0f; break;   // 48 px
+      case 7: scale = 6.0f; break;   // 48 px
+      case 8: scale = 9.375f; break; // 75 px
+      default: scale = 1.0f; break;  // 8 px GLCD
+    }
+  }
+  return scale * textsize;
+}
+
+// Real glyphs are narrower than a scaled 5x7 cell; GLCD is the 5x7 font
+float TFT_eSPI::glyphXScale() const {
+  bool glcd = freeFont == nullptr && textfont != 2 && textfont != 4 && textfont < 6;
+  return glyphScale() * (glcd ? 1.0f : 0.8f);
+}
+
+bool TFT_eSPI::glyphBold() const {
+  return freeFont != nullptr && freeFont->bold;
+}
+
+// --- HELPER: Draw one glyph cell with its top-left at (x, y); returns the advance ---
+int16_t TFT_eSPI::drawGlyph(char c, int32_t x, int32_t y, float xScale, float scale, bool bold) {
+  if (c < ' ' || c > '~') c = '?';
+  const uint8_t* columns = font5x7[c - ' '];
+  for (int col = 0; col < 5; col++) {
+    int32_t x0 = x + (int32_t)(col * xScale), x1 = x + (int32_t)((col + 1) * xScale);
+    if (bold) x1++;
+    for (int row = 0; row < 7; row++) {
+      if (!(columns[col] & (1 << row))) continue;
+      int32_t y0 = y + (int32_t)(row * scale), y1 = y + (int32_t)((row + 1) * scale);
+      fillRect(x0, y0, x1 - x0, y1 - y0, textcolor);
+    }
+  }
+  return (int16_t)(6 * xScale) + (bold ? 1 : 0);
+}
+
+int16_t TFT_eSPI::textWidth(const char* string) {
+  int16_t advance = (int16_t)(6 * glyphXScale()) + (glyphBold() ? 1 : 0);
+  return strlen(string) * advance;
+}
+
+int16_t TFT_eSPI::fontHeight() {
+  return (int16_t)(8 * glyphScale());
+}
+
+int16_t TFT_eSPI::drawString(const char* string, int32_t x, int32_t y, uint8_t font) {
+  setTextFont(font);
+  return drawString(string, x, y);
+}
+
+int16_t TFT_eSPI::drawString(const char* string, int32_t x, int32_t y) {
+  float scale = glyphScale();
+  float xScale = glyphXScale();
+  bool bold = glyphBold();
+  int16_t width = textWidth(string);
+  int16_t height = fontHeight();
+  int16_t baseline = (int16_t)(7 * scale);
+
+  // Datum to the top-left of the text box
+  switch (textdatum % 3) {
+    case 1: x -= width / 2; break;
+    case 2: x -= width; break;
+  }
+  switch (textdatum) {
+    case ML_DATUM: case MC_DATUM: case MR_DATUM: y -= height / 2; break;
+    case BL_DATUM: case BC_DATUM: case BR_DATUM: y -= height; break;
+    case L_BASELINE: case C_BASELINE: case R_BASELINE: y -= baseline; break;
+  }
+
+  // Built-in fonts paint their background when one was set
+  if (freeFont == nullptr && textbgcolor != textcolor) {
+    int16_t boxWidth = max(width, (int16_t)padX);
+    fillRect(x, y, boxWidth, height, textbgcolor);
+  }
+
+  for (const char* p = string; *p; p++) x += drawGlyph(*p, x, y, xScale, scale, bold);
+  return width;
+}
+
+size_t TFT_eSPI::write(uint8_t c) {
+  if (c == '\n') {
+    cursorX = 0;
+    cursorY += fontHeight();
+    return 1;
+  }
+  if (c == '\r') return 1;
+  cursorX += drawGlyph((char)c, cursorX, cursorY, glyphXScale(), glyphScale(), glyphBold());
+  return 1;
+}
+
+// =====================================================
+// --- SPRITES ---
+// =====================================================
+
+// The library's default 4-bit palette
+static const uint16_t defaultPalette[16] = {
+  TFT_BLACK, TFT_BROWN, TFT_RED, TFT_ORANGE, TFT_YELLOW, TFT_GREEN, TFT_BLUE, TFT_PURPLE,
+  TFT_DARKGREY, TFT_WHITE, TFT_CYAN, TFT_MAGENTA, TFT_MAROON, TFT_DARKGREEN, TFT_NAVY, TFT_PINK,
+};
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI* tft) : TFT_eSPI(0, 0), parent(tft) {
+  panelOrder = true;
+}
+
+TFT_eSprite::~TFT_eSprite() {
+  deleteSprite();
+}
+
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
+  if (created()) return getPointer();
+  if (w <= 0 || h <= 0) return nullptr;
+  if (colorDepth == 4) {
+    // Rows are padded to whole bytes, like the library
+    _width = (w + 1) & ~1;
+    _height = h;
+    nibbles = new uint8_t[_width * _height / 2]();
+    createPalette(defaultPalette);
+    resetViewport();
+    return nibbles;
+  }
+  allocate(w, h);
+  return buffer;
+}
+
+void TFT_eSprite::deleteSprite() {
+  delete[] buffer;
+  buffer = nullptr;
+  delete[] nibbles;
+  nibbles = nullptr;
+  _width = _height = 0;
+  resetViewport();
+}
+
+// Like the library, this only fills the viewport
+void TFT_eSprite::fillSprite(uint32_t color) {
+  fillClipped(_vpX, _vpY, _vpW - _vpX, _vpH - _vpY, color);
+}
+
+void TFT_eSprite::createPalette(const uint16_t* colors, uint8_t count) {
+  for (int i = 0; i < 16; i++) palette[i] = i < count ? colors[i] : TFT_BLACK;
+}
+
+uint16_t TFT_eSprite::readPixelValue(int32_t x, int32_t y) {
+  if (nibbles == nullptr) return readPixel(x, y);
+  x += _xDatum;
+  y += _yDatum;
+  if (x < _vpX || y < _vpY || x >= _vpW || y >= _vpH) return 0;
+  uint8_t pair = nibbles[(y * _width + x) >> 1];
+  return (x & 1) ? (pair & 0x0F) : (pair >> 4);
+}
+
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) {
+  if (nibbles == nullptr) return TFT_eSPI::readPixel(x, y);
+  return palette[readPixelValue(x, y)];
+}
+
+// --- HELPER: Push a window of a 4-bit sprite through its palette ---
+void TFT_eSprite::pushIndexed(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh) {
+  std::vector<uint16_t> rgb(sw * sh);
+  for (int32_t row = 0; row < sh; row++) {
+    for (int32_t col = 0; col < sw; col++) {
+      uint8_t pair = nibbles[((sy + row) * _width + sx + col) >> 1];
+      rgb[row * sw + col] = palette[((sx + col) & 1) ? (pair & 0x0F) : (pair >> 4)];
+    }
+  }
+  parent->blit(tx, ty, sw, sh, rgb.data(), sw, false);
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y) {
+  if (nibbles != nullptr) {
+    pushIndexed(x, y, 0, 0, _width, _height);
+    return;
+  }
+  if (buffer == nullptr) return;
+  parent->blit(x, y, _width, _height, buffer, _width, true);
+}
+
+bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh) {
+  if (!created()) return false;
+  // Clip the source window to the sprite
+  if (sx < 0) { tx -= sx; sw += sx; sx = 0; }
+  if (sy < 0) { ty -= sy; sh += sy; sy = 0; }
+  if (sx + sw > _width) sw = _width - sx;
+  if (sy + sh > _height) sh = _height - sy;
+  if (sw <= 0 || sh <= 0) return false;
+  if (nibbles != nullptr) pushIndexed(tx, ty, sx, sy, sw, sh);
+  else parent->blit(tx, ty, sw, sh, buffer + sy * _width + sx, _width, true);
+  return true;
+}
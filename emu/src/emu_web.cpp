@@ -0,0 +1,297 @@
+#include <ESPAsyncWebServer.h>
+#include "emu.h"
+#include <thread>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+// =========================================================================
+// EMULATOR: ESPAsyncWebServer routing and an optional HTTP listener
+// =========================================================================
+
+static uint16_t httpPort = 0;
+
+void emuSetHttpPort(uint16_t port) {
+  httpPort = port;
+}
+
+// --- HELPER: Undo %XX and '+' in a query component ---
+static String urlDecode(const String& text) {
+  String out;
+  for (unsigned int i = 0; i < text.length(); i++) {
+    char c = text[i];
+    if (c == '+') {
+      out += ' ';
+    } else if (c == '%' && i + 2 < text.length()) {
+      char hex[3] = {text[i + 1], text[i + 2], 0};
+      out += (char)strtol(hex, nullptr, 16);
+      i += 2;
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+// =====================================================
+// --- REQUESTS ---
+// =====================================================
+
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethod method, const String& url) : _method(method) {
+  int query = url.indexOf('?');
+  _url = (query == -1) ? url : url.substring(0, query);
+  if (query == -1) return;
+
+  String rest = url.substring(query + 1);
+  while (rest.length() > 0) {
+    int amp = rest.indexOf('&');
+    String pair = (amp == -1) ? rest : rest.substring(0, amp);
+    rest = (amp == -1) ? String() : rest.substring(amp + 1);
+    int eq = pair.indexOf('=');
+    if (eq == -1) _params.emplace_back(urlDecode(pair), String());
+    else _params.emplace_back(urlDecode(pair.substring(0, eq)), urlDecode(pair.substring(eq + 1)));
+  }
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+  delete _response;
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool post, bool file) const {
+  for (const AsyncWebParameter& p : _params) {
+    if (p.name() == name) return true;
+  }
+  return false;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) {
+  for (AsyncWebParameter& p : _params) {
+    if (p.name() == name) return &p;
+  }
+  return nullptr;
+}
+
+String AsyncWebServerRequest::arg(const String& name) {
+  AsyncWebParameter* p = getParam(name);
+  return p ? p->value() : String();
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType, const String& content) {
+  AsyncWebServerResponse* response = new AsyncWebServerResponse(code, contentType);
+  response->body = content.str();
+  return response;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& contentType, AwsResponseFiller filler) {
+  AsyncWebServerResponse* response = new AsyncWebServerResponse(200, contentType);
+  response->filler = filler;
+  return response;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+  delete _response;
+  _response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const String& contentType, const String& content) {
+  send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::redirect(const String& url) {
+  AsyncWebServerResponse* response = beginResponse(302);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+// =====================================================
+// --- HANDLERS ---
+// =====================================================
+
+// Same rule as the library: method in the mask, and the path or one below it
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* request) {
+  if (!(_method & request->method())) return false;
+  return _uri.length() == 0 || request->url() == _uri || request->url().startsWith(_uri + "/");
+}
+
+void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* request) {
+  if (_onUpload && request->method() == HTTP_POST) {
+    request->send(501, "text/plain", "Uploads are not supported in the emulator");
+    return;
+  }
+  if (_onRequest) _onRequest(request);
+}
+
+void AsyncWebSocket::handleRequest(AsyncWebServerRequest* request) {
+  request->send(501, "text/plain", "WebSockets are not supported in the emulator");
+}
+
+AsyncWebServer::~AsyncWebServer() {
+  for (AsyncCallbackWebHandler* handler : _owned) delete handler;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest) {
+  return on(uri, method, onRequest, nullptr);
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload) {
+  AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler(uri, method, onRequest, onUpload);
+  _owned.push_back(handler);
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) {
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+int AsyncWebServer::emuRequest(WebRequestMethod method, const String& url, String& contentType, std::string& body,
+                               std::vector<std::pair<String, String>>* headers) {
+  AsyncWebServerRequest request(method, url);
+  AsyncWebHandler* match = nullptr;
+  for (AsyncWebHandler* handler : _handlers) {
+    if (handler->canHandle(&request)) {
+      match = handler;
+      break;
+    }
+  }
+  if (match != nullptr) match->handleRequest(&request);
+  else if (_notFound) _notFound(&request);
+
+  AsyncWebServerResponse* response = request.emuResponse();
+  if (response == nullptr) {
+    contentType = "text/plain";
+    body = "No response";
+    return 500;
+  }
+
+  contentType = response->contentType;
+  body = response->body;
+  if (response->filler) {
+    // Drain the chunks in library-sized pieces
+    uint8_t chunk[1460];
+    size_t index = 0;
+    while (size_t len = response->filler(chunk, sizeof(chunk), index)) {
+      body.append((const char*)chunk, len);
+      index += len;
+    }
+  }
+  if (headers != nullptr) *headers = response->headers;
+  return response->code;
+}
+
+// =====================================================
+// --- HTTP LISTENER ---
+// One connection at a time, Connection: close. Enough for a browser on
+// the web GUI or curl in a test.
+// =====================================================
+
+static const char* statusText(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 302: return "Found";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 501: return "Not Implemented";
+    default: return "Status";
+  }
+}
+
+static void serveConnection(AsyncWebServer* server, int fd) {
+  // Request line and headers, then the body if there is one
+  std::string head;
+  char buf[1024];
+  size_t headEnd;
+  while ((headEnd = head.find("\r\n\r\n")) == std::string::npos && head.size() < 16384) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) return;
+    head.append(buf, n);
+  }
+  if (headEnd == std::string::npos) return;
+  std::string content = head.substr(headEnd + 4);
+  String headers(head.substr(0, headEnd));
+  headers.toLowerCase();
+  int length = headers.indexOf("content-length:");
+  size_t contentLength = (length == -1) ? 0 : strtoul(headers.c_str() + length + 15, nullptr, 10);
+  while (content.size() < contentLength) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) return;
+    content.append(buf, n);
+  }
+  size_t lineEnd = head.find("\r\n");
+  String requestLine(head.substr(0, lineEnd));
+  int space1 = requestLine.indexOf(' ');
+  int space2 = requestLine.indexOf(' ', space1 + 1);
+  if (space1 == -1 || space2 == -1) return;
+  String method = requestLine.substring(0, space1);
+  String url = requestLine.substring(space1 + 1, space2);
+
+  // Form posts (application/x-www-form-urlencoded) become parameters, as
+  // the library does; anything else in the body is ignored
+  if (method == "POST" && content.size() > 0 && headers.indexOf("application/x-www-form-urlencoded") != -1) {
+    url += (url.indexOf('?') == -1) ? "?" : "&";
+    url += String(content);
+  }
+
+  WebRequestMethod verb = method == "POST" ? HTTP_POST : method == "GET" ? HTTP_GET : HTTP_ANY;
+  String contentType;
+  std::string body;
+  std::vector<std::pair<String, String>> responseHeaders;
+  int code;
+  if (verb == HTTP_ANY) {
+    code = 405;
+    contentType = "text/plain";
+    body = "Method not allowed";
+  } else {
+    code = server->emuRequest(verb, url, contentType, body, &responseHeaders);
+  }
+
+  String response = "HTTP/1.1 " + String(code) + " " + statusText(code) + "\r\n";
+  if (contentType.length() > 0) response += "Content-Type: " + contentType + "\r\n";
+  for (const auto& header : responseHeaders) {
+    if (header.first.equalsIgnoreCase("Connection")) continue;
+    response += header.first + ": " + header.second + "\r\n";
+  }
+  response += "Content-Length: " + String((unsigned long)body.size()) + "\r\nConnection: close\r\n\r\n";
+  std::string out = response.str() + body;
+  size_t sent = 0;
+  while (sent < out.size()) {
+    ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) break;
+    sent += n;
+  }
+}
+
+void AsyncWebServer::begin() {
+  if (httpPort == 0) {
+    Serial.printf("[emu] Web server ready (port %u is script-only)\n", _port);
+    return;
+  }
+
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(httpPort);
+  if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 4) != 0) {
+    Serial.printf("[emu] Cannot listen on port %u\n", httpPort);
+    ::close(listener);
+    return;
+  }
+  Serial.printf("[emu] Web server on http://127.0.0.1:%u/\n", httpPort);
+
+  // The library serves from its own task too
+  std::thread([this, listener]() {
+    for (;;) {
+      int fd = accept(listener, nullptr, nullptr);
+      if (fd < 0) continue;
+      serveConnection(this, fd);
+      ::close(fd);
+    }
+  }).detach();
+}
@@ -0,0 +1,87 @@
+#include "command_queue.h"
+#include "power.h" // For powerWake
+#include <atomic>
+
+static_assert((COMMAND_QUEUE_LEN & (COMMAND_QUEUE_LEN - 1)) == 0, "COMMAND_QUEUE_LEN must be a power of two");
+
+// A slot is free for the post at position p when sequence == p, and
+// holds the command to take at p when sequence == p + 1. Taking it sets
+// sequence to p + COMMAND_QUEUE_LEN: free for the post one lap later.
+struct CommandSlot {
+  std::atomic<uint32_t> sequence;
+  Command command;
+};
+
+static CommandSlot slots[COMMAND_QUEUE_LEN];
+static std::atomic<uint32_t> postPos(0); // Next position to post to (any task)
+static uint32_t takePos = 0;             // Next position to take from (loop() only)
+static std::atomic<unsigned long> dropped(0);
+
+// Slot i starts free for position i; set before setup() runs
+static struct SlotInit {
+  SlotInit() {
+    for (uint32_t i = 0; i < COMMAND_QUEUE_LEN; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+} slotInit;
+
+// --- HELPER: Claim a slot and fill it in ---
+static bool post(CommandType type, int32_t value, int32_t value2, const char* text, char* longText) {
+  // Claim a position: the slot must be free for it, and no other task may claim it first
+  uint32_t pos = postPos.load(std::memory_order_relaxed);
+  CommandSlot* slot;
+  for (;;) {
+    slot = &slots[pos & (COMMAND_QUEUE_LEN - 1)];
+    int32_t lag = (int32_t)(slot->sequence.load(std::memory_order_acquire) - pos);
+    if (lag == 0) {
+      if (postPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (lag < 0) {
+      dropped++; // Still holds the command from a lap ago: full
+      Serial.printf("[cmd] Queue full, dropped command %d\n", (int)type);
+      return false;
+    } else {
+      pos = postPos.load(std::memory_order_relaxed); // Another task claimed it
+    }
+  }
+
+  slot->command.type = type;
+  slot->command.value = value;
+  slot->command.value2 = value2;
+  strlcpy(slot->command.text, text, sizeof(slot->command.text));
+  slot->command.longText = longText;
+  slot->sequence.store(pos + 1, std::memory_order_release); // Publish
+  powerWake(); // loop() may be asleep in powerIdle()
+  return true;
+}
+
+bool postCommand(CommandType type, int32_t value, int32_t value2, const char* text) {
+  return post(type, value, value2, text, nullptr);
+}
+
+bool postCommandLong(CommandType type, int32_t value, const String& text) {
+  char* longText = strdup(text.c_str());
+  if (longText == nullptr) return false;
+  if (post(type, value, 0, "", longText)) return true;
+  free(longText); // Never queued
+  return false;
+}
+
+bool takeCommand(Command& out) {
+  CommandSlot& slot = slots[takePos & (COMMAND_QUEUE_LEN - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != takePos + 1) return false; // Empty, or still being written
+  out = slot.command;
+  slot.sequence.store(takePos + COMMAND_QUEUE_LEN, std::memory_order_release); // Free for the next lap
+  takePos++;
+  return true;
+}
+
+unsigned long commandsDropped() {
+  return dropped;
+}
+
+uint32_t commandsPosted() {
+  return postPos.load(std::memory_order_relaxed);
+}
+
+uint32_t commandsTaken() {
+  return takePos;
+}
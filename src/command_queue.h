@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h" // For COMMAND_TEXT_LEN
+
+// =========================================================================
+// COMMAND QUEUE
+// The web server's callbacks run on the async_tcp task, the pages on the
+// loop() task. Instead of writing globals that loop() reads at the same
+// time, a handler posts a typed command here and loop() applies it
+// between frames (see applyCommand() in main.cpp), so everything the
+// display depends on is only ever written by loop().
+//
+// The queue is a bounded ring of COMMAND_QUEUE_LEN slots without locks:
+// each slot carries a sequence number that says whether it is free for
+// the next post or holds the next command to take. Any number of tasks
+// may post; only loop() takes. Commands carry their text in the slot, so
+// nothing is allocated on either side, except for the one kind of text
+// that has no useful bound (a whole list, see postCommandLong()).
+// =========================================================================
+
+enum CommandType {
+  CMD_SHOW_TICKER,    // text: symbol to show now
+  CMD_SHOW_LOCATION,  // text: location to show now
+  CMD_SET_INTERVAL,   // value: rotation interval, ms
+  CMD_SET_WATCHLIST,  // value: enabled (-1 keep), value2: WatchlistSort (-1 keep)
+  CMD_SET_HOURLY,     // value: enabled
+  CMD_SET_TAPE,       // value: enabled
+  CMD_SET_THEME,      // value: Theme
+  CMD_SET_STREAM,     // value: enabled (-1 keep), text: URL ("" keep)
+  CMD_SET_NIGHT,      // value: NightMode, value2: start hour << 8 | end hour
+  CMD_RELOAD_LAYOUT,  // /layout.json was replaced or removed
+  CMD_ADD_STOCK,      // text: symbol to add to the rotation (ignored if listed)
+  CMD_REMOVE_STOCK,   // text: symbol to take out of the rotation
+  CMD_ADD_LOCATION,   // text: location to add to the rotation (ignored if listed)
+  CMD_REMOVE_LOCATION, // text: location to take out of the rotation
+  CMD_SET_LIST,       // value: ListKind, longText: the whole list, comma separated
+  CMD_RESTORE_LISTS,  // Both lists back to the defaults from secrets
+  CMD_OTA_STARTED,    // A firmware upload began; show it and stop drawing pages
+};
+
+enum ListKind { LIST_STOCKS, LIST_LOCATIONS };
+
+struct Command {
+  CommandType type;
+  int32_t value;
+  int32_t value2;
+  char text[COMMAND_TEXT_LEN]; // Truncated to fit
+  char* longText;              // postCommandLong() only, else nullptr; loop() frees it once applied
+};
+
+// Queues a command from any task. False if the queue is full; the
+// caller should answer 503 so the web GUI can retry.
+bool postCommand(CommandType type, int32_t value = 0, int32_t value2 = 0, const char* text = "");
+
+// Same, for text of any length: it travels as a heap copy in longText.
+// Also false if that copy cannot be allocated.
+bool postCommandLong(CommandType type, int32_t value, const String& text);
+
+// Takes the oldest command. loop() task only; false when there is none.
+bool takeCommand(Command& out);
+
+// Commands refused because the queue was full
+unsigned long commandsDropped();
+
+// Commands posted and taken since boot. Once commandsTaken() (read by
+// loop() after applying them) reaches a value commandsPosted() had,
+// every command posted before that has been applied.
+uint32_t commandsPosted();
+uint32_t commandsTaken();
@@ -69,6 +69,16 @@ const char index_html[] PROGMEM = R"rawliteral(
       background: transparent; color: var(--text); outline: none; box-sizing: border-box;
     }
     input[type=file] { padding: 8px; font-size: 14px; }
+    select {
+      width: 100%; padding: 10px; font-size: 16px;
+      border-radius: 8px; border: 1px solid var(--card-border);
+      background: var(--bg); color: var(--text); outline: none; box-sizing: border-box;
+    }
+    textarea {
+      width: 100%; height: 320px; padding: 10px; font-size: 12px; font-family: ui-monospace, monospace;
+      border-radius: 8px; border: 1px solid var(--card-border); white-space: pre; resize: vertical;
+      background: transparent; color: var(--text); outline: none; box-sizing: border-box;
+    }
     button {
       width: 100%; margin-top: 12px; padding: 10px 12px;
       border-radius: 8px; border: none; background: var(--accent);
@@ -185,6 +195,8 @@ const char index_html[] PROGMEM = R"rawliteral(
       <button class="tab-link" onclick="openTab(event, 'settings')">Rotation</button>
       <button class="tab-link" onclick="openTab(event, 'network')">Network</button>
       <button class="tab-link" onclick="openTab(event, 'update')">Update</button>
+      <button class="tab-link" onclick="openTab(event, 'screen')">Screen</button>
+      <button class="tab-link" onclick="openTab(event, 'layout')">Layout</button>
     </div>
 
     <!-- Tab 1: One-Off Fetch -->
@@ -213,6 +225,76 @@ const char index_html[] PROGMEM = R"rawliteral(
       </form>
       <!-- --- END --- -->
 
+      <!-- --- Hourly --- -->
+      <h2>Hourly Forecast</h2>
+      <form id="hourly-form" action="/set_hourly" method="GET" onsubmit="saveHourly(event, this)">
+        <label for="hourly-enabled"><input id="hourly-enabled" type="checkbox" /> Chart the next 48 hours after the weather page</label>
+        <button type="submit">Save Hourly Forecast</button>
+      </form>
+      <!-- --- END --- -->
+
+      <!-- --- Watchlist --- -->
+      <h2>Watchlist Grid</h2>
+      <form id="watchlist-form" action="/set_watchlist" method="GET" onsubmit="saveWatchlist(event, this)">
+        <label for="watchlist-enabled"><input id="watchlist-enabled" type="checkbox" /> Show the stock list as a grid after the weather pages</label>
+        <label for="watchlist-sort" style="margin-top: 1rem;">Order</label>
+        <select id="watchlist-sort" name="sort">
+          <option value="list">List order</option>
+          <option value="gainers">Top gainers</option>
+          <option value="losers">Top losers</option>
+        </select>
+        <button type="submit">Save Watchlist</button>
+      </form>
+      <!-- --- END --- -->
+
+      <!-- --- Ticker Tape --- -->
+      <h2>Ticker Tape</h2>
+      <form id="tape-form" action="/set_tape" method="GET" onsubmit="saveTape(event, this)">
+        <label for="tape-enabled"><input id="tape-enabled" type="checkbox" /> Scroll the whole stock list after the weather pages</label>
+        <button type="submit">Save Ticker Tape</button>
+      </form>
+      <!-- --- END --- -->
+
+      <!-- --- Theme --- -->
+      <h2>Theme</h2>
+      <form id="theme-form" action="/set_theme" method="GET" onsubmit="saveTheme(event, this)">
+        <label for="theme-name">Colours (switch without redrawing the page)</label>
+        <select id="theme-name" name="name">
+          <option value="mocha">Catppuccin Mocha</option>
+          <option value="latte">Catppuccin Latte</option>
+          <option value="contrast">High contrast</option>
+        </select>
+        <button type="submit">Save Theme</button>
+      </form>
+      <!-- --- END --- -->
+
+      <!-- --- Night Profile --- -->
+      <h2>Night Profile</h2>
+      <form id="power-form" action="/set_power" method="GET" onsubmit="savePower(event, this)">
+        <label for="night-mode">At night <span id="power-status"></span></label>
+        <select id="night-mode" name="night_mode">
+          <option value="none">Stay lit</option>
+          <option value="dim">Dim the backlight</option>
+          <option value="blank">Blank the panel (a touch lights it)</option>
+        </select>
+        <label for="night-start" style="margin-top: 1rem;">From hour (UTC, 0-23)</label>
+        <input id="night-start" name="night_start" type="number" min="0" max="23" />
+        <label for="night-end" style="margin-top: 1rem;">Until hour (UTC, 0-23)</label>
+        <input id="night-end" name="night_end" type="number" min="0" max="23" />
+        <button type="submit">Save Night Profile</button>
+      </form>
+      <!-- --- END --- -->
+
+      <!-- --- Live Prices --- -->
+      <h2>Live Prices</h2>
+      <form id="stream-form" action="/set_stream" method="GET" onsubmit="saveStream(event, this)">
+        <label for="stream-enabled"><input id="stream-enabled" type="checkbox" /> Stream trades over WebSocket <span id="stream-status"></span></label>
+        <label for="stream-url" style="margin-top: 1rem;">Stream URL (blank for wss://ws.finnhub.io)</label>
+        <input id="stream-url" name="url" type="text" placeholder="wss://ws.finnhub.io" autocomplete="off" />
+        <button type="submit">Save Live Prices</button>
+      </form>
+      <!-- --- END --- -->
+
       <!-- Stock Ticker List -->
       <h2>Stock Rotation List</h2>
       <div id="stock-list"><!-- Items will be injected here --></div>
@@ -246,14 +328,15 @@ const char index_html[] PROGMEM = R"rawliteral(
       <h2>Network Settings</h2>
       <p style="font-size: 14px; color: var(--muted);">Currently connected to: <span id="current-ssid" class="current-ssid">Loading...</span></p>
       
-      <form action="/connect_wifi" method="GET">
+      <form id="wifi-form" action="/connect_wifi" method="GET" onsubmit="connectWifi(event, this)">
         <label for="ssid-new">New WiFi SSID</label>
         <input id="ssid-new" name="ssid" type="text" placeholder="New Network Name" autocomplete="off" />
         <label for="pass-new" style="margin-top: 1rem;">New WiFi Password</label>
         <input id="pass-new" name="pass" type="password" placeholder="New Network Password" />
-        <button type="submit">Connect & Reboot</button>
+        <button type="submit">Connect</button>
       </form>
-      <small style="font-size: 11px; color: var(--muted);">Device will attempt to connect. If it fails, it will revert to the default. The page will reload, and the IP may change.</small>
+      <p id="wifi-progress" style="font-size: 14px; color: var(--muted);"></p>
+      <small style="font-size: 11px; color: var(--muted);">Device will attempt to connect. If it fails, it falls back to the network it was on, then to the default. No reboot; the IP may change.</small>
     </div>
 
     <!-- Tab 4: OTA Update -->
@@ -272,6 +355,24 @@ const char index_html[] PROGMEM = R"rawliteral(
       <div class="upload-status" id="upload-status">Uploading... 0%</div>
     </div>
 
+    <!-- Tab 5: Live Screen -->
+    <div id="screen" class="tab-content">
+      <h2>Live Screen</h2>
+      <canvas id="screen-canvas" width="320" height="240" style="width: 100%; border-radius: 8px; border: 1px solid var(--card-border);"></canvas>
+      <label for="screen-live" style="margin-top: 1rem;"><input id="screen-live" type="checkbox" onchange="setScreenLive(this.checked)" /> Live updates <span id="screen-status"></span></label>
+      <button onclick="loadScreen()">Refresh</button>
+    </div>
+
+    <!-- Tab 6: Page Layouts -->
+    <div id="layout" class="tab-content">
+      <h2>Page Layouts</h2>
+      <p style="font-size: 14px; color: var(--muted);">Where each widget of the Stocks, Weather and Hourly pages sits and which field it shows (e.g. <b>{quote.c}</b>, <b>{forecast.daily[1].max}</b>). Pages left out keep the built-in layout.</p>
+      <textarea id="layout-json" spellcheck="false"></textarea>
+      <div class="upload-status" id="layout-status"></div>
+      <button onclick="saveLayout()">Save Layout</button>
+      <button class="btn-outline" onclick="restoreLayout()">Restore Built-in Layout</button>
+    </div>
+
   </div>
 
   <script>
@@ -295,6 +396,58 @@ const char index_html[] PROGMEM = R"rawliteral(
       if (tabName === 'settings' || tabName === 'network') {
         loadListsAndNetwork();
       }
+      if (tabName === 'layout') {
+        loadLayout();
+      }
+      if (tabName === 'screen') {
+        loadScreen();
+      } else {
+        setScreenLive(false);
+      }
+    }
+
+    // --- LIVE SCREEN ---
+    // Both /screen and /screen_ws send RLE565 rects: x, y, w, h (uint16 LE),
+    // then runs of [count][RGB565 LE] filling the rect row by row.
+    let screenSocket = null;
+
+    function drawRle565(bytes, offset) {
+      const view = new DataView(bytes.buffer, bytes.byteOffset);
+      const x = view.getUint16(offset, true), y = view.getUint16(offset + 2, true);
+      const w = view.getUint16(offset + 4, true), h = view.getUint16(offset + 6, true);
+      if (w === 0 || h === 0) return;
+      const ctx = document.getElementById('screen-canvas').getContext('2d');
+      const image = ctx.createImageData(w, h);
+      let p = 0;
+      for (let i = offset + 8; i + 2 < bytes.length && p < w * h * 4; i += 3) {
+        const c = bytes[i + 1] | (bytes[i + 2] << 8);
+        const r = (c >> 11) * 255 / 31, g = ((c >> 5) & 63) * 255 / 63, b = (c & 31) * 255 / 31;
+        for (let n = 0; n < bytes[i]; n++) {
+          image.data[p++] = r; image.data[p++] = g; image.data[p++] = b; image.data[p++] = 255;
+        }
+      }
+      ctx.putImageData(image, x, y);
+    }
+
+    async function loadScreen() {
+      const response = await fetch('/screen');
+      drawRle565(new Uint8Array(await response.arrayBuffer()), 4); // Skip "R565"
+    }
+
+    function setScreenLive(on) {
+      document.getElementById('screen-live').checked = on;
+      if (!on) {
+        if (screenSocket) screenSocket.close();
+        screenSocket = null;
+        document.getElementById('screen-status').innerText = '';
+        return;
+      }
+      if (screenSocket) return;
+      screenSocket = new WebSocket(`ws://${location.host}/screen_ws`);
+      screenSocket.binaryType = 'arraybuffer';
+      screenSocket.onopen = () => document.getElementById('screen-status').innerText = '(connected)';
+      screenSocket.onclose = () => { screenSocket = null; setScreenLive(false); };
+      screenSocket.onmessage = (e) => drawRle565(new Uint8Array(e.data), 0);
     }
 
     // --- UX FUNCTIONS ---
@@ -308,7 +461,11 @@ const char index_html[] PROGMEM = R"rawliteral(
       // Check if input is empty
       if (!params.values().next().value) return; 
 
-      await fetch(form.action + '?' + params.toString());
+      const response = await fetch(form.action + '?' + params.toString());
+      if (!response.ok) {
+        alert(await response.text());
+        return;
+      }
       form.reset(); // Clear the input field
       await loadListsAndNetwork(); // Refresh the list
     }
@@ -316,7 +473,8 @@ const char index_html[] PROGMEM = R"rawliteral(
     // Handles removing items without a page reload
     async function removeItem(event, url) {
       event.preventDefault(); // Stop page reload
-      await fetch(url); // Call the remove endpoint
+      const response = await fetch(url); // Call the remove endpoint
+      if (!response.ok) alert(await response.text());
       await loadListsAndNetwork(); // Refresh just the lists
     }
 
@@ -335,8 +493,136 @@ const char index_html[] PROGMEM = R"rawliteral(
         return;
       }
 
-      await fetch(form.action + '?' + params.toString());
-      alert("Rotation interval saved!"); // Give user feedback
+      const response = await fetch(form.action + '?' + params.toString());
+      alert(response.ok ? "Rotation interval saved!" : await response.text()); // Give user feedback
+    }
+
+    // --- Save Hourly Forecast ---
+    async function saveHourly(event, form) {
+      event.preventDefault();
+      const enabled = document.getElementById('hourly-enabled').checked ? '1' : '0';
+      const response = await fetch(form.action + '?enabled=' + enabled);
+      alert(response.ok ? "Hourly forecast setting saved!" : await response.text());
+    }
+
+    // --- Save Watchlist Grid ---
+    async function saveWatchlist(event, form) {
+      event.preventDefault();
+      const params = new URLSearchParams();
+      params.set('enabled', document.getElementById('watchlist-enabled').checked ? '1' : '0');
+      params.set('sort', document.getElementById('watchlist-sort').value);
+      const response = await fetch(form.action + '?' + params.toString());
+      alert(response.ok ? "Watchlist settings saved!" : await response.text());
+    }
+
+    // --- Save Ticker Tape ---
+    async function saveTape(event, form) {
+      event.preventDefault();
+      const enabled = document.getElementById('tape-enabled').checked ? '1' : '0';
+      const response = await fetch(form.action + '?enabled=' + enabled);
+      alert(response.ok ? "Ticker tape setting saved!" : await response.text());
+    }
+
+    // --- Save Theme ---
+    async function saveTheme(event, form) {
+      event.preventDefault();
+      const name = document.getElementById('theme-name').value;
+      const response = await fetch(form.action + '?name=' + encodeURIComponent(name));
+      alert(response.ok ? "Theme saved!" : await response.text());
+    }
+
+    // --- Save Night Profile ---
+    async function savePower(event, form) {
+      event.preventDefault();
+      const params = new URLSearchParams();
+      params.set('night_mode', document.getElementById('night-mode').value);
+      params.set('night_start', document.getElementById('night-start').value);
+      params.set('night_end', document.getElementById('night-end').value);
+      const response = await fetch(form.action + '?' + params.toString());
+      alert(response.ok ? "Night profile saved!" : await response.text());
+    }
+
+    // --- Switch WiFi Network (runs on the device; poll its progress) ---
+    const wifiStateText = {
+      connecting: 'Connecting to', falling_back: 'Failed; falling back to', reverting: 'Failed; reverting to',
+      connected: 'Connected to', fell_back: 'Could not connect; back on', reverted: 'Could not connect; reverted to',
+      failed: 'Could not connect to any network; retrying', idle: 'Idle'
+    };
+
+    async function connectWifi(event, form) {
+      event.preventDefault();
+      const progress = document.getElementById('wifi-progress');
+      const params = new URLSearchParams();
+      params.set('ssid', document.getElementById('ssid-new').value.trim());
+      params.set('pass', document.getElementById('pass-new').value);
+      const response = await fetch(form.action + '?' + params.toString());
+      if (!response.ok) {
+        progress.innerText = await response.text();
+        return;
+      }
+      const job = await response.json();
+      const poll = async () => {
+        let status;
+        try {
+          status = await (await fetch(job.status)).json();
+        } catch (e) {
+          progress.innerText = 'Lost the device: it may have moved to the new network (try http://esp32-ticker.local).';
+          return;
+        }
+        const ip = status.ip && status.ip !== '0.0.0.0' ? ` (${status.ip})` : '';
+        progress.innerText = `${wifiStateText[status.state]} ${status.ssid}` + (status.done ? ip : ` ... ${Math.round(status.elapsed_ms / 1000)}s`);
+        if (status.done) {
+          loadListsAndNetwork();
+        } else {
+          setTimeout(poll, 1000);
+        }
+      };
+      poll();
+    }
+
+    // --- Save Live Price Stream ---
+    async function saveStream(event, form) {
+      event.preventDefault();
+      const params = new URLSearchParams();
+      params.set('enabled', document.getElementById('stream-enabled').checked ? '1' : '0');
+      params.set('url', document.getElementById('stream-url').value.trim());
+      const response = await fetch(form.action + '?' + params.toString());
+      alert(response.ok ? "Live price settings saved!" : await response.text());
+    }
+
+    // --- Page Layouts ---
+    function showLayoutStatus(text, color) {
+      const status = document.getElementById('layout-status');
+      status.style.display = 'block';
+      status.style.color = color;
+      status.innerText = text;
+    }
+
+    async function loadLayout() {
+      const response = await fetch('/layout');
+      document.getElementById('layout-json').value = await response.text();
+      document.getElementById('layout-status').style.display = 'none';
+    }
+
+    // The device checks the layout before saving it and says what is wrong
+    async function saveLayout() {
+      const params = new URLSearchParams();
+      params.set('layout', document.getElementById('layout-json').value);
+      const response = await fetch('/layout', { method: 'POST', body: params });
+      if (response.ok) {
+        showLayoutStatus('Layout saved.', 'var(--blue)');
+      } else {
+        showLayoutStatus(await response.text(), 'var(--red)');
+      }
+    }
+
+    async function restoreLayout() {
+      if (!confirm("Replace your layout with the built-in one?")) {
+        return;
+      }
+      await fetch('/restore_layout');
+      await loadLayout();
+      showLayoutStatus('Built-in layout restored.', 'var(--blue)');
     }
 
     // --- Initialize the sortable lists ---
@@ -374,7 +660,12 @@ const char index_html[] PROGMEM = R"rawliteral(
       const listParam = encodeURIComponent(items.join(','));
       
       try {
-        await fetch(`/update_lists?type=${type}&list=${listParam}`);
+        const response = await fetch(`/update_lists?type=${type}&list=${listParam}`);
+        if (!response.ok) {
+          alert(await response.text());
+          await loadListsAndNetwork(); // Back to the order the device has
+          return;
+        }
         console.log(`Saved new ${type} order`);
       } catch (e) {
         console.error("Failed to save list order", e);
@@ -390,7 +681,11 @@ const char index_html[] PROGMEM = R"rawliteral(
       }
       
       try {
-        await fetch('/restore_defaults');
+        const response = await fetch('/restore_defaults');
+        if (!response.ok) {
+          alert(await response.text());
+          return;
+        }
         console.log("Restored default lists.");
         await loadListsAndNetwork(); // Refresh the UI
       } catch (e) {
@@ -401,9 +696,14 @@ const char index_html[] PROGMEM = R"rawliteral(
 
     // Load and render lists from ESP32
     async function loadListsAndNetwork() {
-      // Fetch lists
-      const listResponse = await fetch('/get_lists');
-      const listData = await listResponse.json();
+      // Fetch lists, once the device has applied the edits just sent (a page
+      // transition or fetch can hold its main loop up for a moment)
+      let listData;
+      for (let tries = 0; ; tries++) {
+        listData = await (await fetch('/get_lists')).json();
+        if (!listData.pending || tries >= 20) break;
+        await new Promise(resolve => setTimeout(resolve, 150));
+      }
       
       const stockListEl = document.getElementById('stock-list');
       stockListEl.innerHTML = ''; // Clear old list
@@ -444,6 +744,36 @@ const char index_html[] PROGMEM = R"rawliteral(
         document.getElementById('interval-sec').value = listData.interval_sec;
       }
 
+      // --- Load hourly forecast setting ---
+      document.getElementById('hourly-enabled').checked = !!listData.hourly_enabled;
+
+      // --- Load watchlist settings ---
+      document.getElementById('watchlist-enabled').checked = !!listData.watchlist_enabled;
+      document.getElementById('watchlist-sort').value = listData.watchlist_sort || 'list';
+
+      // --- Load ticker tape setting ---
+      document.getElementById('tape-enabled').checked = !!listData.tape_enabled;
+
+      // --- Load theme ---
+      document.getElementById('theme-name').value = listData.theme || 'mocha';
+
+      // --- Load night profile, and how much of the time loop() sleeps ---
+      document.getElementById('night-mode').value = listData.night_mode || 'none';
+      document.getElementById('night-start').value = listData.night_start;
+      document.getElementById('night-end').value = listData.night_end;
+      const powerResponse = await fetch('/power_stats');
+      if (powerResponse.ok) {
+        const power = await powerResponse.json();
+        document.getElementById('power-status').innerText =
+          '(idle ' + Math.round(power.idle_percent) + '% of the time, ' + power.mode + ')';
+      }
+
+      // --- Load live price stream settings ---
+      document.getElementById('stream-enabled').checked = !!listData.stream_enabled;
+      document.getElementById('stream-url').value = listData.stream_url || '';
+      document.getElementById('stream-status').innerText =
+        listData.stream_enabled ? (listData.stream_connected ? '(connected)' : '(connecting...)') : '';
+
       // --- Initialize Sortable.js after lists are rendered ---
       initSortable();
 
@@ -530,6 +860,44 @@ const char index_html[] PROGMEM = R"rawliteral(
 </html>
 )rawliteral";
 
+// Built-in page layouts (see layout.h); /layout.json replaces them page by page
+const char default_layout_json[] PROGMEM = R"rawliteral({
+  "stocks": [
+    {"type": "header", "rect": [0, 0, 320, 29], "text": "Stocks"},
+    {"type": "footer", "rect": [0, 216, 320, 24]},
+    {"type": "label", "rect": [0, 43, 320, 24], "at": [160, 55], "datum": "MC", "font": "medium_bold", "text": "{ticker}", "color": "muted"},
+    {"type": "value", "rect": [0, 70, 320, 40], "at": [160, 90], "datum": "MC", "font": "large_bold", "text": "${quote.c}"},
+    {"type": "value", "rect": [0, 113, 320, 24], "at": [160, 125], "datum": "MC", "font": "medium_bold", "text": "{quote.d:+} ({quote.dp:+}%)", "color": "change"},
+    {"type": "sparkline", "rect": [64, 139, 192, 16], "color": "change"},
+    {"type": "label", "rect": [0, 157, 160, 16], "at": [80, 165], "datum": "MC", "text": "OPEN", "color": "muted"},
+    {"type": "label", "rect": [160, 157, 160, 16], "at": [240, 165], "datum": "MC", "text": "PREV CLOSE", "color": "muted"},
+    {"type": "value", "rect": [0, 174, 160, 17], "at": [80, 183], "datum": "MC", "font": "small_bold", "text": "{quote.o}"},
+    {"type": "value", "rect": [160, 174, 160, 17], "at": [240, 183], "datum": "MC", "font": "small_bold", "text": "{quote.pc}"},
+    {"type": "bar", "rect": [0, 184, 320, 18], "at": [75, 190], "size": 170, "lo": "quote.l", "hi": "quote.h", "pos": "quote.c", "color": "change"},
+    {"type": "age", "rect": [240, 216, 80, 24]}
+  ],
+  "weather": [
+    {"type": "header", "rect": [0, 0, 320, 29], "text": "Weather"},
+    {"type": "footer", "rect": [0, 216, 320, 24]},
+    {"type": "label", "rect": [0, 31, 320, 24], "at": [160, 43], "datum": "MC", "font": "medium_bold", "text": "{location}", "color": "muted"},
+    {"type": "icon", "rect": [46, 64, 68, 75], "at": [80, 95], "size": 50, "code": "current.code"},
+    {"type": "temp", "rect": [136, 62, 184, 44], "at": [140, 85], "datum": "ML", "font": "large_bold"},
+    {"type": "label", "rect": [0, 127, 320, 16], "at": [160, 135], "datum": "MC", "font": "small_bold", "text": "{current.desc} ({forecast.daily[0].max}/{forecast.daily[0].min})", "color": "accent"},
+    {"type": "rule", "rect": [10, 150, 300, 1], "color": "muted"},
+    {"type": "card", "rect": [10, 151, 100, 75], "at": [60, 160], "font": "small_bold", "size": 30, "day": 1},
+    {"type": "card", "rect": [110, 151, 100, 75], "at": [160, 160], "font": "small_bold", "size": 30, "day": 2},
+    {"type": "card", "rect": [210, 151, 100, 75], "at": [260, 160], "font": "small_bold", "size": 30, "day": 3},
+    {"type": "age", "rect": [240, 216, 80, 24]}
+  ],
+  "hourly": [
+    {"type": "header", "rect": [0, 0, 320, 29], "text": "Hourly"},
+    {"type": "footer", "rect": [0, 216, 320, 24]},
+    {"type": "label", "rect": [0, 31, 320, 17], "at": [160, 40], "datum": "MC", "font": "small_bold", "text": "{location} - 48h", "color": "muted"},
+    {"type": "chart", "rect": [0, 48, 320, 168]},
+    {"type": "age", "rect": [240, 216, 80, 24]}
+  ]
+})rawliteral";
+
 // Finnhub CA (Google)
 const char test_root_ca[] PROGMEM = R"literal(
 -----BEGIN CERTIFICATE-----
@@ -17,14 +17,93 @@
 #define TOUCH_X_MAX 3843
 #define TOUCH_Y_MIN 280
 #define TOUCH_Y_MAX 3865
+#define TOUCH_Z_MIN 100   // Pressure range of a real press; outside it is noise
+#define TOUCH_Z_MAX 3000
+
+// Touch sampling and gestures (see touch_input.h)
+#define TOUCH_TASK_CORE 0          // Off loop()'s core, so a long frame never delays sampling
+#define TOUCH_TASK_STACK 4096
+#define TOUCH_TASK_PRIORITY 2      // Above the network worker on core 0
+#define TOUCH_QUEUE_LEN 8          // Gestures waiting for loop()
+#define TOUCH_SAMPLE_MS 10         // SPI reads while the panel is pressed
+#define TOUCH_RELEASE_SAMPLES 2    // Unpressed reads in a row that end a press
+#define TOUCH_MOVE_SLOP_PX 12      // Wobble still counted as not moving
+#define TOUCH_SWIPE_MIN_PX 50      // Sideways travel of a swipe
+#define TOUCH_LONG_PRESS_MS 700
+#define TOUCH_LATENCY_BUDGET_MS 50 // Gesture recognized -> acted on
+
+// =========================================================================
+// POWER (see power.h)
+// =========================================================================
+#define POWER_CPU_MIN_MHZ 80       // Clock while every task waits; WiFi needs 80
+#define POWER_MAX_IDLE_MS 5000     // Longest loop() sleeps without a deadline
+#define POWER_BACKLIGHT_PIN 21     // TFT_BL in TFT_eSPI's User_Setup.h
+#define POWER_BACKLIGHT_CHANNEL 7  // LEDC channel (timer 3)
+#define POWER_BACKLIGHT_FREQ 5000  // PWM Hz, 8-bit duty
+#define POWER_NIGHT_DIM_LEVEL 24   // Dimmed backlight, of 255
+#define POWER_NIGHT_WAKE_MS 30000  // A gesture lights the panel this long at night
 
 // =========================================================================
 // WIFI & WEB
 // =========================================================================
 #define ALLOW_INSECURE_TEST 0
 
+// /connect_wifi (see wifi_switch.h)
+#define WIFI_SWITCH_TIMEOUT_MS 10000  // Per network tried
+#define WIFI_SWITCH_MAX_REFUSALS 2    // "Not found" / "wrong password" answers that end a try early
+
+// Web handler -> loop() commands (see command_queue.h)
+#define COMMAND_QUEUE_LEN 16  // Power of two
+#define COMMAND_TEXT_LEN 96   // Ticker, location or stream URL, with its NUL
+
 extern const char* PARAM_INPUT; // This is now unused, but we'll leave it
 
+// =========================================================================
+// NETWORK WORKER (HTTPS runs here, off the render loop)
+// =========================================================================
+#define NET_TASK_CORE 0       // loop() runs on core 1
+#define NET_TASK_STACK 10240  // TLS handshakes need a deep stack
+#define NET_TASK_PRIORITY 1
+#define NET_QUEUE_LEN 8
+
+// Upstream rate limits (token bucket per provider, see net_worker.cpp)
+#define FINNHUB_PER_MINUTE 55       // Free tier allows 60/min; keep some headroom
+#define FINNHUB_BURST 10
+#define OPEN_METEO_PER_MINUTE 400   // Free tier allows 600/min
+#define OPEN_METEO_BURST 20
+#define PREFETCH_LEAD_MS 10000      // Fetch the next rotation page this early
+
+// HTTPS connection pool (see utils.cpp)
+#define HTTPS_POOL_SIZE 3        // finnhub.io, geocoding-api + api.open-meteo.com
+#define HTTPS_POOL_MAX_OPEN 2    // Each open TLS session holds ~40 KB of heap
+#define HTTPS_POOL_IDLE_MS 50000 // Drop sockets the server has likely closed
+#define HTTPS_STREAM_TIMEOUT_MS 5000 // Max wait for the next byte of a streamed body
+
+// Geocode cache (see geocode_cache.cpp)
+#define GEOCODE_LRU_SIZE 8           // Entries kept in RAM
+#define GEOCODE_FILE_MAX 32          // Entries kept in /geocode.json
+#define GEOCODE_FILE_DOC_SIZE 6144   // JSON doc used to rewrite the file
+
+// Quote & forecast caches (see data_cache.h)
+#define QUOTE_TTL_MS (5UL * 60 * 1000)     // Re-fetch a quote at most every 5 min
+#define FORECAST_TTL_MS (60UL * 60 * 1000) // Open-Meteo updates hourly
+#define QUOTE_CACHE_SIZE 32
+#define FORECAST_CACHE_SIZE 16
+#define FORECAST_DOC_SIZE 3072 // One location: daily + 48 hourly points x 2 series
+#define WEATHER_BATCH_SIZE 8   // Rotation locations per batched forecast request
+
+// Intraday price history (see price_history.cpp)
+#define PRICE_HISTORY_BUDGET_BYTES 16384 // Shared by every ticker's ring
+#define PRICE_HISTORY_MAX_SAMPLES 480    // Per ticker, however short the list
+#define SPARK_COLUMNS 96                 // Sparkline columns, 2 px each
+
+// Finnhub trade stream (see trade_stream.cpp)
+#define TRADE_STREAM_DEFAULT_URL "wss://ws.finnhub.io"
+#define TRADE_STREAM_STACK 8192
+#define TRADE_STREAM_DOC_SIZE 2048      // One batch of trades, filtered
+#define TRADE_STREAM_RECONNECT_MS 5000
+#define LIVE_PRICE_REDRAW_MS 2000       // Max stock page refresh rate from trades
+
 // =========================================================================
 // SCREEN & UI
 // =========================================================================
@@ -35,9 +114,40 @@ extern const char* PARAM_INPUT; // This is now unused, but we'll leave it
 #define FOOTER_H 24
 #define USE_FREE_FONTS 1
 
+// Indexed frame renderer (see render.h): 320x240 at 4 bits = 37.5 KB
+#define RENDER_TILE_W 32  // Dirty tracking granularity (even: two pixels share a byte)
+#define RENDER_TILE_H 8   // ...and rows per push buffer: two of 320x8 16-bit = 10 KB
+#define TRANSITION_MS 300 // Page slide / fade length
+#define TRANSITION_FPS 20 // Target; late frames are dropped to stay on time
+#define ICON_CACHE_SIZE 12 // Rasterized weather icons (~0.5-1.5 KB each)
+#define SCREEN_MIRROR_INTERVAL_MS 250 // Fastest WebSocket update rate of /screen_ws
+
+// Watchlist grid page (see watchlist.h)
+#define WATCHLIST_COLS 3 // 3 x 3 cells of 106 x 62 px
+#define WATCHLIST_ROWS 3
+#define WATCHLIST_QUEUE_RESERVE 2 // Net queue slots its quote fetches leave for the other pages
+
+// Ticker tape page (see ticker_tape.h)
+#define TAPE_Y 104          // Top row of the scrolling strip (a tile row boundary)
+#define TAPE_H 32           // Rows scrolled in the frame
+#define TAPE_FPS 30         // Steps per second
+#define TAPE_SPEED_PX_S 60  // Scroll speed
+#define TAPE_GAP 28         // Between two symbols, with a dot in the middle
+
+// Page layouts (see layout.h)
+#define LAYOUT_FILE "/layout.json"
+#define LAYOUT_MAX_BYTES 8192  // Largest accepted upload
+#define LAYOUT_DOC_SIZE 16384  // Parsed layout, every page
+
+// Render profiler (see profiler.h); 1 = time every drawing call, adds /render_profile
+#ifndef RENDER_PROFILER
+#define RENDER_PROFILER 0
+#endif
+
 // =========================================================================
 // WEB HTML & CERTIFICATES (Declarations ONLY)
 // =========================================================================
 extern const char index_html[] PROGMEM;
+extern const char default_layout_json[] PROGMEM;
 extern const char test_root_ca[] PROGMEM;
 extern const char open_meteo_ca[] PROGMEM;
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+// =========================================================================
+// TTL DATA CACHE
+// A small keyed cache that sits in front of the fetch functions. Entries
+// younger than the TTL are served without touching the network; older
+// ones are still served (stale-while-revalidate) while a refresh runs,
+// and are kept if that refresh fails.
+//
+// Not thread safe: only use it from the loop() task (fetch completions
+// are dispatched there by netWorkerDispatch()).
+// =========================================================================
+
+template <typename T>
+class TtlCache {
+public:
+  struct Entry {
+    String key;
+    T value;
+    unsigned long fetchedAt = 0; // millis() of the last successful fetch
+    unsigned long lastUsed = 0;  // For LRU eviction
+    bool refreshing = false;     // A fetch is in flight for this key
+    bool lastFetchFailed = false;
+  };
+
+  TtlCache(unsigned long ttlMs, size_t capacity) : ttlMs(ttlMs), capacity(capacity) {}
+
+  // Returns nullptr on a miss. The pointer is valid until the next put().
+  Entry* get(const String& key) {
+    for (Entry& entry : entries) {
+      if (entry.key == key) {
+        entry.lastUsed = millis();
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  bool isFresh(const Entry& entry) const {
+    return millis() - entry.fetchedAt < ttlMs;
+  }
+
+  unsigned long ageMs(const Entry& entry) const {
+    return millis() - entry.fetchedAt;
+  }
+
+  // Stores a successful fetch, evicting the least recently used entry if full
+  void put(const String& key, const T& value) {
+    Entry* entry = get(key);
+    if (entry == nullptr) {
+      if (entries.size() >= capacity) evictLru();
+      entries.push_back(Entry());
+      entry = &entries.back();
+      entry->key = key;
+      entry->lastUsed = millis();
+    }
+    entry->value = value;
+    entry->fetchedAt = millis();
+    entry->refreshing = false;
+    entry->lastFetchFailed = false;
+  }
+
+  // A refresh failed: keep serving the old value
+  void markFailed(const String& key) {
+    Entry* entry = get(key);
+    if (entry != nullptr) {
+      entry->refreshing = false;
+      entry->lastFetchFailed = true;
+    }
+  }
+
+  // Counters for the status endpoint / serial log
+  unsigned long hits = 0;   // Served fresh, no upstream call
+  unsigned long stale = 0;  // Served stale while revalidating
+  unsigned long misses = 0; // Nothing to show, had to wait for upstream
+
+private:
+  unsigned long ttlMs;
+  size_t capacity;
+  std::vector<Entry> entries;
+
+  void evictLru() {
+    size_t oldest = 0;
+    for (size_t i = 1; i < entries.size(); i++) {
+      if (entries[i].lastUsed < entries[oldest].lastUsed) oldest = i;
+    }
+    entries.erase(entries.begin() + oldest);
+  }
+};
@@ -1,6 +1,8 @@
 #include "drawing.h"
 #include "config.h"     // For screen dimensions, fonts
 #include "globals.h"    // For tft, colors, currentSsid
+#include "render.h"     // For gfx(), renderTransitionNext()
+#include "theme.h"      // For themeApply
 #include "Free_Fonts.h"
 #include <WiFi.h>       // For WiFi.localIP()
 
@@ -36,25 +38,11 @@ uint16_t color_from_hex(uint32_t hex) {
 // =====================================================
 // --- INITIALIZE COLORS ---
 // Call this in setup() before drawing anything!
-// Using "Catppuccin Mocha" palette for modern look
+// Sets the CAT_* colors from the theme in uiTheme
+// ("Catppuccin Mocha" until the settings are loaded)
 // =====================================================
 void init_colors() {
-  // Base UI
-  CAT_BG      = color_from_hex(0x1E1E2E); // Base
-  CAT_TEXT    = color_from_hex(0xCDD6F4); // Text
-  CAT_MUTED   = color_from_hex(0x6C7086); // Overlay0
-  CAT_ACCENT  = color_from_hex(0xCBA6F7); // Mauve
-  CAT_SURFACE = color_from_hex(0x181825); // Mantle (Darker header)
-
-  // Functional Colors
-  CAT_GREEN   = color_from_hex(0xA6E3A1); // Green
-  CAT_RED     = color_from_hex(0xF38BA8); // Red
-  
-  // New Colors for Weather/Stocks
-  CAT_YELLOW  = color_from_hex(0xF9E2AF); // Yellow
-  CAT_BLUE    = color_from_hex(0x89B4FA); // Blue
-  CAT_WHITE   = color_from_hex(0xFFFFFF); // Pure White
-  CAT_GREY    = color_from_hex(0x9399B2); // Overlay1 (Lighter than muted)
+  themeApply(uiTheme); // From theme.cpp
 }
 
 // =====================================================
@@ -63,84 +51,202 @@ void init_colors() {
 
 // Draws the top header bar with title and network status
 void drawHeader(String title) {
-  tft.fillRect(0, 0, SCREEN_WIDTH, HEADER_H, CAT_SURFACE);
-  tft.drawLine(0, HEADER_H, SCREEN_WIDTH, HEADER_H, CAT_ACCENT);
+  gfx().fillRect(0, 0, SCREEN_WIDTH, HEADER_H, CAT_SURFACE);
+  gfx().drawLine(0, HEADER_H, SCREEN_WIDTH, HEADER_H, CAT_ACCENT);
 
-  tft.setTextColor(CAT_TEXT, CAT_SURFACE);
+  gfx().setTextColor(CAT_TEXT, CAT_SURFACE);
 #if USE_FREE_FONTS
-  tft.setFreeFont(FSS9);
-  tft.setTextSize(1);
+  gfx().setFreeFont(FSS9);
+  gfx().setTextSize(1);
 #else
-  tft.setTextFont(1);
-  tft.setTextSize(2);
+  gfx().setTextFont(1);
+  gfx().setTextSize(2);
 #endif
 
-  tft.setTextDatum(ML_DATUM);
-  tft.drawString(" " + title, 8, HEADER_H / 2);
+  gfx().setTextDatum(ML_DATUM);
+  gfx().drawString(" " + title, 8, HEADER_H / 2);
 
   // Draw Network Info on the right
-  tft.setTextColor(CAT_MUTED, CAT_SURFACE);
-  tft.setTextDatum(MR_DATUM);
+  gfx().setTextColor(CAT_MUTED, CAT_SURFACE);
+  gfx().setTextDatum(MR_DATUM);
   String networkInfo = currentSsid + " (" + WiFi.localIP().toString() + ")";
-  tft.drawString(networkInfo, SCREEN_WIDTH - 8, HEADER_H / 2);
+  gfx().drawString(networkInfo, SCREEN_WIDTH - 8, HEADER_H / 2);
 }
 
 // Draws the bottom footer bar with page toggle hint
 void drawFooter(Page page) {
-  tft.fillRect(0, SCREEN_HEIGHT - FOOTER_H, SCREEN_WIDTH, FOOTER_H, CAT_SURFACE);
-  tft.drawLine(0, SCREEN_HEIGHT - FOOTER_H, SCREEN_WIDTH, SCREEN_HEIGHT - FOOTER_H, CAT_ACCENT);
+  gfx().fillRect(0, SCREEN_HEIGHT - FOOTER_H, SCREEN_WIDTH, FOOTER_H, CAT_SURFACE);
+  gfx().drawLine(0, SCREEN_HEIGHT - FOOTER_H, SCREEN_WIDTH, SCREEN_HEIGHT - FOOTER_H, CAT_ACCENT);
 
-  tft.setTextColor(CAT_MUTED, CAT_SURFACE);
+  gfx().setTextColor(CAT_MUTED, CAT_SURFACE);
 #if USE_FREE_FONTS
-  tft.setFreeFont(FSS9);
-  tft.setTextSize(1);
+  gfx().setFreeFont(FSS9);
+  gfx().setTextSize(1);
 #else
-  tft.setTextFont(1);
-  tft.setTextSize(2);
+  gfx().setTextFont(1);
+  gfx().setTextSize(2);
 #endif
 
-  tft.setTextDatum(MC_DATUM);
+  gfx().setTextDatum(MC_DATUM);
 
-  String footer_text = "Touch for Weather";
-  if (page == PAGE_WEATHER) {
-    footer_text = "Touch for Stocks";
+  // Names the page a tap leads to (the optional pages may be skipped)
+  String footer_text = "Touch for Stocks";
+  switch (nextPage(page)) {
+    case PAGE_WEATHER: footer_text = "Touch for Weather"; break;
+    case PAGE_HOURLY: footer_text = "Touch for Hourly"; break;
+    case PAGE_WATCHLIST: footer_text = "Touch for Watchlist"; break;
+    case PAGE_TAPE: footer_text = "Touch for Tape"; break;
+    default: break;
   }
+  if (rotationPaused) footer_text = "Paused - hold to resume";
   
-  tft.drawString(footer_text, SCREEN_WIDTH / 2, SCREEN_HEIGHT - (FOOTER_H / 2));
+  gfx().drawString(footer_text, SCREEN_WIDTH / 2, SCREEN_HEIGHT - (FOOTER_H / 2));
 }
 
 // Redraws just the network info part of the header after a reconnect
 void updateHeaderIP() {
   // Clear the right side of the header
-  tft.fillRect(SCREEN_WIDTH / 2, 0, SCREEN_WIDTH / 2, HEADER_H, CAT_SURFACE);
-  tft.drawLine(0, HEADER_H, SCREEN_WIDTH, HEADER_H, CAT_ACCENT); // Redraw line segment
+  gfx().fillRect(SCREEN_WIDTH / 2, 0, SCREEN_WIDTH / 2, HEADER_H, CAT_SURFACE);
+  gfx().drawLine(0, HEADER_H, SCREEN_WIDTH, HEADER_H, CAT_ACCENT); // Redraw line segment
 
-  tft.setTextColor(CAT_MUTED, CAT_SURFACE);
+  gfx().setTextColor(CAT_MUTED, CAT_SURFACE);
 #if USE_FREE_FONTS
-  tft.setFreeFont(FSS9);
-  tft.setTextSize(1);
+  gfx().setFreeFont(FSS9);
+  gfx().setTextSize(1);
 #else
-  tft.setTextFont(1);
-  tft.setTextSize(2);
+  gfx().setTextFont(1);
+  gfx().setTextSize(2);
 #endif
-  tft.setTextDatum(MR_DATUM);
+  gfx().setTextDatum(MR_DATUM);
   String networkInfo = currentSsid + " (" + WiFi.localIP().toString() + ")";
-  tft.drawString(networkInfo, SCREEN_WIDTH - 8, HEADER_H / 2);
+  gfx().drawString(networkInfo, SCREEN_WIDTH - 8, HEADER_H / 2);
 }
 
 // Draws a large status message in the center of the screen
 void drawStatusMessage(const String& msg, uint16_t color) {
-  tft.fillRect(0, HEADER_H + 1, SCREEN_WIDTH, SCREEN_HEIGHT - HEADER_H - FOOTER_H - 1, CAT_BG);
-  tft.setTextColor(color, CAT_BG);
-  tft.setTextDatum(MC_DATUM);
+  gfx().fillRect(0, HEADER_H + 1, SCREEN_WIDTH, SCREEN_HEIGHT - HEADER_H - FOOTER_H - 1, CAT_BG);
+  gfx().setTextColor(color, CAT_BG);
+  gfx().setTextDatum(MC_DATUM);
 
 #if USE_FREE_FONTS
-  tft.setFreeFont(FSS12);
-  tft.setTextSize(1);
+  gfx().setFreeFont(FSS12);
+  gfx().setTextSize(1);
 #else
-  tft.setTextFont(4);
-  tft.setTextSize(1);
+  gfx().setTextFont(4);
+  gfx().setTextSize(1);
 #endif
   
-  tft.drawString(msg, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
-}
\ No newline at end of file
+  gfx().drawString(msg, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+}
+
+// --- Status page layout: header, footer and one message ---
+enum { STATUS_HEADER, STATUS_FOOTER, STATUS_MESSAGE, STATUS_WIDGETS };
+static const WidgetSpec statusLayout[STATUS_WIDGETS] = {
+  {WIDGET_CUSTOM, 0, 0, SCREEN_WIDTH, HEADER_H + 1, 0, 0, TL_DATUM, FONT_SMALL, 0},
+  {WIDGET_CUSTOM, 0, SCREEN_HEIGHT - FOOTER_H, SCREEN_WIDTH, FOOTER_H, 0, 0, TL_DATUM, FONT_SMALL, 0},
+  {WIDGET_LABEL, 0, HEADER_H + 1, SCREEN_WIDTH, SCREEN_HEIGHT - HEADER_H - FOOTER_H - 1, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, MC_DATUM, FONT_MEDIUM, 0},
+};
+
+// Draws a whole page that is just a status message (e.g. "Fetching quote...")
+void drawStatusPage(const String& title, Page page, const String& msg, uint16_t color) {
+  static WidgetPage status(statusLayout, STATUS_WIDGETS);
+  setHeaderWidget(status[STATUS_HEADER], title);
+  setFooterWidget(status[STATUS_FOOTER], page);
+  status[STATUS_MESSAGE].text = msg;
+  status[STATUS_MESSAGE].color = color;
+  renderTransitionNext(TRANSITION_NONE); // Only animate into a page that has its data
+  status.render();
+}
+
+// Formats how old the data on screen is ("now", "4m ago", "2h ago")
+String dataAgeText(unsigned long ageMs) {
+  unsigned long minutes = ageMs / 60000;
+  if (minutes >= 60) return String(minutes / 60) + "h ago";
+  if (minutes > 0) return String(minutes) + "m ago";
+  return "now";
+}
+
+// Draws the data age in the right-hand corner of the footer
+void drawDataAge(unsigned long ageMs, uint16_t color) {
+  gfx().setTextColor(color, CAT_SURFACE);
+#if USE_FREE_FONTS
+  gfx().setFreeFont(FSS9);
+  gfx().setTextSize(1);
+#else
+  gfx().setTextFont(1);
+  gfx().setTextSize(1);
+#endif
+  gfx().setTextDatum(MR_DATUM);
+  gfx().drawString(dataAgeText(ageMs), SCREEN_WIDTH - 8, SCREEN_HEIGHT - (FOOTER_H / 2));
+}
+
+// Draws a low/high range bar with a dot at `current`, the low and high
+// values printed either side of it
+void drawRangeBar(int barX, int barY, int barW, float low, float high, float current, uint16_t color) {
+  int barH = 6; // Thickness of the bar
+
+  // 1. Draw Labels (Low on left, High on right)
+  gfx().setTextColor(CAT_MUTED, CAT_BG);
+#if USE_FREE_FONTS
+  gfx().setFreeFont(FSS9);
+#else
+  gfx().setTextFont(2);
+#endif
+  gfx().setTextSize(1);
+
+  // Draw Low Price (Right-aligned to the start of the bar)
+  gfx().setTextDatum(MR_DATUM);
+  gfx().drawString(String(low, 2), barX - 8, barY + 3);
+
+  // Draw High Price (Left-aligned to the end of the bar)
+  gfx().setTextDatum(ML_DATUM);
+  gfx().drawString(String(high, 2), barX + barW + 8, barY + 3);
+
+  // 2. Draw the Background Bar (Pill shape)
+  gfx().fillRoundRect(barX, barY, barW, barH, 3, CAT_MUTED);
+
+  // 3. Calculate Position of the dot
+  if (high == low) high += 0.01; // Prevent Div/0
+  float percent = (current - low) / (high - low);
+
+  // Clamp values to ensure dot stays inside the bar
+  if (percent < 0.0) percent = 0.0;
+  if (percent > 1.0) percent = 1.0;
+
+  int indicatorX = barX + (int)(percent * barW);
+
+  // 4. Draw Current Price Indicator
+  // The "CAT_BG" outline creates a clean separation "cutout" effect
+  gfx().fillCircle(indicatorX, barY + 3, 6, color);
+  gfx().drawCircle(indicatorX, barY + 3, 6, CAT_BG);
+}
+
+// =====================================================
+// --- PAGE CHROME AS WIDGETS ---
+// Hashed on what they show, so a partial update only redraws them when
+// the title, the network or the data age actually changed.
+// =====================================================
+
+void setHeaderWidget(WidgetContent& widget, const String& title) {
+  String networkInfo = currentSsid + " (" + WiFi.localIP().toString() + ")";
+  widget.hash = widgetHash(networkInfo, widgetHash(title));
+  widget.draw = [title]() { drawHeader(title); };
+}
+
+void setFooterWidget(WidgetContent& widget, Page page) {
+  // The hint names the next page, which depends on the optional pages,
+  // or says the rotation is paused
+  Page next = nextPage(page);
+  widget.hash = widgetHash(&rotationPaused, sizeof(rotationPaused), widgetHash(&next, sizeof(next), widgetHash(&page, sizeof(page))));
+  widget.draw = [page]() { drawFooter(page); };
+}
+
+void setDataAgeWidget(WidgetContent& widget, long ageMs, uint16_t color) {
+  if (ageMs < 0) {
+    widget.hash = 0;
+    widget.draw = nullptr;
+    return;
+  }
+  widget.hash = widgetHashColor(color, widgetHash(dataAgeText(ageMs)));
+  widget.draw = [ageMs, color]() { drawDataAge(ageMs, color); };
+}
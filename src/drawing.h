@@ -1,5 +1,6 @@
 #pragma once
 #include "globals.h"
+#include "widgets.h"
 
 // Function prototypes
 uint16_t color_from_hex(uint32_t hex);
@@ -8,4 +9,14 @@ void drawHeader(String title);
 void updateHeaderIP(); // <-- NEW FUNCTION
 void drawFooter(Page page);
 void drawStatusMessage(const String& msg, uint16_t color);
-void drawTerminalFrame();
\ No newline at end of file
+void drawStatusPage(const String& title, Page page, const String& msg, uint16_t color);
+void drawTerminalFrame();
+String dataAgeText(unsigned long ageMs);
+void drawDataAge(unsigned long ageMs, uint16_t color);
+void drawRangeBar(int barX, int barY, int barW, float low, float high, float current, uint16_t color);
+
+// Header, footer and data age as custom widgets of a WidgetPage.
+// A negative ageMs leaves the age blank.
+void setHeaderWidget(WidgetContent& widget, const String& title);
+void setFooterWidget(WidgetContent& widget, Page page);
+void setDataAgeWidget(WidgetContent& widget, long ageMs, uint16_t color);
@@ -0,0 +1,195 @@
+#include "geocode_cache.h"
+#include "config.h"      // For open_meteo_ca, GEOCODE_* sizes
+#include "persistence.h" // For readFile, writeFile
+#include "utils.h"       // For HTTPSRequestJson
+#include "net_worker.h"  // For netSchedule
+#include <ArduinoJson.h>
+#include <vector>
+
+#define GEOCODE_FILE "/geocode.json"
+
+struct GeoEntry {
+  String key; // Normalized location
+  GeoLocation loc;
+};
+
+// Most recently used first. Guarded by cacheLock, as is the file.
+static std::vector<GeoEntry> lru;
+static SemaphoreHandle_t cacheLock = nullptr;
+
+// --- HELPER: JSON Filter for the Geocoding Endpoint ---
+static const JsonDocument& geocodeFilter() {
+  static StaticJsonDocument<192> filter;
+  if (filter.isNull()) {
+    for (const char* key : {"latitude", "longitude", "name", "timezone"}) {
+      filter["results"][0][key] = true; // [0] applies to every element
+    }
+  }
+  return filter;
+}
+
+// --- HELPER: Move/insert an entry at the front of the LRU ---
+static void touchLru(const String& key, const GeoLocation& loc) {
+  for (auto it = lru.begin(); it != lru.end(); ++it) {
+    if (it->key == key) {
+      lru.erase(it);
+      break;
+    }
+  }
+  lru.insert(lru.begin(), GeoEntry{key, loc});
+  if (lru.size() > GEOCODE_LRU_SIZE) lru.pop_back();
+}
+
+// --- HELPER: Load the whole flash cache (small: one entry per location) ---
+static void readCacheFile(JsonDocument& doc) {
+  String data = readFile(GEOCODE_FILE);
+  if (data.length() == 0 || deserializeJson(doc, data) != DeserializationError::Ok || !doc.is<JsonObject>()) {
+    doc.to<JsonObject>();
+  }
+}
+
+static void writeCacheFile(const JsonDocument& doc) {
+  String json;
+  serializeJson(doc, json);
+  writeFile(GEOCODE_FILE, json);
+}
+
+// --- Public Functions ---
+
+void initGeocodeCache() {
+  if (cacheLock == nullptr) cacheLock = xSemaphoreCreateMutex();
+}
+
+String normalizeLocation(const String& location) {
+  String key;
+  bool pendingSpace = false;
+  for (unsigned int i = 0; i < location.length(); i++) {
+    char c = location[i];
+    if (c == ' ' || c == '\t') {
+      pendingSpace = key.length() > 0;
+      continue;
+    }
+    if (c == ',') {
+      pendingSpace = false; // "York , US" -> "york,us"
+    } else if (pendingSpace && !key.endsWith(",")) {
+      key += ' ';
+    }
+    pendingSpace = false;
+    key += (char)tolower(c);
+  }
+  return key;
+}
+
+bool geocodeLookup(const String& location, GeoLocation& out) {
+  String key = normalizeLocation(location);
+  bool found = false;
+
+  xSemaphoreTake(cacheLock, portMAX_DELAY);
+  for (const GeoEntry& entry : lru) {
+    if (entry.key == key) {
+      out = entry.loc;
+      found = true;
+      break;
+    }
+  }
+
+  if (!found) {
+    DynamicJsonDocument doc(GEOCODE_FILE_DOC_SIZE);
+    readCacheFile(doc);
+    JsonObject entry = doc[key];
+    if (!entry.isNull()) {
+      out.lat = entry["lat"].as<float>();
+      out.lon = entry["lon"].as<float>();
+      out.name = entry["name"].as<String>();
+      out.timezone = entry["tz"].as<String>();
+      found = true;
+    }
+  }
+
+  if (found) touchLru(key, out);
+  xSemaphoreGive(cacheLock);
+  return found;
+}
+
+void geocodeStore(const String& location, const GeoLocation& loc) {
+  String key = normalizeLocation(location);
+
+  xSemaphoreTake(cacheLock, portMAX_DELAY);
+  touchLru(key, loc);
+
+  DynamicJsonDocument doc(GEOCODE_FILE_DOC_SIZE);
+  readCacheFile(doc);
+  JsonObject root = doc.as<JsonObject>();
+  root.remove(key);
+  // Keep the file bounded: drop the oldest entries (first in the object)
+  while (root.size() >= GEOCODE_FILE_MAX) {
+    root.remove(root.begin());
+  }
+  JsonObject entry = root.createNestedObject(key);
+  entry["lat"] = loc.lat;
+  entry["lon"] = loc.lon;
+  entry["name"] = loc.name;
+  entry["tz"] = loc.timezone;
+  writeCacheFile(doc);
+  xSemaphoreGive(cacheLock);
+}
+
+void geocodeInvalidate(const String& location) {
+  String key = normalizeLocation(location);
+
+  xSemaphoreTake(cacheLock, portMAX_DELAY);
+  for (auto it = lru.begin(); it != lru.end(); ++it) {
+    if (it->key == key) {
+      lru.erase(it);
+      break;
+    }
+  }
+
+  DynamicJsonDocument doc(GEOCODE_FILE_DOC_SIZE);
+  readCacheFile(doc);
+  if (doc.containsKey(key)) {
+    doc.remove(key);
+    writeCacheFile(doc);
+  }
+  xSemaphoreGive(cacheLock);
+  Serial.printf("Geocode cache: forgot %s\n", key.c_str());
+}
+
+bool resolveLocation(const String& location, GeoLocation& out) {
+  if (geocodeLookup(location, out)) {
+    Serial.printf("Geocode cache hit: %s\n", location.c_str());
+    return true;
+  }
+
+  String locNameFormatted = location;
+  locNameFormatted.trim();
+  if (locNameFormatted.indexOf(',') != -1) locNameFormatted.replace(", ", "&");
+  locNameFormatted.replace(" ", "+");
+
+  String geoUrl = "https://geocoding-api.open-meteo.com/v1/search?name=" + locNameFormatted + "&count=1";
+
+  StaticJsonDocument<384> geoDoc;
+  DeserializationError geoError = HTTPSRequestJson(geoUrl, open_meteo_ca, geoDoc, geocodeFilter());
+
+  if (geoError || !geoDoc.containsKey("results") || geoDoc["results"].size() == 0) {
+    return false;
+  }
+
+  JsonObject result = geoDoc["results"][0];
+  out.lat = result["latitude"].as<float>();
+  out.lon = result["longitude"].as<float>();
+  out.name = result["name"].as<String>();
+  out.timezone = result["timezone"] | "GMT";
+
+  geocodeStore(location, out);
+  return true;
+}
+
+void prefetchLocation(const String& location) {
+  // Nobody is waiting on it, so it yields to everything else
+  netSchedule<GeoLocation>("geocode:" + normalizeLocation(location), PROVIDER_OPEN_METEO, NET_PRIO_BACKGROUND,
+    [location](GeoLocation& loc) {
+      return resolveLocation(location, loc);
+    },
+    nullptr);
+}
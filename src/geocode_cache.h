@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// GEOCODE CACHE
+// Location name -> coordinates never changes, so each answer from the
+// Open-Meteo geocoding API is kept in a small in-RAM LRU backed by
+// /geocode.json on LittleFS. Keys are normalized location strings.
+// =========================================================================
+
+struct GeoLocation {
+  float lat = 0.0;
+  float lon = 0.0;
+  String name;     // Resolved name, e.g. "London"
+  String timezone; // IANA zone, e.g. "Europe/London"
+};
+
+// Creates the lock. Call once after LittleFS is mounted.
+void initGeocodeCache();
+
+// "  New  York, US " -> "new york,us"
+String normalizeLocation(const String& location);
+
+// RAM first, then flash. Safe to call from any task.
+bool geocodeLookup(const String& location, GeoLocation& out);
+
+// Adds/refreshes an entry in RAM and on flash
+void geocodeStore(const String& location, const GeoLocation& loc);
+
+// Forgets a location (RAM and flash)
+void geocodeInvalidate(const String& location);
+
+// Cache lookup, falling back to the geocoding API (and caching the
+// answer). Blocking: only call this from the network worker.
+bool resolveLocation(const String& location, GeoLocation& out);
+
+// Queues a background resolveLocation() so the first weather page for a
+// newly added location only needs the forecast request.
+void prefetchLocation(const String& location);
@@ -10,7 +10,8 @@
 // ==========
 // Enum Definitions
 // ==========
-enum Page { PAGE_STOCKS, PAGE_WEATHER };
+enum Page { PAGE_STOCKS, PAGE_WEATHER, PAGE_HOURLY, PAGE_WATCHLIST, PAGE_TAPE }; // Rotation / touch order
+Page nextPage(Page page); // Skips the optional pages that are off (main.cpp)
 
 // ==========
 // Hardware Objects
@@ -24,11 +25,8 @@ extern AsyncWebServer server;
 // ==========
 extern Page currentPage;
 extern bool needsRedraw;
-extern String lastTicker; // For one-off fetch
-extern String lastWeatherLocation; // For one-off fetch
-
-extern bool inputUpdated; // One-off stock fetch
-extern bool weatherInputUpdated; // One-off weather fetch
+extern String lastTicker; // Ticker on the stocks page
+extern String lastWeatherLocation; // Location on the weather pages
 extern char upperString[100];
 
 // ==========
@@ -45,6 +43,25 @@ extern std::vector<String> weatherLocationList;
 extern int currentStockIndex;
 extern int currentLocIndex;
 extern unsigned long rotationInterval;
+extern bool hourlyEnabled;    // Hourly forecast page after the weather page
+extern bool watchlistEnabled; // Watchlist grid page after the weather pages
+extern int watchlistSort;     // WatchlistSort (see watchlist.h)
+extern bool tapeEnabled;      // Ticker tape page after that
+extern bool rotationPaused;   // Long press toggles it; not saved
+
+// ==========
+// Live Prices (Finnhub WebSocket)
+// ==========
+extern bool tradeStreamEnabled;
+extern String tradeStreamUrl; // wss://ws.finnhub.io, or ws://<pc>:8765 for the replay tool
+
+// ==========
+// Display
+// ==========
+extern int uiTheme;        // Theme (see theme.h)
+extern int nightMode;      // NightMode (see power.h)
+extern int nightStartHour; // Night profile hours, device time (UTC)
+extern int nightEndHour;   // ...up to, not including
 
 // ==========
 // Global Colors
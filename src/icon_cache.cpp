@@ -0,0 +1,133 @@
+#include "icon_cache.h"
+#include "globals.h"    // For tft, CAT_BG
+#include "config.h"     // For ICON_CACHE_SIZE
+#include "render.h"     // For gfx()
+#include "theme.h"      // For themeSlotOf, themeColor
+
+static std::vector<RleIcon> icons;
+static IconCacheStats stats;
+
+// --- HELPER: Palette index of a colour's slot, adding it if there is room (-1 = full) ---
+static int paletteIndex(RleIcon& icon, uint8_t& used, uint16_t color) {
+  uint8_t slot = themeSlotOf(color);
+  for (uint8_t i = 1; i <= used; i++) {
+    if (icon.slots[i] == slot) return i;
+  }
+  if (used == ICON_PALETTE_SIZE) return -1;
+  icon.slots[++used] = slot;
+  return used;
+}
+
+// --- HELPER: Paint into a scratch sprite and run-length encode the result ---
+static bool rasterize(RleIcon& icon, int reach, const IconPainter& paint) {
+  TFT_eSprite scratch(&tft);
+  scratch.setColorDepth(16);
+  int side = reach * 2 + 1;
+  if (scratch.createSprite(side, side) == nullptr) return false;
+  scratch.fillSprite(CAT_BG);
+  paint(scratch, reach, reach);
+
+  // 1. Trim to the painted pixels
+  int x0 = side, y0 = side, x1 = -1, y1 = -1;
+  for (int y = 0; y < side; y++) {
+    for (int x = 0; x < side; x++) {
+      if (scratch.readPixel(x, y) == CAT_BG) continue;
+      if (x < x0) x0 = x;
+      if (x > x1) x1 = x;
+      if (y < y0) y0 = y;
+      if (y > y1) y1 = y;
+    }
+  }
+  if (x1 < 0) { x0 = y0 = x1 = y1 = reach; } // Nothing painted
+
+  icon.left = x0 - reach;
+  icon.top = y0 - reach;
+  icon.width = x1 - x0 + 1;
+  icon.height = y1 - y0 + 1;
+  icon.runs.clear();
+
+  // 2. Encode each row as runs of up to 32 pixels of one palette index
+  uint8_t used = 0;
+  bool ok = true;
+  for (int y = y0; y <= y1 && ok; y++) {
+    int x = x0;
+    while (x <= x1) {
+      uint16_t color = scratch.readPixel(x, y);
+      int index = (color == CAT_BG) ? 0 : paletteIndex(icon, used, color);
+      if (index < 0) { ok = false; break; }
+      int len = 1;
+      while (x + len <= x1 && len < 32 && scratch.readPixel(x + len, y) == color) len++;
+      icon.runs.push_back((index << 5) | (len - 1));
+      x += len;
+    }
+  }
+
+  scratch.deleteSprite();
+  icon.runs.shrink_to_fit();
+  return ok;
+}
+
+const RleIcon* iconCacheGet(uint32_t key, int reach, const IconPainter& paint) {
+  for (RleIcon& icon : icons) {
+    if (icon.key == key) {
+      icon.lastUsed = millis();
+      stats.hits++;
+      return &icon;
+    }
+  }
+  stats.misses++;
+  if (icons.capacity() == 0) icons.reserve(ICON_CACHE_SIZE); // Returned pointers stay valid
+
+  // Miss: reuse the least recently used slot once the cache is full
+  RleIcon fresh;
+  fresh.key = key;
+  fresh.lastUsed = millis();
+  unsigned long started = micros();
+  if (!rasterize(fresh, reach, paint)) {
+    Serial.printf("[icons] Could not cache icon %08lx\n", (unsigned long)key);
+    return nullptr;
+  }
+  Serial.printf("[icons] Cached icon %08lx: %ux%u in %u bytes, %lu us\n", (unsigned long)key, fresh.width, fresh.height,
+                (unsigned)fresh.runs.size(), micros() - started);
+
+  stats.bytes += fresh.runs.size();
+  if (icons.size() < ICON_CACHE_SIZE) {
+    icons.push_back(std::move(fresh));
+    stats.entries = icons.size();
+    return &icons.back();
+  }
+  RleIcon* oldest = &icons[0];
+  for (RleIcon& icon : icons) {
+    if (icon.lastUsed < oldest->lastUsed) oldest = &icon;
+  }
+  stats.bytes -= oldest->runs.size();
+  *oldest = std::move(fresh);
+  return oldest;
+}
+
+void drawRleIcon(const RleIcon& icon, int cx, int cy) {
+  PROFILE_SCOPE(PROF_ICON, icon.width * icon.height);
+  Gfx target = gfx();
+  int x = 0, y = 0;
+  for (uint8_t run : icon.runs) {
+    int index = run >> 5;
+    int len = (run & 0x1F) + 1;
+    if (index != 0) target.drawFastHLine(cx + icon.left + x, cy + icon.top + y, len, themeColor((ThemeSlot)icon.slots[index]));
+    x += len;
+    if (x >= icon.width) {
+      x = 0;
+      y++;
+    }
+  }
+}
+
+void iconCacheClear() {
+  icons.clear();
+  stats.entries = 0;
+  stats.bytes = 0;
+}
+
+// Counters only, so the web server task can read them
+IconCacheStats getIconCacheStats() {
+  return stats;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "render.h" // For Gfx
+#include <functional>
+#include <vector>
+
+// =========================================================================
+// ICON CACHE
+// Icons built from fillCircle/drawLine primitives are painted once into
+// a scratch sprite, then kept as run-length rows of theme slots (see
+// theme.h), so they stay valid when the theme is switched. Drawing
+// a cached icon is one horizontal span per run (background pixels are
+// skipped), instead of re-rasterizing every circle on every frame.
+// Entries are keyed by the caller and evicted least recently used.
+// loop() task only.
+// =========================================================================
+
+#define ICON_PALETTE_SIZE 7 // Index 0 is transparent; 3 bits per run
+
+struct RleIcon {
+  uint32_t key = 0;
+  int16_t left = 0, top = 0;     // Offset of the first row/column from the icon centre
+  uint16_t width = 0, height = 0;
+  uint8_t slots[ICON_PALETTE_SIZE + 1] = {0}; // ThemeSlot of each palette index
+  std::vector<uint8_t> runs;     // Per byte: palette index << 5 | (length - 1); rows end on a run boundary
+  unsigned long lastUsed = 0;
+};
+
+// Paints the icon centred on (cx, cy) of `target`, over a CAT_BG background
+typedef std::function<void(Gfx target, int cx, int cy)> IconPainter;
+
+// Returns the cached icon for `key`, rasterizing it with `paint` into a
+// `reach` x `reach` box around the centre on a miss. nullptr if there
+// was no memory for the scratch sprite or the icon has too many colours.
+// Painters must only use theme colours (CAT_*, themeColor()).
+const RleIcon* iconCacheGet(uint32_t key, int reach, const IconPainter& paint);
+
+// Draws a cached icon centred on (cx, cy) into gfx()
+void drawRleIcon(const RleIcon& icon, int cx, int cy);
+
+// Drops every icon, e.g. after the colour palette changed
+void iconCacheClear();
+
+struct IconCacheStats {
+  unsigned long hits = 0;
+  unsigned long misses = 0;
+  size_t entries = 0;
+  size_t bytes = 0; // Encoded runs
+};
+IconCacheStats getIconCacheStats();
@@ -0,0 +1,484 @@
+#include "layout.h"
+#include "config.h"      // For default_layout_json, LAYOUT_*
+#include "drawing.h"     // For chrome widgets, color_from_hex
+#include "persistence.h" // For readFile
+#include "render.h"      // For gfx()
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+
+#define LAYOUT_PAGES 3 // Stocks, weather, hourly (the watchlist and tape are not laid out)
+
+static const char* pageKeys[LAYOUT_PAGES] = {"stocks", "weather", "hourly"};
+#define ON_STOCKS (1 << PAGE_STOCKS)
+#define ON_WEATHER (1 << PAGE_WEATHER)
+#define ON_HOURLY (1 << PAGE_HOURLY)
+#define ON_ANY (ON_STOCKS | ON_WEATHER | ON_HOURLY)
+
+// --- Names used in the JSON ---
+struct TypeName {
+  const char* name;
+  LayoutType type;
+  WidgetKind kind;
+  uint8_t pages;
+};
+static const TypeName typeNames[] = {
+  {"label", LAYOUT_LABEL, WIDGET_LABEL, ON_ANY},
+  {"value", LAYOUT_VALUE, WIDGET_VALUE, ON_ANY},
+  {"bar", LAYOUT_BAR, WIDGET_BAR, ON_ANY},
+  {"icon", LAYOUT_ICON, WIDGET_ICON, ON_ANY},
+  {"header", LAYOUT_HEADER, WIDGET_CUSTOM, ON_ANY},
+  {"footer", LAYOUT_FOOTER, WIDGET_CUSTOM, ON_ANY},
+  {"age", LAYOUT_AGE, WIDGET_CUSTOM, ON_ANY},
+  {"rule", LAYOUT_RULE, WIDGET_CUSTOM, ON_ANY},
+  {"sparkline", LAYOUT_SPARKLINE, WIDGET_CUSTOM, ON_STOCKS},
+  {"temp", LAYOUT_TEMP, WIDGET_CUSTOM, ON_WEATHER},
+  {"card", LAYOUT_CARD, WIDGET_CUSTOM, ON_WEATHER},
+  {"chart", LAYOUT_CHART, WIDGET_CUSTOM, ON_HOURLY},
+};
+
+struct FieldName {
+  const char* name; // Daily fields with the index taken out
+  LayoutField field;
+  uint8_t pages;
+  uint8_t decimals; // Unless the text asks for others
+};
+static const FieldName fieldNames[] = {
+  {"ticker", FIELD_TICKER, ON_STOCKS, 0},
+  {"quote.c", FIELD_QUOTE_C, ON_STOCKS, 2},
+  {"quote.h", FIELD_QUOTE_H, ON_STOCKS, 2},
+  {"quote.l", FIELD_QUOTE_L, ON_STOCKS, 2},
+  {"quote.o", FIELD_QUOTE_O, ON_STOCKS, 2},
+  {"quote.pc", FIELD_QUOTE_PC, ON_STOCKS, 2},
+  {"quote.d", FIELD_QUOTE_D, ON_STOCKS, 2},
+  {"quote.dp", FIELD_QUOTE_DP, ON_STOCKS, 2},
+  {"location", FIELD_LOCATION, ON_WEATHER | ON_HOURLY, 0},
+  {"current.temp", FIELD_CURRENT_TEMP, ON_WEATHER | ON_HOURLY, 0},
+  {"current.code", FIELD_CURRENT_CODE, ON_WEATHER | ON_HOURLY, 0},
+  {"current.desc", FIELD_CURRENT_DESC, ON_WEATHER | ON_HOURLY, 0},
+  {"forecast.daily[].max", FIELD_DAILY_MAX, ON_WEATHER | ON_HOURLY, 0},
+  {"forecast.daily[].min", FIELD_DAILY_MIN, ON_WEATHER | ON_HOURLY, 0},
+  {"forecast.daily[].code", FIELD_DAILY_CODE, ON_WEATHER | ON_HOURLY, 0},
+  {"forecast.daily[].day", FIELD_DAILY_DAY, ON_WEATHER | ON_HOURLY, 0},
+  {"forecast.daily[].desc", FIELD_DAILY_DESC, ON_WEATHER | ON_HOURLY, 0},
+};
+
+static const char* colorNames[] = {
+  "text", "muted", "accent", "surface", "green", "red", "yellow", "blue", "white", "grey", "change",
+};
+static const char* fontNames[] = {"small", "small_bold", "medium", "medium_bold", "large_bold"};
+static const char* datumNames[] = {"TL", "TC", "TR", "ML", "MC", "MR", "BL", "BC", "BR"}; // TL_DATUM..BR_DATUM
+
+// --- The compiled layouts (loop() task only) ---
+static PageLayout layouts[LAYOUT_PAGES];
+static uint32_t layoutVersion = 0;
+
+// --- HELPER: Index of `name` in a table of names, or -1 ---
+static int nameIndex(const char* const* names, size_t count, const char* name) {
+  for (size_t i = 0; i < count; i++) {
+    if (strcmp(names[i], name) == 0) return i;
+  }
+  return -1;
+}
+
+static bool allDigits(const String& text) {
+  if (text.length() == 0) return false;
+  for (unsigned int i = 0; i < text.length(); i++) {
+    if (!isDigit(text[i])) return false;
+  }
+  return true;
+}
+
+// =====================================================
+// --- COMPILING ---
+// =====================================================
+
+// --- HELPER: "forecast.daily[2].max:+1" -> field, day, sign, decimals ---
+static bool compileRef(String spec, Page page, LayoutRef& ref, String& error) {
+  String format;
+  int colon = spec.indexOf(':');
+  if (colon != -1) {
+    format = spec.substring(colon + 1);
+    spec = spec.substring(0, colon);
+  }
+
+  // The index is looked up as "[]"
+  String name = spec;
+  int open = spec.indexOf('[');
+  if (open != -1) {
+    int close = spec.indexOf(']', open);
+    String index = (close == -1) ? String() : spec.substring(open + 1, close);
+    if (!allDigits(index) || index.toInt() >= WEATHER_DAYS) {
+      error = "bad day index in '" + spec + "' (0-" + String(WEATHER_DAYS - 1) + ")";
+      return false;
+    }
+    ref.day = index.toInt();
+    name = spec.substring(0, open + 1) + spec.substring(close);
+  }
+
+  const FieldName* found = nullptr;
+  for (const FieldName& field : fieldNames) {
+    if (name == field.name) found = &field;
+  }
+  if (found == nullptr) {
+    error = "unknown field '" + spec + "'";
+    return false;
+  }
+  if (!(found->pages & (1 << page))) {
+    error = "'" + spec + "' is not on this page";
+    return false;
+  }
+  ref.field = found->field;
+  ref.decimals = found->decimals;
+
+  if (format.startsWith("+")) {
+    ref.sign = true;
+    format = format.substring(1);
+  }
+  if (format.length() > 0) {
+    if (!allDigits(format) || format.toInt() > 6) {
+      error = "bad format ':" + format + "' (want [+][0-6])";
+      return false;
+    }
+    ref.decimals = format.toInt();
+  }
+  return true;
+}
+
+// --- HELPER: Split "Open {quote.o}" into literal / field segments ---
+static bool compileText(const String& text, Page page, PageLayout& out, LayoutItem& item, String& error) {
+  item.firstSegment = out.segments.size();
+  String rest = text;
+  while (rest.length() > 0) {
+    LayoutSegment segment;
+    int open = rest.indexOf('{');
+    if (open == -1) {
+      segment.literal = rest;
+      out.segments.push_back(segment);
+      break;
+    }
+    int close = rest.indexOf('}', open);
+    if (close == -1) {
+      error = "unclosed '{' in \"" + text + "\"";
+      return false;
+    }
+    segment.literal = rest.substring(0, open);
+    if (!compileRef(rest.substring(open + 1, close), page, segment.ref, error)) return false;
+    out.segments.push_back(segment);
+    rest = rest.substring(close + 1);
+  }
+  item.segments = out.segments.size() - item.firstSegment;
+  return true;
+}
+
+// --- HELPER: A field given by name ("code": "current.code") ---
+static bool compileField(JsonObjectConst o, const char* key, Page page, LayoutRef& ref, String& error) {
+  const char* spec = o[key];
+  if (spec == nullptr) {
+    error = String("needs \"") + key + "\"";
+    return false;
+  }
+  return compileRef(spec, page, ref, error);
+}
+
+// --- HELPER: One item of a page ---
+static bool compileItem(JsonObjectConst o, Page page, PageLayout& out, String& error) {
+  const char* typeName = o["type"] | "";
+  const TypeName* type = nullptr;
+  for (const TypeName& t : typeNames) {
+    if (strcmp(t.name, typeName) == 0) type = &t;
+  }
+  if (type == nullptr) {
+    error = String("unknown type '") + typeName + "'";
+    return false;
+  }
+  if (!(type->pages & (1 << page))) {
+    error = String("a ") + typeName + " is not on this page";
+    return false;
+  }
+
+  // Bounds, which must be on screen: they become redraw rects
+  JsonArrayConst rect = o["rect"];
+  if (rect.size() != 4) {
+    error = "needs \"rect\": [x, y, w, h]";
+    return false;
+  }
+  WidgetSpec spec = {};
+  spec.kind = type->kind;
+  spec.x = rect[0];
+  spec.y = rect[1];
+  spec.w = rect[2];
+  spec.h = rect[3];
+  if (spec.x < 0 || spec.y < 0 || spec.w <= 0 || spec.h <= 0 || spec.x + spec.w > SCREEN_WIDTH ||
+      spec.y + spec.h > SCREEN_HEIGHT) {
+    error = "rect is off screen";
+    return false;
+  }
+  JsonArrayConst at = o["at"];
+  spec.ax = at.size() == 2 ? at[0].as<int16_t>() : spec.x;
+  spec.ay = at.size() == 2 ? at[1].as<int16_t>() : spec.y;
+  spec.size = o["size"] | 0;
+
+  int datum = nameIndex(datumNames, sizeof(datumNames) / sizeof(datumNames[0]), o["datum"] | "TL");
+  int font = nameIndex(fontNames, sizeof(fontNames) / sizeof(fontNames[0]), o["font"] | "small");
+  if (datum < 0 || font < 0) {
+    error = datum < 0 ? "unknown datum" : "unknown font";
+    return false;
+  }
+  spec.datum = datum;
+  spec.font = (FontId)font;
+
+  LayoutItem item = {};
+  item.type = type->type;
+  const char* color = o["color"] | "text";
+  if (color[0] == '#' && strlen(color) == 7) {
+    item.color = COLOR_RGB;
+    item.rgb = color_from_hex(strtoul(color + 1, nullptr, 16));
+  } else {
+    int index = nameIndex(colorNames, sizeof(colorNames) / sizeof(colorNames[0]), color);
+    if (index < 0) {
+      error = String("unknown color '") + color + "'";
+      return false;
+    }
+    item.color = (LayoutColor)index;
+  }
+
+  switch (item.type) {
+    case LAYOUT_LABEL:
+    case LAYOUT_VALUE:
+    case LAYOUT_HEADER:
+      if (!compileText(o["text"] | "", page, out, item, error)) return false;
+      break;
+    case LAYOUT_BAR:
+      if (!compileField(o, "lo", page, item.lo, error) || !compileField(o, "hi", page, item.hi, error) ||
+          !compileField(o, "pos", page, item.pos, error)) return false;
+      break;
+    case LAYOUT_ICON:
+      if (!compileField(o, "code", page, item.code, error)) return false;
+      break;
+    case LAYOUT_CARD:
+      item.day = o["day"] | 1;
+      if (item.day >= WEATHER_DAYS) {
+        error = "day must be 0-" + String(WEATHER_DAYS - 1);
+        return false;
+      }
+      break;
+    default:
+      break;
+  }
+
+  out.specs.push_back(spec);
+  out.items.push_back(item);
+  return true;
+}
+
+// --- HELPER: Every page `json` has; the others are left as they are ---
+static bool compileLayouts(const String& json, PageLayout* out, String& error) {
+  DynamicJsonDocument doc(LAYOUT_DOC_SIZE);
+  DeserializationError parsed = deserializeJson(doc, json);
+  if (parsed) {
+    error = String("JSON: ") + parsed.c_str();
+    return false;
+  }
+  if (!doc.is<JsonObject>()) {
+    error = "expected {\"stocks\": [...], ...}";
+    return false;
+  }
+
+  for (int page = 0; page < LAYOUT_PAGES; page++) {
+    JsonVariantConst items = doc[pageKeys[page]];
+    if (items.isNull()) continue;
+    if (!items.is<JsonArrayConst>()) {
+      error = String(pageKeys[page]) + ": expected an array";
+      return false;
+    }
+
+    PageLayout compiled;
+    size_t i = 0;
+    for (JsonObjectConst o : items.as<JsonArrayConst>()) {
+      if (!compileItem(o, (Page)page, compiled, error)) {
+        error = String(pageKeys[page]) + "[" + String(i) + "]: " + error;
+        return false;
+      }
+      i++;
+    }
+    out[page] = compiled;
+  }
+  return true;
+}
+
+void loadLayouts() {
+  PageLayout compiled[LAYOUT_PAGES];
+  String error;
+  if (!compileLayouts(default_layout_json, compiled, error)) {
+    Serial.printf("Built-in layout: %s\n", error.c_str());
+  }
+
+  // The file replaces the pages it has; a bad file is ignored whole
+  if (LittleFS.exists(LAYOUT_FILE)) {
+    PageLayout custom[LAYOUT_PAGES];
+    for (int page = 0; page < LAYOUT_PAGES; page++) custom[page] = compiled[page];
+    if (compileLayouts(readFile(LAYOUT_FILE), custom, error)) {
+      for (int page = 0; page < LAYOUT_PAGES; page++) compiled[page] = custom[page];
+      Serial.println("Loaded " LAYOUT_FILE);
+    } else {
+      Serial.printf("Ignoring %s: %s\n", LAYOUT_FILE, error.c_str());
+    }
+  }
+
+  layoutVersion++;
+  for (int page = 0; page < LAYOUT_PAGES; page++) {
+    layouts[page] = compiled[page];
+    layouts[page].version = layoutVersion;
+    Serial.printf("Layout %s: %u widgets\n", pageKeys[page], (unsigned)layouts[page].items.size());
+  }
+}
+
+bool layoutValidate(const String& json, String& error) {
+  PageLayout scratch[LAYOUT_PAGES];
+  return compileLayouts(json, scratch, error);
+}
+
+const PageLayout& layoutFor(Page page, WidgetPage& widgets, uint32_t& version) {
+  const PageLayout& layout = layouts[page];
+  if (version != layout.version) {
+    widgets.setLayout(layout.specs.data(), layout.specs.size());
+    version = layout.version;
+  }
+  return layout;
+}
+
+// =====================================================
+// --- FILLING (once per page update) ---
+// =====================================================
+
+// --- HELPER: A numeric field; false if the page has no data for it ---
+static bool fieldNumber(const LayoutRef& ref, const LayoutData& data, float& value) {
+  const StockQuote* quote = data.quote;
+  const WeatherData* weather = data.weather;
+  bool hasDay = weather != nullptr && ref.day < weather->days;
+
+  switch (ref.field) {
+    case FIELD_QUOTE_C: if (quote) value = quote->current; return quote;
+    case FIELD_QUOTE_H: if (quote) value = quote->high; return quote;
+    case FIELD_QUOTE_L: if (quote) value = quote->low; return quote;
+    case FIELD_QUOTE_O: if (quote) value = quote->open; return quote;
+    case FIELD_QUOTE_PC: if (quote) value = quote->prevClose; return quote;
+    case FIELD_QUOTE_D: if (quote) value = quote->change; return quote;
+    case FIELD_QUOTE_DP: if (quote) value = quote->pctChange; return quote;
+    case FIELD_CURRENT_TEMP: if (weather) value = weather->tempNow; return weather;
+    case FIELD_CURRENT_CODE: if (weather) value = weather->codeNow; return weather;
+    case FIELD_DAILY_MAX: if (hasDay) value = weather->dayMax[ref.day]; return hasDay;
+    case FIELD_DAILY_MIN: if (hasDay) value = weather->dayMin[ref.day]; return hasDay;
+    case FIELD_DAILY_CODE: if (hasDay) value = weather->dayCode[ref.day]; return hasDay;
+    default: return false;
+  }
+}
+
+// --- HELPER: Any field as text ---
+static bool fieldText(const LayoutRef& ref, const LayoutData& data, String& text) {
+  const WeatherData* weather = data.weather;
+  bool hasDay = weather != nullptr && ref.day < weather->days;
+
+  switch (ref.field) {
+    case FIELD_NONE:
+      return true;
+    case FIELD_TICKER:
+      if (data.ticker) text += *data.ticker;
+      return data.ticker;
+    case FIELD_LOCATION:
+      if (data.location) text += *data.location;
+      return data.location;
+    case FIELD_CURRENT_DESC:
+      if (weather) text += getWeatherDescription(weather->codeNow);
+      return weather;
+    case FIELD_DAILY_DAY:
+      if (hasDay) text += getDayOfWeek(weather->dayTime[ref.day] + weather->utcOffset);
+      return hasDay;
+    case FIELD_DAILY_DESC:
+      if (hasDay) text += getWeatherDescription(weather->dayCode[ref.day]);
+      return hasDay;
+    default: {
+      float value;
+      if (!fieldNumber(ref, data, value)) return false;
+      if (ref.sign && value >= 0) text += "+";
+      text += (ref.decimals > 0) ? String(value, (unsigned int)ref.decimals) : String((long)lroundf(value));
+      return true;
+    }
+  }
+}
+
+// --- HELPER: An item's text, or "" if one of its fields has no data ---
+static String itemText(const PageLayout& layout, const LayoutItem& item, const LayoutData& data) {
+  String text;
+  for (uint16_t s = item.firstSegment; s < item.firstSegment + item.segments; s++) {
+    const LayoutSegment& segment = layout.segments[s];
+    text += segment.literal;
+    if (!fieldText(segment.ref, data, text)) return "";
+  }
+  return text;
+}
+
+uint16_t layoutColor(const LayoutItem& item, const LayoutData& data) {
+  switch (item.color) {
+    case COLOR_MUTED: return CAT_MUTED;
+    case COLOR_ACCENT: return CAT_ACCENT;
+    case COLOR_SURFACE: return CAT_SURFACE;
+    case COLOR_GREEN: return CAT_GREEN;
+    case COLOR_RED: return CAT_RED;
+    case COLOR_YELLOW: return CAT_YELLOW;
+    case COLOR_BLUE: return CAT_BLUE;
+    case COLOR_WHITE: return CAT_WHITE;
+    case COLOR_GREY: return CAT_GREY;
+    case COLOR_CHANGE: return (data.quote != nullptr && data.quote->change < 0) ? CAT_RED : CAT_GREEN;
+    case COLOR_RGB: return item.rgb;
+    default: return CAT_TEXT;
+  }
+}
+
+bool layoutFill(const PageLayout& layout, size_t i, WidgetContent& widget, const LayoutData& data) {
+  const LayoutItem& item = layout.items[i];
+  uint16_t color = layoutColor(item, data);
+
+  switch (item.type) {
+    case LAYOUT_LABEL:
+    case LAYOUT_VALUE:
+      widget.text = itemText(layout, item, data);
+      widget.color = color;
+      return true;
+
+    case LAYOUT_BAR:
+      if (!fieldNumber(item.lo, data, widget.lo) || !fieldNumber(item.hi, data, widget.hi) ||
+          !fieldNumber(item.pos, data, widget.pos)) {
+        widget.lo = widget.hi = widget.pos = 0;
+      }
+      widget.color = color;
+      return true;
+
+    case LAYOUT_ICON: {
+      float code;
+      widget.code = fieldNumber(item.code, data, code) ? (int)code : -1; // -1 draws nothing
+      widget.night = item.code.field == FIELD_CURRENT_CODE && data.weather != nullptr && !data.weather->isDay;
+      return true;
+    }
+
+    case LAYOUT_HEADER:
+      setHeaderWidget(widget, itemText(layout, item, data));
+      return true;
+    case LAYOUT_FOOTER:
+      setFooterWidget(widget, data.page);
+      return true;
+    case LAYOUT_AGE:
+      setDataAgeWidget(widget, data.ageMs, data.ageColor);
+      return true;
+
+    case LAYOUT_RULE: {
+      WidgetSpec spec = layout.specs[i]; // A copy: the layout may be reloaded before the page is redrawn
+      widget.hash = widgetHashColor(color, 1);
+      widget.draw = [spec, color]() { gfx().fillRect(spec.x, spec.y, spec.w, spec.h, color); };
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+#include "globals.h" // For Page
+#include "widgets.h" // For WidgetSpec, WidgetPage
+#include "stocks.h"  // For StockQuote
+#include "weather.h" // For WeatherData
+
+// =========================================================================
+// PAGE LAYOUTS
+// Where each widget of the stock, weather and hourly pages sits and which
+// data field it shows. The built-in layout (default_layout_json in
+// config.cpp) can be replaced, page by page, by /layout.json, which the
+// web GUI's Layout tab uploads. Either way the JSON is compiled once, at
+// boot or after an upload, into a flat array per page: the WidgetSpec
+// table a WidgetPage draws from, plus one LayoutItem per widget whose
+// field names are already resolved to enums and whose text is already
+// split into literal / field segments. Filling a page is one pass over
+// that array; nothing is parsed per frame.
+//
+//   {"stocks": [
+//     {"type": "value", "rect": [0, 70, 320, 40], "at": [160, 90], "datum": "MC",
+//      "font": "large_bold", "text": "${quote.c}", "color": "text"}, ...],
+//    "weather": [...], "hourly": [...]}
+//
+// Text fields: {ticker}, {quote.c|h|l|o|pc|d|dp}, {location},
+// {current.temp|code|desc}, {forecast.daily[i].max|min|code|day|desc}.
+// "{quote.d:+2}" forces a sign and 2 decimals. A text whose field the
+// page has no data for (a day past the forecast) is left blank.
+// =========================================================================
+
+// What an item draws. Label to rule are filled in by layoutFill(); the
+// rest are the pages' own drawings, placed by the layout.
+enum LayoutType : uint8_t {
+  LAYOUT_LABEL,     // "text"
+  LAYOUT_VALUE,     // "text", redrawn by changed glyphs
+  LAYOUT_BAR,       // "lo", "hi", "pos" fields
+  LAYOUT_ICON,      // "code" field
+  LAYOUT_HEADER,    // "text" is the title
+  LAYOUT_FOOTER,
+  LAYOUT_AGE,
+  LAYOUT_RULE,      // Fills its rect with "color"
+  LAYOUT_SPARKLINE, // Stocks
+  LAYOUT_TEMP,      // Weather: current temperature
+  LAYOUT_CARD,      // Weather: forecast "day"
+  LAYOUT_CHART,     // Hourly
+};
+
+enum LayoutField : uint8_t {
+  FIELD_NONE,
+  FIELD_TICKER,
+  FIELD_QUOTE_C, FIELD_QUOTE_H, FIELD_QUOTE_L, FIELD_QUOTE_O, FIELD_QUOTE_PC, FIELD_QUOTE_D, FIELD_QUOTE_DP,
+  FIELD_LOCATION,
+  FIELD_CURRENT_TEMP, FIELD_CURRENT_CODE, FIELD_CURRENT_DESC,
+  FIELD_DAILY_MAX, FIELD_DAILY_MIN, FIELD_DAILY_CODE, FIELD_DAILY_DAY, FIELD_DAILY_DESC,
+};
+
+enum LayoutColor : uint8_t {
+  COLOR_TEXT, COLOR_MUTED, COLOR_ACCENT, COLOR_SURFACE, COLOR_GREEN, COLOR_RED,
+  COLOR_YELLOW, COLOR_BLUE, COLOR_WHITE, COLOR_GREY,
+  COLOR_CHANGE, // Green when the quote is up, red when it is down
+  COLOR_RGB,    // "#RRGGBB", drawn as the nearest theme colour
+};
+
+// A resolved field name
+struct LayoutRef {
+  LayoutField field = FIELD_NONE;
+  uint8_t day = 0;      // forecast.daily[day]
+  uint8_t decimals = 0; // Numbers
+  bool sign = false;    // '+' on numbers >= 0
+};
+
+// Literal text followed by a field (FIELD_NONE at the end of a text)
+struct LayoutSegment {
+  String literal;
+  LayoutRef ref;
+};
+
+// One widget of a compiled layout
+struct LayoutItem {
+  LayoutType type;
+  LayoutColor color;
+  uint16_t rgb;                    // COLOR_RGB
+  uint16_t firstSegment, segments; // Text, in PageLayout::segments
+  LayoutRef lo, hi, pos;           // Bar
+  LayoutRef code;                  // Icon
+  uint8_t day;                     // Card
+};
+
+struct PageLayout {
+  std::vector<WidgetSpec> specs; // specs[i] is where items[i] is drawn
+  std::vector<LayoutItem> items;
+  std::vector<LayoutSegment> segments;
+  uint32_t version = 0;          // Changes with every load
+};
+
+// What a page is filled from; anything the page does not show stays null
+struct LayoutData {
+  Page page;
+  const String* ticker = nullptr;
+  const StockQuote* quote = nullptr;
+  const String* location = nullptr;
+  const WeatherData* weather = nullptr;
+  long ageMs = -1; // Negative leaves the data age blank
+  uint16_t ageColor = 0;
+};
+
+// Compiles the built-in layout and /layout.json over it. Runs on the
+// loop() task (at boot and on CMD_RELOAD_LAYOUT), since the pages
+// are filled there.
+void loadLayouts();
+
+// Compiles `json` without using it, for the upload endpoint. On failure
+// `error` says which item is wrong ("weather[4]: unknown field ...").
+bool layoutValidate(const String& json, String& error);
+
+// The layout for `page`. If it was reloaded since `version` (the page's
+// own copy of PageLayout::version), `widgets` is pointed at the new
+// table first, which makes its next render() a full one.
+const PageLayout& layoutFor(Page page, WidgetPage& widgets, uint32_t& version);
+
+// Fills widget i of `layout`. False for the page's own types (sparkline,
+// temp, card, chart), which the caller fills in.
+bool layoutFill(const PageLayout& layout, size_t i, WidgetContent& widget, const LayoutData& data);
+
+// An item's color, for the page's own types
+uint16_t layoutColor(const LayoutItem& item, const LayoutData& data);
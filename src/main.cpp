@@ -12,6 +12,7 @@
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include <vector>
+#include <algorithm> // For std::find
 #include <ESPmDNS.h> // For .local address
 #include <LittleFS.h>
 #include <FS.h>
@@ -28,13 +29,27 @@
 #include "weather.h"
 #include "web_server.h"
 #include "persistence.h" // For persistence
+#include "net_worker.h"  // For background HTTPS
+#include "geocode_cache.h" // For initGeocodeCache, prefetchLocation, geocodeInvalidate
+#include "trade_stream.h"  // For live prices
+#include "price_history.h" // For priceHistorySync
+#include "render.h"        // For renderTransitionNext
+#include "screen_mirror.h" // For screenMirrorTick
+#include "layout.h"        // For loadLayouts
+#include "ticker_tape.h"   // For showTickerTape, tickerTapeTick
+#include "watchlist.h"     // For showWatchlist, watchlistTick
+#include "theme.h"         // For THEME_MOCHA, themeApply
+#include "command_queue.h" // For takeCommand
+#include "touch_input.h"   // For startTouchInput, takeTouchEvent
+#include "power.h"         // For startPower, powerIdle, NIGHT_NONE
+#include "wifi_switch.h"   // For startWifiSwitch, wifiSwitchTick
 
 // =========================================================================
 // GLOBAL OBJECT DEFINITIONS (Matching externs in globals.h)
 // =========================================================================
 // Hardware Objects
 TFT_eSPI tft = TFT_eSPI();
-XPT2046_Touchscreen ts(TOUCH_CS, TOUCH_IRQ);
+XPT2046_Touchscreen ts(TOUCH_CS); // TOUCH_IRQ is handled by touch_input.cpp, so every read samples
 AsyncWebServer server(80);
 
 // Global State
@@ -42,8 +57,6 @@ Page currentPage = PAGE_STOCKS;
 bool needsRedraw = true;
 String lastTicker; // Will be set by loadConfig
 String lastWeatherLocation; // Will be set by loadConfig
-bool inputUpdated = false;
-bool weatherInputUpdated = false;
 char upperString[100];
 
 // Network State
@@ -56,17 +69,45 @@ std::vector<String> weatherLocationList;
 int currentStockIndex = 0;
 int currentLocIndex = 0;
 unsigned long rotationInterval; // <-- THIS IS THE MISSING DEFINITION
+bool hourlyEnabled = false;    // Set by loadConfig
+bool watchlistEnabled = false;
+int watchlistSort = 0;
+bool tapeEnabled = false;
+bool rotationPaused = false;
+
+// Live Prices
+bool tradeStreamEnabled = false; // Set by loadConfig
+String tradeStreamUrl = TRADE_STREAM_DEFAULT_URL;
+
+// Display
+int uiTheme = THEME_MOCHA; // Set by loadConfig
+int nightMode = NIGHT_NONE;
+int nightStartHour = 23;
+int nightEndHour = 7;
 
 // =========================================================================
 // FILE-SCOPE STATIC VARIABLES
 // =========================================================================
 // Timer for auto-rotation
 static unsigned long lastRotationTime = 0;
+static bool nextPagePrefetched = false;
+
+// Who asked for the pending redraw (a person waiting jumps the fetch queue)
+static NetPriority redrawPriority = NET_PRIO_ROTATION;
+
+// Set once a firmware upload starts: the screen keeps the OTA message
+// until the web server restarts the device
+static bool otaUpdating = false;
 
 // =========================================================================
 // FUNCTION PROTOTYPES
 // =========================================================================
-void checkTouch();
+void handleTouch();
+void stepItem(int step);
+Page previousPage(Page page);
+void applyCommand(const Command& cmd);
+void prefetchNextPage();
+RenderTransition pageTransition(Page page);
 
 // =========================================================================
 // SETUP
@@ -80,6 +121,7 @@ void setup() {
   ts.begin();
   ts.setRotation(1); // Match TFT rotation
   Serial.println("Touchscreen initialized on separate SPI bus.");
+  startTouchInput(); // Samples on pen-down interrupts from here on
 
   // --- 2. Init TFT ---
   tft.init();
@@ -94,6 +136,11 @@ void setup() {
   // This initializes LittleFS and loads all saved settings
   // (WiFi, Lists, Timer) into the global variables.
   loadConfig(); 
+  themeApply(uiTheme); // The saved theme; boot messages above used the default
+  tft.fillScreen(CAT_BG);
+  initGeocodeCache(); // Lives alongside the settings on LittleFS
+  loadLayouts();      // Built-in page layouts, or /layout.json
+  priceHistorySync(stockTickerList); // One ring per ticker
 
   // Set initial item to fetch
   if (!stockTickerList.empty()) {
@@ -107,6 +154,7 @@ void setup() {
   // currentSsid and currentPass were set by loadConfig()
   WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
   WiFi.setHostname("esp32-web");
+  startWifiSwitch(); // /connect_wifi switches networks from loop() later on
   WiFi.begin(currentSsid.c_str(), currentPass.c_str());
   if (WiFi.waitForConnectResult() != WL_CONNECTED) {
     Serial.println("WiFi Failed!");
@@ -148,7 +196,16 @@ void setup() {
     Serial.println("\nTime synced!");
   }
   
-  // --- 7. Start Web Server ---
+  // --- 7. Start Network Worker (core 0) ---
+  startNetWorker(); // From net_worker.cpp
+  startTradeStream(); // Idles unless live prices are enabled
+  tradeStreamSync(stockTickerList);
+
+  // --- 7b. Power: clock scaling, light sleep, modem sleep, backlight ---
+  startPower(); // loop() sleeps in powerIdle() from here on
+
+  // --- 8. Start Web Server ---
+  publishWebSnapshot(); // Lists for /get_lists, before the first request
   setup_web_server(); // From web_server.cpp
 }
 
@@ -160,31 +217,62 @@ void loop() {
       lastRotationTime = millis();
   }
 
-  // 1. Check for user touch input
-  checkTouch();
+  // Nothing else draws while a firmware upload runs
+  if (otaUpdating) {
+    powerIdle();
+    return;
+  }
 
-  // 2. Check for one-off web stock fetch
-  if (inputUpdated) {
-    inputUpdated = false;
-    currentPage = PAGE_STOCKS;
-    needsRedraw = true;
-    lastRotationTime = millis(); // Reset rotation timer
+  // 0. Night profile: backlight level, panel lit or blank
+  if (powerUpdate()) {
+    needsRedraw = true; // Lit again; the page stood still while it was dark
+    redrawPriority = NET_PRIO_INTERACTIVE;
   }
 
-  // 3. Check for one-off web weather fetch
-  if (weatherInputUpdated) {
-    weatherInputUpdated = false;
-    currentPage = PAGE_WEATHER;
-    needsRedraw = true;
-    lastRotationTime = millis(); // Reset rotation timer
+  // 1. Act on touch gestures (sampled by the touch task)
+  handleTouch();
+
+  // 1b. Draw any fetches the network worker has finished
+  netWorkerDispatch();
+
+  // 1c. Pick up streamed trades for the ticker on screen
+  if (powerPanelOn()) refreshLivePrice();
+
+  // 1d. Send what changed on screen to web GUI viewers
+  screenMirrorTick();
+
+  // 2. Apply what the web GUI asked for (one-off fetches, settings)
+  Command cmd;
+  bool applied = false;
+  while (takeCommand(cmd)) {
+    applyCommand(cmd);
+    free(cmd.longText);
+    applied = true;
+  }
+  if (applied) publishWebSnapshot(); // What /get_lists shows
+  if (otaUpdating) return;
+
+  // 2b. Move a /connect_wifi network switch along
+  wifiSwitchTick();
+
+  // 3. A blank panel (night profile) neither rotates nor draws
+  bool rotating = !rotationPaused && powerPanelOn();
+
+  // 4. Warm the cache for the next page shortly before rotating to it
+  unsigned long lead = min((unsigned long)PREFETCH_LEAD_MS, rotationInterval / 4);
+  if (rotating && !nextPagePrefetched && millis() - lastRotationTime > rotationInterval - lead) {
+    nextPagePrefetched = true;
+    prefetchNextPage();
   }
 
-  // 4. Check for auto-rotation
-  if (millis() - lastRotationTime > rotationInterval) {
+  // 4b. Check for auto-rotation
+  if (rotating && millis() - lastRotationTime > rotationInterval) {
     lastRotationTime = millis();
+    nextPagePrefetched = false;
     
-    // Toggle the page
-    currentPage = (currentPage == PAGE_STOCKS) ? PAGE_WEATHER : PAGE_STOCKS;
+    // Advance the page (the hourly page keeps the weather page's location)
+    currentPage = nextPage(currentPage);
+    renderTransitionNext(pageTransition(currentPage));
     
     if (currentPage == PAGE_STOCKS) {
       // Advance to next stock in list
@@ -192,7 +280,7 @@ void loop() {
         currentStockIndex = (currentStockIndex + 1) % stockTickerList.size();
         lastTicker = stockTickerList[currentStockIndex];
       }
-    } else {
+    } else if (currentPage == PAGE_WEATHER) {
       // Advance to next location in list
       if (!weatherLocationList.empty()) {
         currentLocIndex = (currentLocIndex + 1) % weatherLocationList.size();
@@ -200,46 +288,308 @@ void loop() {
       }
     }
     needsRedraw = true;
+    redrawPriority = NET_PRIO_ROTATION;
   }
 
   // 5. Redraw the screen if needed
-  if (needsRedraw) {
+  // (Never blocks: the fetch itself runs on the network worker)
+  if (needsRedraw && powerPanelOn()) {
     needsRedraw = false;
     
     if (currentPage == PAGE_STOCKS) {
-      fetchAndDisplayTicker(lastTicker);
+      fetchAndDisplayTicker(lastTicker, redrawPriority);
+    } else if (currentPage == PAGE_WATCHLIST) {
+      showWatchlist();
+    } else if (currentPage == PAGE_TAPE) {
+      showTickerTape();
     } else {
-      fetchAndDisplayWeather(lastWeatherLocation);
+      fetchAndDisplayWeather(lastWeatherLocation, redrawPriority);
     }
   }
+
+  // 6. Scroll the ticker tape (paced to TAPE_FPS, does nothing on other pages)
+  // 7. Re-rank the watchlist on streamed trades
+  if (powerPanelOn()) {
+    tickerTapeTick();
+    watchlistTick();
+  }
+
+  // 8. Sleep until the next rotation step or periodic tick is due, or
+  // until a gesture, a web command or a finished fetch wakes us
+  if (rotating) {
+    if (!nextPagePrefetched) powerWakeAt(lastRotationTime + rotationInterval - lead + 1);
+    powerWakeAt(lastRotationTime + rotationInterval + 1);
+  }
+  powerIdle();
 }
 
 // =========================================================================
 // LOCAL-ONLY FUNCTIONS
 // =========================================================================
-void checkTouch() {
-  static uint32_t lastTouchTime = 0;
+// Acts on the gestures the touch task recognized (see touch_input.h):
+// a tap goes to the next page, a swipe to the next or previous item and
+// a long press pauses or resumes the rotation.
+void handleTouch() {
+  TouchEvent event;
+  while (takeTouchEvent(event)) {
+    if (powerTouched()) { // The gesture only lit a blank panel
+      needsRedraw = true;
+      redrawPriority = NET_PRIO_INTERACTIVE;
+      lastRotationTime = millis();
+      nextPagePrefetched = false;
+      touchEventHandled(event);
+      continue;
+    }
+    switch (event.gesture) {
+      case GESTURE_TAP:
+        Serial.printf("Touch detected! Next page. [x=%d, y=%d]\n", event.x, event.y);
+        currentPage = nextPage(currentPage);
+        renderTransitionNext(pageTransition(currentPage));
+        break;
+      case GESTURE_SWIPE_LEFT:
+        stepItem(1);
+        break;
+      case GESTURE_SWIPE_RIGHT:
+        stepItem(-1);
+        break;
+      case GESTURE_LONG_PRESS:
+        rotationPaused = !rotationPaused; // The footer says so
+        Serial.printf("Rotation %s\n", rotationPaused ? "paused" : "resumed");
+        break;
+    }
+    needsRedraw = true;
+    redrawPriority = NET_PRIO_INTERACTIVE;
+    lastRotationTime = millis(); // Also reset auto-rotation timer
+    nextPagePrefetched = false;
+    touchEventHandled(event);
+  }
+}
 
-  if (millis() - lastTouchTime < 500) {
-    return;
+// Swipes: the next (+1) or previous (-1) ticker or location on the
+// pages that show one, the next or previous page on the others
+void stepItem(int step) {
+  if (currentPage == PAGE_STOCKS && !stockTickerList.empty()) {
+    int count = stockTickerList.size();
+    currentStockIndex = (currentStockIndex + step + count) % count;
+    lastTicker = stockTickerList[currentStockIndex];
+  } else if ((currentPage == PAGE_WEATHER || currentPage == PAGE_HOURLY) && !weatherLocationList.empty()) {
+    int count = weatherLocationList.size();
+    currentLocIndex = (currentLocIndex + step + count) % count;
+    lastWeatherLocation = weatherLocationList[currentLocIndex];
+  } else {
+    currentPage = step > 0 ? nextPage(currentPage) : previousPage(currentPage);
   }
-  
-  if (ts.touched()) {
-    TS_Point p = ts.getPoint();
-    
-    if (p.z > 100 && p.z < 3000) {
-      lastTouchTime = millis(); // Used to debounce touch
-      
-      // Convert raw ADC values to screen pixels
-      int16_t x = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 0, 320);
-      int16_t y = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 0, 240);
-      
-      Serial.print("Touch detected! Toggling page. ");
-      Serial.printf("[Raw: x=%d, y=%d] [Mapped: x=%d, y=%d]\n", p.x, p.y, x, y);
-      
-      currentPage = (currentPage == PAGE_STOCKS) ? PAGE_WEATHER : PAGE_STOCKS;
+  renderTransitionNext(step > 0 ? TRANSITION_SLIDE : TRANSITION_SLIDE_BACK);
+}
+
+// --- HELPER: Split "a,b,c" into its non-empty items ---
+static std::vector<String> splitList(const char* text) {
+  std::vector<String> items;
+  String item = "";
+  for (const char* c = text; *c != '\0'; c++) {
+    if (*c == ',') {
+      if (item.length() > 0) items.push_back(item);
+      item = "";
+    } else {
+      item += *c;
+    }
+  }
+  if (item.length() > 0) items.push_back(item);
+  return items;
+}
+
+// --- HELPER: Save the stock list and bring the stream and sparklines in line ---
+static void stockListChanged() {
+  saveStockList();
+  tradeStreamSync(stockTickerList);
+  priceHistorySync(stockTickerList);
+}
+
+// Applies a command posted by a web handler (see command_queue.h)
+void applyCommand(const Command& cmd) {
+  switch (cmd.type) {
+    case CMD_SHOW_TICKER:
+    case CMD_SHOW_LOCATION:
+      // One-off fetch: show it now and restart the rotation from there
+      if (cmd.type == CMD_SHOW_TICKER) {
+        lastTicker = cmd.text;
+        currentPage = PAGE_STOCKS;
+      } else {
+        lastWeatherLocation = cmd.text;
+        currentPage = PAGE_WEATHER;
+      }
+      needsRedraw = true;
+      redrawPriority = NET_PRIO_INTERACTIVE;
+      lastRotationTime = millis(); // Reset rotation timer
+      nextPagePrefetched = false;
+      break;
+
+    case CMD_SET_INTERVAL:
+      rotationInterval = cmd.value;
+      saveAppSettings(); // Save to settings.json
+      Serial.printf("Rotation interval set to: %lu ms\n", rotationInterval);
+      break;
+
+    case CMD_SET_WATCHLIST:
+      if (cmd.value >= 0) watchlistEnabled = cmd.value;
+      if (cmd.value2 >= 0) watchlistSort = cmd.value2; // Re-ranked by watchlistTick()
+      saveAppSettings();
+      Serial.printf("Watchlist %s, sorted by %s\n", watchlistEnabled ? "enabled" : "disabled", watchlistSortName(watchlistSort));
+      break;
+
+    case CMD_SET_HOURLY:
+      hourlyEnabled = cmd.value;
+      saveAppSettings();
+      Serial.printf("Hourly page %s\n", hourlyEnabled ? "enabled" : "disabled");
+      break;
+
+    case CMD_SET_TAPE:
+      tapeEnabled = cmd.value;
+      saveAppSettings();
+      Serial.printf("Ticker tape %s\n", tapeEnabled ? "enabled" : "disabled");
+      break;
+
+    case CMD_OTA_STARTED:
+      otaUpdating = true;
+      if (powerPanelOn()) drawStatusMessage("OTA Update...", CAT_ACCENT);
+      break;
+
+    case CMD_SET_THEME:
+      // The frame holds theme slots, so pushing it again through the
+      // new palette recolours the page without redrawing it
+      uiTheme = cmd.value;
+      saveAppSettings();
+      Serial.printf("Theme %s\n", themeName(uiTheme));
+      themeApply(uiTheme);
+      if (!renderRepaint()) needsRedraw = true;
+      break;
+
+    case CMD_SET_STREAM:
+      if (cmd.value >= 0) tradeStreamEnabled = cmd.value;
+      if (cmd.text[0] != '\0') tradeStreamUrl = cmd.text;
+      saveAppSettings();
+      tradeStreamReconfigure();
+      Serial.printf("Live prices %s (%s)\n", tradeStreamEnabled ? "enabled" : "disabled", tradeStreamUrl.c_str());
+      break;
+
+    case CMD_SET_NIGHT:
+      // powerUpdate() picks it up at the start of the next pass
+      nightMode = cmd.value;
+      nightStartHour = cmd.value2 >> 8;
+      nightEndHour = cmd.value2 & 0xFF;
+      saveAppSettings();
+      Serial.printf("Night profile %s, %02d:00-%02d:00\n", nightModeName(nightMode), nightStartHour, nightEndHour);
+      break;
+
+    case CMD_RELOAD_LAYOUT:
+      // Recompile the page layouts after an upload and redraw with them
+      loadLayouts();
       needsRedraw = true;
-      lastRotationTime = millis(); // Also reset auto-rotation timer
+      break;
+
+    case CMD_ADD_STOCK:
+      if (std::find(stockTickerList.begin(), stockTickerList.end(), String(cmd.text)) == stockTickerList.end()) {
+        stockTickerList.push_back(cmd.text);
+        stockListChanged();
+      }
+      break;
+
+    case CMD_REMOVE_STOCK: {
+      auto it = std::find(stockTickerList.begin(), stockTickerList.end(), String(cmd.text));
+      if (it != stockTickerList.end()) {
+        stockTickerList.erase(it);
+        stockListChanged();
+      }
+      break;
+    }
+
+    case CMD_ADD_LOCATION:
+      if (std::find(weatherLocationList.begin(), weatherLocationList.end(), String(cmd.text)) == weatherLocationList.end()) {
+        weatherLocationList.push_back(cmd.text);
+        saveWeatherList();
+        prefetchLocation(cmd.text); // Resolve lat/lon now, not on its first page
+      }
+      break;
+
+    case CMD_REMOVE_LOCATION: {
+      auto it = std::find(weatherLocationList.begin(), weatherLocationList.end(), String(cmd.text));
+      if (it != weatherLocationList.end()) {
+        weatherLocationList.erase(it);
+        saveWeatherList();
+        geocodeInvalidate(cmd.text);
+      }
+      break;
+    }
+
+    case CMD_SET_LIST:
+      // A new order from the web GUI (drag and drop)
+      if (cmd.value == LIST_STOCKS) {
+        stockTickerList = splitList(cmd.longText);
+        stockListChanged();
+        Serial.println("Updated stock list order.");
+      } else {
+        weatherLocationList = splitList(cmd.longText);
+        saveWeatherList();
+        Serial.println("Updated weather list order.");
+      }
+      break;
+
+    case CMD_RESTORE_LISTS:
+      Serial.println("Restoring default lists from secrets...");
+      stockTickerList = defaultStockList;
+      weatherLocationList = defaultWeatherList;
+      currentStockIndex = 0;
+      currentLocIndex = 0;
+      stockListChanged();
+      saveWeatherList();
+      break;
+  }
+}
+
+// Queues the fetch for whatever step 4b will show next, so the rotation
+// lands on a fresh page instead of a "Fetching..." screen.
+void prefetchNextPage() {
+  Page next = nextPage(currentPage);
+  if (next == PAGE_WEATHER) {
+    if (!weatherLocationList.empty()) {
+      prefetchWeather(weatherLocationList[(currentLocIndex + 1) % weatherLocationList.size()]);
     }
+  } else if (next == PAGE_STOCKS) {
+    if (!stockTickerList.empty()) {
+      prefetchTicker(stockTickerList[(currentStockIndex + 1) % stockTickerList.size()]);
+    }
+  } else if (next == PAGE_WATCHLIST) {
+    prefetchWatchlist();
+  } else if (next == PAGE_TAPE) {
+    prefetchTickerTape();
+  }
+  // PAGE_HOURLY shows the forecast that is already on screen
+}
+
+// Stocks -> Weather -> (Hourly ->) (Watchlist ->) (Tape ->) Stocks
+// Each optional page that is switched off falls through to the next.
+Page nextPage(Page page) {
+  switch (page) {
+    case PAGE_STOCKS: return PAGE_WEATHER;
+    case PAGE_WEATHER: if (hourlyEnabled) return PAGE_HOURLY; [[fallthrough]];
+    case PAGE_HOURLY: if (watchlistEnabled) return PAGE_WATCHLIST; [[fallthrough]];
+    case PAGE_WATCHLIST: if (tapeEnabled) return PAGE_TAPE; [[fallthrough]];
+    default: return PAGE_STOCKS;
+  }
+}
+
+// The page a tap on `page` came from, walking the rotation round
+Page previousPage(Page page) {
+  Page prev = page;
+  for (int i = 0; i < 5; i++) { // Every page once at most
+    if (nextPage(prev) == page) return prev;
+    prev = nextPage(prev);
   }
-}
\ No newline at end of file
+  return PAGE_STOCKS; // An optional page that has been switched off
+}
+
+// Slide to a new kind of page; fade into the hourly page, which shows
+// the same forecast as the weather page before it
+RenderTransition pageTransition(Page page) {
+  return (page == PAGE_HOURLY) ? TRANSITION_FADE : TRANSITION_SLIDE;
+}
@@ -0,0 +1,273 @@
+#include "net_worker.h"
+#include "config.h"     // For NET_TASK_* and rate limit settings
+#include "power.h"      // For powerWake
+#include <ArduinoJson.h>
+#include <vector>
+#include <atomic>
+
+// A queued unit of work. Allocated by netScheduleRaw(), run by the
+// network task, handed back through doneQueue and freed by
+// netWorkerDispatch() after every merged caller's callback has run.
+struct NetJob {
+  String key;
+  NetProvider provider;
+  NetPriority priority;
+  unsigned long seq;       // FIFO order within a priority
+  unsigned long queuedAt;
+  bool throttled;          // Has waited on its provider's token bucket
+  std::shared_ptr<void> result;
+  NetRawWork work;
+  std::vector<NetRawDone> done; // One per merged caller
+  bool ok;
+};
+
+// One bucket per upstream provider. Each dispatched job costs a token;
+// tokens refill continuously at the provider's per-minute quota.
+struct TokenBucket {
+  const char* name;
+  float capacity;          // Burst size
+  float perMinute;
+  float tokens;
+  unsigned long lastRefill;
+  unsigned long granted;
+  unsigned long throttled; // Jobs that had to wait for a token
+};
+
+static TokenBucket buckets[PROVIDER_COUNT] = {
+  {"finnhub", FINNHUB_BURST, FINNHUB_PER_MINUTE, FINNHUB_BURST, 0, 0, 0},
+  {"open-meteo", OPEN_METEO_BURST, OPEN_METEO_PER_MINUTE, OPEN_METEO_BURST, 0, 0, 0},
+};
+
+static const char* priorityNames[NET_PRIO_COUNT] = {"interactive", "rotation", "background"};
+
+// Guards the buckets, the queue, `running` and the counters
+static SemaphoreHandle_t schedLock = nullptr;
+static std::vector<NetJob*> pending;
+static NetJob* running = nullptr;
+static unsigned long nextSeq = 0;
+static unsigned long statCoalesced = 0;
+static unsigned long statDropped = 0;
+static unsigned long statCompleted = 0;
+
+static TaskHandle_t workerTask = nullptr;
+static QueueHandle_t doneQueue = nullptr;  // network task -> loop()
+static std::atomic<int> jobsInFlight(0);
+
+// --- HELPER: Top up a bucket for the time since its last refill ---
+static void refill(TokenBucket& bucket, unsigned long now) {
+  bucket.tokens += (now - bucket.lastRefill) * (bucket.perMinute / 60000.0f);
+  if (bucket.tokens > bucket.capacity) bucket.tokens = bucket.capacity;
+  bucket.lastRefill = now;
+}
+
+// --- HELPER: Pick the next job (call with schedLock held) ---
+// Highest priority first, oldest first within a priority, skipping jobs
+// whose provider is out of tokens. If nothing can run, `wait` is set to
+// how long until the first token comes back.
+static NetJob* takeNextJob(TickType_t& wait) {
+  unsigned long now = millis();
+  for (TokenBucket& bucket : buckets) refill(bucket, now);
+
+  int best = -1;
+  unsigned long soonestMs = ULONG_MAX;
+  for (size_t i = 0; i < pending.size(); i++) {
+    NetJob* job = pending[i];
+    TokenBucket& bucket = buckets[job->provider];
+    if (bucket.tokens < 1.0f) {
+      if (!job->throttled) {
+        job->throttled = true;
+        bucket.throttled++;
+      }
+      unsigned long ms = (unsigned long)((1.0f - bucket.tokens) * 60000.0f / bucket.perMinute) + 1;
+      if (ms < soonestMs) soonestMs = ms;
+      continue;
+    }
+    if (best == -1 || job->priority < pending[best]->priority ||
+        (job->priority == pending[best]->priority && job->seq < pending[best]->seq)) {
+      best = i;
+    }
+  }
+
+  if (best == -1) {
+    wait = pending.empty() ? portMAX_DELAY : pdMS_TO_TICKS(soonestMs);
+    return nullptr;
+  }
+
+  NetJob* job = pending[best];
+  pending.erase(pending.begin() + best);
+  buckets[job->provider].tokens -= 1.0f;
+  buckets[job->provider].granted++;
+  return job;
+}
+
+// --- The task body (core 0) ---
+static void netWorkerTask(void* param) {
+  for (;;) {
+    TickType_t wait = portMAX_DELAY;
+    xSemaphoreTake(schedLock, portMAX_DELAY);
+    NetJob* job = takeNextJob(wait);
+    running = job;
+    xSemaphoreGive(schedLock);
+
+    if (job == nullptr) {
+      ulTaskNotifyTake(pdTRUE, wait); // Woken early by a new job
+      continue;
+    }
+
+    unsigned long started = millis();
+    job->ok = job->work ? job->work(job->result.get()) : false;
+    Serial.printf("[net] %s (%s) done in %lu ms after %lu ms queued (%s)\n", job->key.c_str(), priorityNames[job->priority],
+                  millis() - started, started - job->queuedAt, job->ok ? "ok" : "failed");
+
+    // No more callers can merge into it once it leaves `running`
+    xSemaphoreTake(schedLock, portMAX_DELAY);
+    running = nullptr;
+    xSemaphoreGive(schedLock);
+
+    xQueueSend(doneQueue, &job, portMAX_DELAY);
+    powerWake(); // loop() draws it in netWorkerDispatch()
+  }
+}
+
+// --- Public Functions ---
+
+void startNetWorker() {
+  if (schedLock != nullptr) return; // Already running
+
+  schedLock = xSemaphoreCreateMutex();
+  doneQueue = xQueueCreate(NET_QUEUE_LEN * 2 + 1, sizeof(NetJob*));
+  for (TokenBucket& bucket : buckets) bucket.lastRefill = millis();
+
+  xTaskCreatePinnedToCore(netWorkerTask, "net_worker", NET_TASK_STACK, nullptr, NET_TASK_PRIORITY, &workerTask, NET_TASK_CORE);
+  Serial.printf("Network worker started on core %d\n", NET_TASK_CORE);
+}
+
+bool netScheduleRaw(const String& key, NetProvider provider, NetPriority priority,
+                    std::shared_ptr<void> result, NetRawWork work, NetRawDone done) {
+  if (schedLock == nullptr) return false;
+
+  xSemaphoreTake(schedLock, portMAX_DELAY);
+
+  // 1. Coalesce with an identical request that is already queued or running
+  NetJob* existing = (running != nullptr && running->key == key) ? running : nullptr;
+  for (size_t i = 0; existing == nullptr && i < pending.size(); i++) {
+    if (pending[i]->key == key) existing = pending[i];
+  }
+  if (existing != nullptr) {
+    existing->done.push_back(done);
+    if (priority < existing->priority) existing->priority = priority;
+    statCoalesced++;
+    xSemaphoreGive(schedLock);
+    Serial.printf("[net] %s merged into in-flight request\n", key.c_str());
+    return true;
+  }
+
+  // 2. Queue full: bump the newest lower-priority job, or refuse this one
+  if (pending.size() >= NET_QUEUE_LEN) {
+    int victim = -1;
+    for (size_t i = 0; i < pending.size(); i++) {
+      if (pending[i]->priority <= priority) continue;
+      if (victim == -1 || pending[i]->priority > pending[victim]->priority ||
+          (pending[i]->priority == pending[victim]->priority && pending[i]->seq > pending[victim]->seq)) {
+        victim = i;
+      }
+    }
+    statDropped++;
+    if (victim == -1 || uxQueueSpacesAvailable(doneQueue) == 0) {
+      xSemaphoreGive(schedLock);
+      Serial.printf("[net] Queue full, dropping %s\n", key.c_str());
+      return false;
+    }
+    NetJob* bumped = pending[victim];
+    pending.erase(pending.begin() + victim);
+    bumped->ok = false; // Its callers see a failed fetch
+    xQueueSend(doneQueue, &bumped, 0);
+    Serial.printf("[net] Queue full, bumped %s for %s\n", bumped->key.c_str(), key.c_str());
+  }
+
+  // 3. Queue it
+  NetJob* job = new NetJob();
+  job->key = key;
+  job->provider = provider;
+  job->priority = priority;
+  job->seq = nextSeq++;
+  job->queuedAt = millis();
+  job->throttled = false;
+  job->result = result;
+  job->work = work;
+  job->done.push_back(done);
+  job->ok = false;
+  pending.push_back(job);
+  jobsInFlight++;
+
+  xSemaphoreGive(schedLock);
+  xTaskNotifyGive(workerTask);
+  return true;
+}
+
+void netWorkerDispatch() {
+  if (doneQueue == nullptr) return;
+
+  NetJob* job = nullptr;
+  while (xQueueReceive(doneQueue, &job, 0) == pdTRUE) {
+    for (NetRawDone& done : job->done) {
+      if (done) done(job->ok, job->result.get());
+    }
+    delete job;
+    jobsInFlight--;
+    statCompleted++;
+  }
+}
+
+bool netWorkerBusy() {
+  return jobsInFlight.load() > 0;
+}
+
+size_t netQueueFree() {
+  if (schedLock == nullptr) return 0;
+  xSemaphoreTake(schedLock, portMAX_DELAY);
+  size_t free = pending.size() < NET_QUEUE_LEN ? NET_QUEUE_LEN - pending.size() : 0;
+  xSemaphoreGive(schedLock);
+  return free;
+}
+
+String netSchedulerStatusJson() {
+  DynamicJsonDocument doc(2048);
+  if (schedLock == nullptr) return "{}";
+
+  xSemaphoreTake(schedLock, portMAX_DELAY);
+  unsigned long now = millis();
+
+  JsonArray providers = doc.createNestedArray("providers");
+  for (TokenBucket& bucket : buckets) {
+    refill(bucket, now);
+    JsonObject p = providers.createNestedObject();
+    p["name"] = bucket.name;
+    p["tokens"] = (int)bucket.tokens;
+    p["burst"] = (int)bucket.capacity;
+    p["per_minute"] = (int)bucket.perMinute;
+    p["granted"] = bucket.granted;
+    p["throttled"] = bucket.throttled;
+  }
+
+  doc["running"] = running ? running->key.c_str() : nullptr;
+
+  JsonArray queue = doc.createNestedArray("queue");
+  for (NetJob* job : pending) {
+    JsonObject q = queue.createNestedObject();
+    q["key"] = job->key;
+    q["priority"] = priorityNames[job->priority];
+    q["provider"] = buckets[job->provider].name;
+    q["waiting_ms"] = now - job->queuedAt;
+    q["callers"] = job->done.size();
+  }
+
+  doc["coalesced"] = statCoalesced;
+  doc["dropped"] = statDropped;
+  doc["completed"] = statCompleted;
+  xSemaphoreGive(schedLock);
+
+  String json;
+  serializeJson(doc, json);
+  return json;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+
+// =========================================================================
+// NETWORK WORKER & REQUEST SCHEDULER
+// A FreeRTOS task pinned to core 0 that runs blocking HTTPS work so the
+// Arduino loop() on core 1 never stalls on a slow upstream or a TLS
+// handshake.
+//
+// Jobs wait in a priority queue in front of HTTPSRequest():
+//  - each upstream provider has a token bucket, so a short rotation
+//    interval or a burst of /get_stock calls can't blow Finnhub's quota;
+//  - higher priority jobs (a user waiting) run before lower ones;
+//  - a job whose key is already queued or running is merged into it, and
+//    every caller's callback gets the one result.
+// =========================================================================
+
+// Highest priority first
+enum NetPriority {
+  NET_PRIO_INTERACTIVE = 0, // One-off fetch from the web GUI or a touch
+  NET_PRIO_ROTATION = 1,    // The page being rotated to (or prefetched)
+  NET_PRIO_BACKGROUND = 2,  // Refreshes nobody is looking at yet
+  NET_PRIO_COUNT
+};
+
+enum NetProvider {
+  PROVIDER_FINNHUB = 0,
+  PROVIDER_OPEN_METEO = 1,
+  PROVIDER_COUNT
+};
+
+// Type-erased job plumbing; use netSchedule<T>() below
+typedef std::function<bool(void* result)> NetRawWork;
+typedef std::function<void(bool ok, void* result)> NetRawDone;
+bool netScheduleRaw(const String& key, NetProvider provider, NetPriority priority,
+                    std::shared_ptr<void> result, NetRawWork work, NetRawDone done);
+
+// Queues `work` (runs on the network task; must NOT touch the TFT or UI
+// state) and calls `done` on the loop() task with the result.
+//
+// `key` identifies the request (e.g. "quote:AAPL"). If a job with the
+// same key is already queued or running, `work` is dropped and `done`
+// is attached to that job instead, so keys must map to one result type.
+// A merged job takes the higher of the two priorities.
+//
+// Returns false if the queue is full; `done` is then never called.
+template <typename T>
+bool netSchedule(const String& key, NetProvider provider, NetPriority priority,
+                 std::function<bool(T& result)> work,
+                 std::function<void(bool ok, const T& result)> done) {
+  return netScheduleRaw(key, provider, priority, std::make_shared<T>(),
+    [work](void* result) {
+      return work(*static_cast<T*>(result));
+    },
+    [done](bool ok, void* result) {
+      if (done) done(ok, *static_cast<const T*>(result));
+    });
+}
+
+// Starts the task. Call once from setup().
+void startNetWorker();
+
+// Runs the completion callbacks of all finished jobs.
+// Call this once per loop() iteration.
+void netWorkerDispatch();
+
+// True while a job is queued or running.
+bool netWorkerBusy();
+
+// Queue slots left for new jobs (a merged job takes none). Callers with
+// many fetches to make feed them a few at a time instead of having most
+// of them refused.
+size_t netQueueFree();
+
+// JSON snapshot of token buckets, the queue and counters (/scheduler_status)
+String netSchedulerStatusJson();
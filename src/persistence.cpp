@@ -6,6 +6,10 @@
 #include "globals.h"
 #include "secrets.h"
 #include "drawing.h"
+#include "config.h" // For TRADE_STREAM_DEFAULT_URL
+#include "watchlist.h" // For watchlistSortName
+#include "theme.h"     // For themeName
+#include "power.h"     // For nightModeName
 
 // Helper function to read a file
 String readFile(const char* path) {
@@ -54,8 +58,16 @@ void loadConfig() {
     drawStatusMessage("Storage Error", CAT_RED);
     // Load defaults as a fallback
     rotationInterval = 60000;
+    hourlyEnabled = false;
+    watchlistEnabled = false;
+    watchlistSort = WATCHLIST_LIST_ORDER;
+    tapeEnabled = false;
+    uiTheme = THEME_MOCHA;
+    nightMode = NIGHT_NONE;
     currentSsid = ssid;
     currentPass = password;
+    tradeStreamEnabled = false;
+    tradeStreamUrl = TRADE_STREAM_DEFAULT_URL;
     stockTickerList = defaultStockList;
     weatherLocationList = defaultWeatherList;
     return;
@@ -64,7 +76,7 @@ void loadConfig() {
 
   // 1. Load Settings (Rotation Timer)
   String settingsData = readFile("/settings.json");
-  StaticJsonDocument<256> settingsDoc;
+  StaticJsonDocument<512> settingsDoc;
   if (settingsData.length() > 0 && deserializeJson(settingsDoc, settingsData) == DeserializationError::Ok) {
     
     // Check if the key exists. If not, use the default.
@@ -75,9 +87,29 @@ void loadConfig() {
     }
 
     Serial.printf("Loaded interval: %lu ms\n", rotationInterval);
+    hourlyEnabled = settingsDoc["hourly_enabled"] | false;
+    watchlistEnabled = settingsDoc["watchlist_enabled"] | false;
+    watchlistSort = watchlistSortFromName(settingsDoc["watchlist_sort"] | "list");
+    tapeEnabled = settingsDoc["tape_enabled"] | false;
+    uiTheme = themeFromName(settingsDoc["theme"] | "mocha");
+    nightMode = nightModeFromName(settingsDoc["night_mode"] | "none");
+    nightStartHour = constrain(settingsDoc["night_start"] | 23, 0, 23);
+    nightEndHour = constrain(settingsDoc["night_end"] | 7, 0, 23);
+
+    // Live prices are off unless explicitly enabled
+    tradeStreamEnabled = settingsDoc["stream_enabled"] | false;
+    tradeStreamUrl = settingsDoc["stream_url"] | TRADE_STREAM_DEFAULT_URL;
   } else {
     Serial.println("No settings.json found, loading default interval.");
     rotationInterval = 60000; // 1 minute
+    hourlyEnabled = false;
+    watchlistEnabled = false;
+    watchlistSort = WATCHLIST_LIST_ORDER;
+    tapeEnabled = false;
+    uiTheme = THEME_MOCHA;
+    nightMode = NIGHT_NONE;
+    tradeStreamEnabled = false;
+    tradeStreamUrl = TRADE_STREAM_DEFAULT_URL;
   }
 
   // 2. Load WiFi Config
@@ -144,8 +176,18 @@ void saveWifiConfig() {
 
 void saveAppSettings() {
   Serial.println("Saving app settings to flash...");
-  StaticJsonDocument<256> doc;
+  StaticJsonDocument<512> doc;
   doc["rotation_ms"] = rotationInterval;
+  doc["hourly_enabled"] = hourlyEnabled;
+  doc["watchlist_enabled"] = watchlistEnabled;
+  doc["watchlist_sort"] = watchlistSortName(watchlistSort);
+  doc["tape_enabled"] = tapeEnabled;
+  doc["theme"] = themeName(uiTheme);
+  doc["night_mode"] = nightModeName(nightMode);
+  doc["night_start"] = nightStartHour;
+  doc["night_end"] = nightEndHour;
+  doc["stream_enabled"] = tradeStreamEnabled;
+  doc["stream_url"] = tradeStreamUrl;
   String json;
   serializeJson(doc, json);
   writeFile("/settings.json", json);
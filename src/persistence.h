@@ -1,4 +1,5 @@
 #pragma once
+#include <Arduino.h>
 
 // Initializes LittleFS and loads all saved settings into their
 // global variables. If settings files don't exist, it loads
@@ -15,4 +16,8 @@ void saveWeatherList();
 void saveWifiConfig();
 
 // Saves the current app settings (e.g., rotationInterval) to settings.json
-void saveAppSettings();
\ No newline at end of file
+void saveAppSettings();
+
+// Raw file helpers for modules that keep their own files on LittleFS
+String readFile(const char* path);
+void writeFile(const char* path, const String& data);
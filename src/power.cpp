@@ -0,0 +1,199 @@
+#include "power.h"
+#include "globals.h" // For tft, nightMode, nightStartHour, nightEndHour
+#include "config.h"  // For POWER_* settings
+#include <WiFi.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+
+enum PanelLevel { PANEL_FULL, PANEL_DIM, PANEL_OFF };
+
+static TaskHandle_t loopTask = nullptr;
+static const char* powerMode = "not started";
+static bool dynamicClock = false; // esp_pm scales the clock; otherwise the night profile lowers it
+static uint32_t maxMhz = 0, minMhz = 0;
+static esp_pm_lock_handle_t noSleepLock = nullptr; // Held while the backlight is dimmed
+
+// --- Deadlines (loop() task) ---
+static bool wakeAtSet = false;
+static unsigned long wakeAt = 0;
+
+// --- Night profile (loop() task) ---
+static bool night = false;
+static bool lit = false;          // A gesture lit the panel at night...
+static unsigned long litUntil = 0; // ...until then
+static PanelLevel panel = PANEL_FULL;
+
+// --- Accounting (loop() task writes, /power_stats reads) ---
+static uint64_t activeUs = 0, idleUs = 0;
+static unsigned long markUs = 0;  // Start of the current pass or wait
+static volatile bool idling = false;
+static uint64_t panelMs[3] = {};
+static unsigned long panelSince = 0;
+static unsigned long statIdles = 0, statWoken = 0;
+
+static const char* const nightModeNames[NIGHT_MODE_COUNT] = {"none", "dim", "blank"};
+
+const char* nightModeName(int mode) {
+  return (mode >= 0 && mode < NIGHT_MODE_COUNT) ? nightModeNames[mode] : nightModeNames[NIGHT_NONE];
+}
+
+int nightModeFromName(const String& name) {
+  for (int i = 0; i < NIGHT_MODE_COUNT; i++) {
+    if (name == nightModeNames[i]) return i;
+  }
+  return NIGHT_NONE;
+}
+
+// --- HELPER: Is it night by the device clock? ---
+static bool inNightHours() {
+  if (nightMode == NIGHT_NONE || nightStartHour == nightEndHour) return false;
+  time_t now = time(nullptr);
+  if (now < 1672531200L) return false; // Not synced yet
+  struct tm local;
+  localtime_r(&now, &local);
+  if (nightStartHour < nightEndHour) return local.tm_hour >= nightStartHour && local.tm_hour < nightEndHour;
+  return local.tm_hour >= nightStartHour || local.tm_hour < nightEndHour; // Across midnight
+}
+
+// --- HELPER: Backlight level, and the panel's sleep mode when it is off ---
+static void setPanel(PanelLevel level) {
+  if (level == panel) return;
+  unsigned long now = millis();
+  panelMs[panel] += now - panelSince;
+  panelSince = now;
+
+  if (panel == PANEL_OFF) {
+    tft.writecommand(TFT_SLPOUT); // The panel kept its memory; show it again
+    delay(5);                     // ILI9341: before the next command
+  }
+  if (noSleepLock != nullptr && level == PANEL_DIM) esp_pm_lock_acquire(noSleepLock);
+  if (noSleepLock != nullptr && panel == PANEL_DIM) esp_pm_lock_release(noSleepLock);
+  ledcWrite(POWER_BACKLIGHT_CHANNEL, level == PANEL_FULL ? 255 : (level == PANEL_DIM ? POWER_NIGHT_DIM_LEVEL : 0));
+  if (level == PANEL_OFF) tft.writecommand(TFT_SLPIN);
+  panel = level;
+}
+
+void startPower() {
+  loopTask = xTaskGetCurrentTaskHandle();
+  markUs = micros();
+  panelSince = millis();
+
+  // 1. Clock: scale down whenever every task waits, and light sleep between beacons
+  maxMhz = getCpuFrequencyMhz();
+  minMhz = POWER_CPU_MIN_MHZ;
+  esp_pm_config_esp32_t pm = {};
+  pm.max_freq_mhz = maxMhz;
+  pm.min_freq_mhz = minMhz;
+  pm.light_sleep_enable = true;
+  if (esp_pm_configure(&pm) == ESP_OK) {
+    dynamicClock = true;
+    powerMode = "dfs+light_sleep";
+  } else {
+    pm.light_sleep_enable = false; // Needs tickless idle in the core's build
+    if (esp_pm_configure(&pm) == ESP_OK) {
+      dynamicClock = true;
+      powerMode = "dfs";
+    } else {
+      powerMode = "night_clock"; // No power management in the core's build
+    }
+  }
+  if (dynamicClock) esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "backlight", &noSleepLock);
+
+  // 2. A press wakes the chip (touch_input.cpp enables TOUCH_IRQ as a wake-up pin)
+  esp_sleep_enable_gpio_wakeup();
+
+  // 3. Radio: wake for beacons only
+  WiFi.setSleep(WIFI_PS_MIN_MODEM);
+
+  // 4. Backlight on a PWM channel so it can dim
+  ledcSetup(POWER_BACKLIGHT_CHANNEL, POWER_BACKLIGHT_FREQ, 8);
+  ledcAttachPin(POWER_BACKLIGHT_PIN, POWER_BACKLIGHT_CHANNEL);
+  ledcWrite(POWER_BACKLIGHT_CHANNEL, 255);
+
+  Serial.printf("[power] %s, %u-%u MHz, night profile %s %02d:00-%02d:00\n", powerMode, minMhz, maxMhz,
+                nightModeName(nightMode), nightStartHour, nightEndHour);
+}
+
+void powerWake() {
+  if (loopTask != nullptr) xTaskNotifyGive(loopTask);
+}
+
+void powerWakeAt(unsigned long at) {
+  if (!wakeAtSet || (long)(at - wakeAt) < 0) wakeAt = at;
+  wakeAtSet = true;
+}
+
+bool powerTimerDue(unsigned long& last, unsigned long periodMs) {
+  unsigned long now = millis();
+  bool due = now - last >= periodMs;
+  if (due) last = now;
+  powerWakeAt(last + periodMs);
+  return due;
+}
+
+void powerIdle() {
+  long waitMs = POWER_MAX_IDLE_MS;
+  if (wakeAtSet) waitMs = min(waitMs, (long)(wakeAt - millis()));
+  wakeAtSet = false;
+  if (waitMs <= 0 || loopTask == nullptr) return; // Due already: straight into the next pass
+
+  unsigned long idleFrom = micros();
+  activeUs += idleFrom - markUs;
+  idling = true;
+  statIdles++;
+  if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) > 0) statWoken++;
+  markUs = micros();
+  idleUs += markUs - idleFrom;
+  idling = false;
+}
+
+bool powerUpdate() {
+  bool nightNow = inNightHours();
+  if (nightNow != night) {
+    night = nightNow;
+    WiFi.setSleep(night ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+    if (!dynamicClock) setCpuFrequencyMhz(night ? POWER_CPU_MIN_MHZ : maxMhz);
+    Serial.printf("[power] Night profile %s\n", night ? nightModeName(nightMode) : "over");
+  }
+
+  if (lit && (long)(millis() - litUntil) >= 0) lit = false;
+  if (lit) powerWakeAt(litUntil);
+
+  PanelLevel level = PANEL_FULL;
+  if (night && !lit) level = (nightMode == NIGHT_BLANK) ? PANEL_OFF : PANEL_DIM;
+  bool relit = panel == PANEL_OFF && level != PANEL_OFF;
+  setPanel(level);
+  return relit;
+}
+
+bool powerPanelOn() {
+  return panel != PANEL_OFF;
+}
+
+bool powerTouched() {
+  if (!night) return false;
+  bool dark = panel == PANEL_OFF;
+  lit = true;
+  litUntil = millis() + POWER_NIGHT_WAKE_MS;
+  setPanel(PANEL_FULL);
+  return dark;
+}
+
+PowerStats getPowerStats() {
+  PowerStats stats;
+  stats.mode = powerMode;
+  stats.maxMhz = maxMhz;
+  stats.minMhz = dynamicClock ? minMhz : (night ? POWER_CPU_MIN_MHZ : maxMhz);
+  // Add the pass or wait in progress to the state it is in
+  unsigned long sinceUs = loopTask != nullptr ? micros() - markUs : 0;
+  stats.activeMs = (activeUs + (idling ? 0 : sinceUs)) / 1000;
+  stats.idleMs = (idleUs + (idling ? sinceUs : 0)) / 1000;
+  uint64_t current = millis() - panelSince;
+  stats.panelFullMs = panelMs[PANEL_FULL] + (panel == PANEL_FULL ? current : 0);
+  stats.panelDimMs = panelMs[PANEL_DIM] + (panel == PANEL_DIM ? current : 0);
+  stats.panelOffMs = panelMs[PANEL_OFF] + (panel == PANEL_OFF ? current : 0);
+  stats.idles = statIdles;
+  stats.woken = statWoken;
+  stats.night = night;
+  return stats;
+}
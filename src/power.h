@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// POWER
+// loop() no longer spins: each pass ends in powerIdle(), which blocks
+// the loop() task until the earliest deadline any step asked for this
+// pass (the next rotation, tape step, live price check...) or until
+// another task has work for it: a gesture, a web command or a finished
+// fetch call powerWake(). With loop() blocked and the other tasks
+// waiting on their own queues, FreeRTOS runs the idle task, and the
+// power manager drops the CPU to POWER_CPU_MIN_MHZ and, between WiFi
+// beacons, into automatic light sleep. TOUCH_IRQ stays a wake-up source,
+// so a press is still sampled within a millisecond or so.
+//
+// The radio uses modem sleep: it wakes for the AP's beacons (minimum
+// modem sleep by day, maximum at night), which costs some latency on
+// incoming web requests and nothing else.
+//
+// The night profile (nightMode, nightStartHour..nightEndHour, device
+// time) dims the backlight or blanks the panel. While blank, rotation
+// and drawing stop; the first gesture only lights the panel, for
+// POWER_NIGHT_WAKE_MS. A dimmed backlight is a PWM that light sleep
+// would freeze, so dimming holds light sleep off (the clock still
+// scales).
+//
+// Time is accounted to the state the device was in: loop() active or
+// idle, and the backlight full, dimmed or off (/power_stats).
+// =========================================================================
+
+enum NightMode {
+  NIGHT_NONE,  // No night profile
+  NIGHT_DIM,   // Backlight at POWER_NIGHT_DIM_LEVEL
+  NIGHT_BLANK, // Backlight off, panel asleep, nothing drawn
+  NIGHT_MODE_COUNT
+};
+
+// "none", "dim", "blank" (settings.json, /set_power)
+const char* nightModeName(int mode);
+int nightModeFromName(const String& name);
+
+// Sets up frequency scaling, light sleep, modem sleep and the backlight.
+// Call once from setup(), after tft.init() and WiFi.begin(): it also
+// makes the calling task (loop()'s) the one powerIdle() puts to sleep.
+void startPower();
+
+// Any task, not ISRs: loop() has work to do, end its powerIdle() now.
+void powerWake();
+
+// loop() task: run the next pass by millis() == `at` at the latest.
+// Deadlines are forgotten once powerIdle() has waited for them.
+void powerWakeAt(unsigned long at);
+
+// loop() task, for steps that run every `periodMs`: true (and `last`
+// set to now) once the period has passed, otherwise false. Either way
+// the next due time is handed to powerWakeAt().
+bool powerTimerDue(unsigned long& last, unsigned long periodMs);
+
+// End of loop(): sleeps until the earliest deadline, powerWake() or
+// POWER_MAX_IDLE_MS, whichever comes first.
+void powerIdle();
+
+// Start of loop(): applies the night profile to the backlight. True if
+// the panel has just been lit again, so the page on it may be stale.
+bool powerUpdate();
+
+// False while the night profile has the panel blanked
+bool powerPanelOn();
+
+// loop() task, for every gesture: lights the panel for
+// POWER_NIGHT_WAKE_MS at night. True if it was dark, in which case the
+// gesture should do nothing else.
+bool powerTouched();
+
+struct PowerStats {
+  const char* mode;     // What startPower() could set up
+  uint32_t maxMhz;      // Clock while any task runs
+  uint32_t minMhz;      // ...and while all of them wait
+  uint64_t activeMs;    // loop() passes
+  uint64_t idleMs;      // loop() waiting in powerIdle()
+  uint64_t panelFullMs; // Backlight at full brightness
+  uint64_t panelDimMs;
+  uint64_t panelOffMs;
+  unsigned long idles;      // powerIdle() waits
+  unsigned long woken;      // ...ended early by powerWake()
+  bool night;               // In the night hours now
+};
+PowerStats getPowerStats();
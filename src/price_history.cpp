@@ -0,0 +1,202 @@
+#include "price_history.h"
+#include "config.h"     // For PRICE_HISTORY_*, SPARK_COLUMNS
+
+// 6 bytes per sample
+struct __attribute__((packed)) PriceSample {
+  uint16_t minutes; // Since the ring's baseTime
+  float price;
+};
+
+struct PriceRing {
+  String ticker;
+  time_t baseTime = 0;              // Epoch seconds of minutes == 0
+  std::vector<PriceSample> samples; // Sized to the ring's capacity
+  size_t head = 0;                  // Next slot to write
+  size_t count = 0;
+  uint32_t nextSeq = 0;             // Sequence number of the next sample
+
+  uint32_t oldestSeq() const { return nextSeq - count; }
+  const PriceSample& at(size_t i) const { // 0 = oldest
+    return samples[(head + samples.size() - count + i) % samples.size()];
+  }
+};
+
+// Guards everything below
+static SemaphoreHandle_t historyLock = nullptr;
+static std::vector<PriceRing> rings;
+
+// Sparkline columns for one ticker (the one on screen). Column i covers
+// samples [sparkFirstSeq + i * sparkSpan, + sparkSpan); when they run
+// out, neighbouring columns are merged and the span doubles.
+static String sparkTicker;
+static SparkColumn sparkCols[SPARK_COLUMNS];
+static size_t sparkCount = 0;
+static uint32_t sparkSpan = 1;
+static uint32_t sparkFirstSeq = 0;
+
+static PriceRing* findRing(const String& ticker) {
+  for (PriceRing& ring : rings) {
+    if (ring.ticker == ticker) return &ring;
+  }
+  return nullptr;
+}
+
+// --- HELPER: Fold one new sample into the sparkline columns ---
+static void sparkAppend(uint32_t seq, float price) {
+  size_t col = (seq - sparkFirstSeq) / sparkSpan;
+  while (col >= SPARK_COLUMNS) {
+    // Out of columns: halve the resolution
+    for (size_t i = 0; i < SPARK_COLUMNS / 2; i++) {
+      SparkColumn a = sparkCols[2 * i];
+      SparkColumn b = sparkCols[2 * i + 1];
+      if (2 * i + 1 >= sparkCount) b = a;
+      sparkCols[i] = {min(a.lo, b.lo), max(a.hi, b.hi), b.last};
+    }
+    sparkCount = (sparkCount + 1) / 2;
+    sparkSpan *= 2;
+    col = (seq - sparkFirstSeq) / sparkSpan;
+  }
+
+  if (col >= sparkCount) {
+    sparkCols[col] = {price, price, price};
+    sparkCount = col + 1;
+  } else {
+    SparkColumn& c = sparkCols[col];
+    if (price < c.lo) c.lo = price;
+    if (price > c.hi) c.hi = price;
+    c.last = price;
+  }
+}
+
+// --- HELPER: Drop leading columns whose samples have all been evicted ---
+// The first column can still hold up to sparkSpan - 1 evicted samples.
+static void sparkTrim(const PriceRing& ring) {
+  size_t drop = 0;
+  while (drop < sparkCount && ring.oldestSeq() >= sparkFirstSeq + sparkSpan * (drop + 1)) drop++;
+  if (drop == 0) return;
+  memmove(sparkCols, sparkCols + drop, (sparkCount - drop) * sizeof(SparkColumn));
+  sparkCount -= drop;
+  sparkFirstSeq += sparkSpan * drop;
+}
+
+// --- HELPER: Build the columns from scratch (new ticker on screen) ---
+static void sparkRebuild(const PriceRing& ring) {
+  sparkTicker = ring.ticker;
+  sparkCount = 0;
+  sparkSpan = 1;
+  sparkFirstSeq = ring.oldestSeq();
+  while (ring.count / sparkSpan >= SPARK_COLUMNS) sparkSpan *= 2;
+  for (size_t i = 0; i < ring.count; i++) {
+    sparkAppend(sparkFirstSeq + i, ring.at(i).price);
+  }
+}
+
+// --- HELPER: Reallocate a ring, keeping its newest samples ---
+static void resizeRing(PriceRing& ring, size_t capacity) {
+  if (ring.samples.size() == capacity) return;
+
+  size_t keep = min(ring.count, capacity);
+  std::vector<PriceSample> resized(capacity);
+  for (size_t i = 0; i < keep; i++) {
+    resized[i] = ring.at(ring.count - keep + i);
+  }
+  ring.samples.swap(resized);
+  ring.count = keep;
+  ring.head = capacity ? keep % capacity : 0;
+  if (ring.ticker == sparkTicker) sparkTicker = ""; // Rebuilt on next draw
+}
+
+static void clearRing(PriceRing& ring) {
+  ring.head = 0;
+  ring.count = 0;
+  if (ring.ticker == sparkTicker) sparkTicker = "";
+}
+
+// --- Public Functions ---
+
+void priceHistorySync(const std::vector<String>& tickers) {
+  if (historyLock == nullptr) historyLock = xSemaphoreCreateMutex();
+  xSemaphoreTake(historyLock, portMAX_DELAY);
+
+  // Split the budget evenly; the spark columns come out of it first
+  size_t perTicker = (PRICE_HISTORY_BUDGET_BYTES - sizeof(sparkCols)) / max((size_t)1, tickers.size());
+  size_t capacity = min((size_t)PRICE_HISTORY_MAX_SAMPLES, perTicker / sizeof(PriceSample));
+
+  std::vector<PriceRing> synced;
+  synced.reserve(tickers.size());
+  for (const String& ticker : tickers) {
+    PriceRing* existing = findRing(ticker);
+    if (existing != nullptr) {
+      synced.push_back(std::move(*existing));
+    } else {
+      synced.emplace_back();
+      synced.back().ticker = ticker;
+    }
+  }
+  rings.swap(synced);
+
+  // Shrink first so the old and new rings never add up to over budget
+  for (PriceRing& ring : rings) {
+    if (ring.samples.size() > capacity) resizeRing(ring, capacity);
+  }
+  for (PriceRing& ring : rings) resizeRing(ring, capacity);
+  if (findRing(sparkTicker) == nullptr) sparkTicker = "";
+
+  xSemaphoreGive(historyLock);
+  Serial.printf("Price history: %u tickers x %u samples (%u bytes)\n", (unsigned)tickers.size(), (unsigned)capacity,
+                (unsigned)(tickers.size() * capacity * sizeof(PriceSample) + sizeof(sparkCols)));
+}
+
+void priceHistoryAdd(const String& ticker, float price) {
+  if (historyLock == nullptr) return;
+  xSemaphoreTake(historyLock, portMAX_DELAY);
+
+  PriceRing* ring = findRing(ticker);
+  if (ring == nullptr || ring->samples.empty()) {
+    xSemaphoreGive(historyLock);
+    return;
+  }
+
+  time_t now = time(nullptr);
+  if (ring->count > 0) {
+    time_t newest = ring->baseTime + ring->at(ring->count - 1).minutes * 60L;
+    if (now / 86400 != newest / 86400) clearRing(*ring); // New trading day
+  }
+  if (ring->count == 0) ring->baseTime = now;
+
+  // Rebase before the 16-bit minute offset overflows (~45 days)
+  long minutes = (now - ring->baseTime) / 60;
+  if (minutes > 0xFFFF) {
+    uint16_t shift = ring->at(0).minutes;
+    for (PriceSample& s : ring->samples) s.minutes = (s.minutes > shift) ? s.minutes - shift : 0;
+    ring->baseTime += shift * 60L;
+    minutes = (now - ring->baseTime) / 60;
+    if (minutes > 0xFFFF) minutes = 0xFFFF;
+  }
+
+  ring->samples[ring->head] = {(uint16_t)minutes, price};
+  ring->head = (ring->head + 1) % ring->samples.size();
+  if (ring->count < ring->samples.size()) ring->count++;
+  uint32_t seq = ring->nextSeq++;
+
+  if (ticker == sparkTicker) {
+    sparkTrim(*ring);
+    sparkAppend(seq, price);
+  }
+  xSemaphoreGive(historyLock);
+}
+
+size_t priceHistorySparkline(const String& ticker, SparkColumn* out) {
+  if (historyLock == nullptr) return 0;
+  xSemaphoreTake(historyLock, portMAX_DELAY);
+
+  size_t count = 0;
+  PriceRing* ring = findRing(ticker);
+  if (ring != nullptr) {
+    if (ticker != sparkTicker) sparkRebuild(*ring);
+    memcpy(out, sparkCols, sparkCount * sizeof(SparkColumn));
+    count = sparkCount;
+  }
+  xSemaphoreGive(historyLock);
+  return count;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+// =========================================================================
+// INTRADAY PRICE HISTORY
+// A fixed-capacity ring of (time, price) samples for each ticker in
+// stockTickerList, fed by every successful quote fetch and drawn as a
+// sparkline on the stock page. A ring starts over on a new (UTC) day.
+//
+// All rings share PRICE_HISTORY_BUDGET_BYTES: adding tickers shrinks
+// every ring (keeping the newest samples), it never grows the total.
+//
+// The sparkline's per-column min/max is kept up to date as samples
+// arrive, so drawing it costs SPARK_COLUMNS, not the ring size.
+// =========================================================================
+
+// One sparkline column: the range and closing price of the samples in it
+struct SparkColumn {
+  float lo, hi, last;
+};
+
+// Creates, resizes and drops rings to match the ticker list. Safe to
+// call from the web server task.
+void priceHistorySync(const std::vector<String>& tickers);
+
+// Records a fetched price for `ticker` (ignored if it isn't in the list).
+void priceHistoryAdd(const String& ticker, float price);
+
+// Copies the sparkline columns for `ticker` into `out` (SPARK_COLUMNS
+// long), oldest first. Returns how many are in use.
+size_t priceHistorySparkline(const String& ticker, SparkColumn* out);
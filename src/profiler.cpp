@@ -0,0 +1,146 @@
+#include "profiler.h"
+
+#if RENDER_PROFILER
+
+#include "globals.h" // For CAT_* colors
+#include "render.h"  // For Gfx
+#include "theme.h"   // For themeColor
+#include <ArduinoJson.h>
+
+struct ProfileCounter {
+  unsigned long calls = 0;
+  unsigned long pixels = 0;
+  unsigned long us = 0;
+};
+
+static const char* primitiveNames[PROF_PRIMITIVE_COUNT] = {
+  "text", "fill_rect", "round_rect", "line", "fast_line", "circle", "fill_circle", "icon",
+  "frame_clear", "tile_hash", "spi_push", "mirror", "fade", "scroll",
+};
+static const char* pageNames[PROF_PAGE_COUNT] = {"stocks", "weather", "hourly", "watchlist", "tape", "transition", "direct"};
+
+// Written by the render task, read by the web server task (counters only)
+static ProfileCounter counters[PROF_PAGE_COUNT][PROF_PRIMITIVE_COUNT];
+static unsigned long pageFrames[PROF_PAGE_COUNT];
+static unsigned long pageUs[PROF_PAGE_COUNT];
+
+// The frame in progress
+static TaskHandle_t frameTask = nullptr;
+static int framePage = PROF_PAGE_DIRECT;
+static unsigned long frameStarted = 0;
+
+// Frame time and rate, for the overlay
+#define FPS_HISTORY 32 // Above any rate the panel can reach
+static unsigned long lastFrameUs = 0;
+static unsigned long frameEndMs[FPS_HISTORY];
+static size_t frameEndNext = 0;
+static bool overlayOn = false;
+
+void profilerRecord(ProfilePrimitive primitive, uint32_t pixels, uint32_t us) {
+  // Calls from another task while a frame is composed are not the frame's
+  bool inFrame = frameTask != nullptr && xTaskGetCurrentTaskHandle() == frameTask;
+  ProfileCounter& counter = counters[inFrame ? framePage : PROF_PAGE_DIRECT][primitive];
+  counter.calls++;
+  counter.pixels += pixels;
+  counter.us += us;
+}
+
+void profilerFrameBegin(int page) {
+  framePage = (page >= 0 && page < PROF_PAGE_COUNT) ? page : PROF_PAGE_DIRECT;
+  frameTask = xTaskGetCurrentTaskHandle();
+  frameStarted = micros();
+}
+
+void profilerFrameEnd() {
+  unsigned long now = micros();
+  lastFrameUs = now - frameStarted;
+  pageFrames[framePage]++;
+  pageUs[framePage] += lastFrameUs;
+  frameTask = nullptr;
+  frameEndMs[frameEndNext] = millis();
+  frameEndNext = (frameEndNext + 1) % FPS_HISTORY;
+}
+
+// --- HELPER: Frames finished in the last second ---
+// The screen only redraws when something changes, so an idle page reads
+// 0-1 and a transition about TRANSITION_FPS.
+static unsigned long framesPerSecond() {
+  unsigned long now = millis(), count = 0;
+  for (unsigned long ended : frameEndMs) {
+    if (ended != 0 && now - ended < 1000) count++;
+  }
+  return count;
+}
+
+bool profilerOverlayOn() {
+  return overlayOn;
+}
+
+void profilerDrawOverlay(Gfx target) {
+  if (!overlayOn) return;
+  char text[32];
+  snprintf(text, sizeof(text), "%lu.%lu ms %lu fps", lastFrameUs / 1000, lastFrameUs / 100 % 10, framesPerSecond());
+  target.fillRect(0, 0, PROFILE_OVERLAY_W, PROFILE_OVERLAY_H, themeColor(SLOT_BLACK));
+  target.setTextFont(1);
+  target.setTextSize(1);
+  target.setTextDatum(TL_DATUM);
+  target.setTextColor(CAT_YELLOW, themeColor(SLOT_BLACK));
+  target.drawString(text, 2, 1);
+}
+
+// --- HELPER: {"calls", "pixels", "us"} ---
+static void addCounter(JsonObject parent, const char* name, const ProfileCounter& counter) {
+  JsonObject o = parent.createNestedObject(name);
+  o["calls"] = counter.calls;
+  o["pixels"] = counter.pixels;
+  o["us"] = counter.us;
+}
+
+String profilerJson(bool reset, int overlay) {
+  if (overlay >= 0) overlayOn = overlay != 0;
+
+  DynamicJsonDocument doc(8192);
+  unsigned long frames = 0;
+  for (int page = 0; page < PROF_PAGE_COUNT; page++) frames += pageFrames[page];
+  doc["frames"] = frames;
+  doc["last_frame_us"] = lastFrameUs;
+  doc["fps"] = framesPerSecond();
+  doc["overlay"] = overlayOn;
+
+  // Every page added up, then each page's own calls
+  JsonObject totals = doc.createNestedObject("primitives");
+  for (int p = 0; p < PROF_PRIMITIVE_COUNT; p++) {
+    ProfileCounter sum;
+    for (int page = 0; page < PROF_PAGE_COUNT; page++) {
+      sum.calls += counters[page][p].calls;
+      sum.pixels += counters[page][p].pixels;
+      sum.us += counters[page][p].us;
+    }
+    addCounter(totals, primitiveNames[p], sum);
+  }
+
+  JsonObject pages = doc.createNestedObject("pages");
+  for (int page = 0; page < PROF_PAGE_COUNT; page++) {
+    JsonObject o = pages.createNestedObject(pageNames[page]);
+    o["frames"] = pageFrames[page];
+    o["us"] = pageUs[page];
+    JsonObject primitives = o.createNestedObject("primitives");
+    for (int p = 0; p < PROF_PRIMITIVE_COUNT; p++) {
+      if (counters[page][p].calls > 0) addCounter(primitives, primitiveNames[p], counters[page][p]);
+    }
+  }
+
+  if (reset) {
+    for (int page = 0; page < PROF_PAGE_COUNT; page++) {
+      for (int p = 0; p < PROF_PRIMITIVE_COUNT; p++) counters[page][p] = ProfileCounter();
+      pageFrames[page] = 0;
+      pageUs[page] = 0;
+    }
+  }
+
+  String json;
+  serializeJson(doc, json);
+  return json;
+}
+
+#endif // RENDER_PROFILER
@@ -0,0 +1,97 @@
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "config.h" // For RENDER_PROFILER
+
+// =========================================================================
+// RENDER PROFILER
+// With RENDER_PROFILER set to 1, every drawing call made through gfx()
+// (see Gfx in render.h) is timed and counted per primitive type and per
+// page (the page the frame belongs
+// to; transitions and direct-to-panel drawing have their own rows). The
+// renderer adds its own stages (frame clear, tile hashing, SPI push
+// including the palette lookup, mirror encoding, fades) so SPI time can
+// be told apart from composing.
+//
+//   GET /render_profile               Counters as JSON
+//   GET /render_profile?reset=1       ...then zeroes them
+//   GET /render_profile?overlay=1|0   Frame time / FPS box in the top-left
+//
+// "pixels" is the area each call asked for, before clipping.
+//
+// With RENDER_PROFILER 0 (the default) none of this is compiled: gfx()
+// calls go straight through and the PROFILE_* macros expand to nothing
+// (or, for PROFILE_CALL, to the bare call).
+// =========================================================================
+
+enum ProfilePrimitive {
+  PROF_TEXT,        // drawString
+  PROF_FILL_RECT,
+  PROF_ROUND_RECT,  // fillRoundRect
+  PROF_LINE,        // drawLine
+  PROF_FAST_LINE,   // drawFastHLine / drawFastVLine
+  PROF_CIRCLE,      // drawCircle
+  PROF_FILL_CIRCLE,
+  PROF_ICON,        // Cached icon blit
+  PROF_FRAME_CLEAR, // Renderer stages from here on
+  PROF_TILE_HASH,
+  PROF_SPI_PUSH,
+  PROF_MIRROR,
+  PROF_FADE,        // Blended palette per transition frame
+  PROF_SCROLL,      // Ticker tape rows shifted in the frame
+  PROF_PRIMITIVE_COUNT
+};
+
+// Rows after the five Page values
+enum {
+  PROF_PAGE_TRANSITION = 5, // Animation frames between two pages
+  PROF_PAGE_DIRECT,         // Outside renderFrame(): boot and web server messages
+  PROF_PAGE_COUNT
+};
+
+#if RENDER_PROFILER
+
+// Adds one call to the counters of the page being rendered
+void profilerRecord(ProfilePrimitive primitive, uint32_t pixels, uint32_t us);
+
+// Bracket one frame, partial update or animation frame (render task)
+void profilerFrameBegin(int page);
+void profilerFrameEnd();
+
+// Draws the frame time / FPS box if it is on; `target` is in screen coordinates
+#define PROFILE_OVERLAY_W 96
+#define PROFILE_OVERLAY_H 10
+class Gfx;
+void profilerDrawOverlay(Gfx target);
+bool profilerOverlayOn();
+
+// JSON for /render_profile; `overlay` is -1 to leave it as it is
+String profilerJson(bool reset, int overlay);
+
+// Times the enclosing block
+class ProfileScope {
+public:
+  ProfileScope(ProfilePrimitive primitive, uint32_t pixels) : primitive(primitive), pixels(pixels), started(micros()) {}
+  ~ProfileScope() { profilerRecord(primitive, pixels, micros() - started); }
+
+private:
+  ProfilePrimitive primitive;
+  uint32_t pixels;
+  unsigned long started;
+};
+
+#define PROFILE_SCOPE(primitive, pixels) ProfileScope profileScope_(primitive, pixels)
+#define PROFILE_CALL(primitive, pixels, ...) do { ProfileScope profileScope_(primitive, pixels); __VA_ARGS__; } while (0)
+#define PROFILE_FRAME_BEGIN(page) profilerFrameBegin(page)
+#define PROFILE_FRAME_END() profilerFrameEnd()
+#define PROFILE_DRAW_OVERLAY(target) profilerDrawOverlay(target)
+
+#else
+
+#define PROFILE_SCOPE(primitive, pixels) do {} while (0)
+#define PROFILE_CALL(primitive, pixels, ...) __VA_ARGS__
+#define PROFILE_FRAME_BEGIN(page) do {} while (0)
+#define PROFILE_FRAME_END() do {} while (0)
+#define PROFILE_DRAW_OVERLAY(target) do {} while (0)
+
+#endif
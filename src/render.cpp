@@ -0,0 +1,462 @@
+#include "render.h"
+#include "globals.h"    // For tft, CAT_BG
+#include "config.h"     // For SCREEN_*, RENDER_*
+#include "screen_mirror.h" // For mirrorDirty
+#include "touch_input.h" // For touchEventPending
+#include <atomic>
+
+#define TILES_X (SCREEN_WIDTH / RENDER_TILE_W)
+#define TILES_Y (SCREEN_HEIGHT / RENDER_TILE_H)
+#define ROW_BYTES (SCREEN_WIDTH / 2)               // Two pixels a byte, the left one in the high nibble
+#define CHUNK_PIXELS (SCREEN_WIDTH * RENDER_TILE_H) // Per push buffer
+
+static TFT_eSprite frame(&tft);
+static std::atomic<bool> frameReady(false);
+static SemaphoreHandle_t frameLock = nullptr; // Held while the frame is written, and by renderReadPixels()
+
+// Pixels go out through two RGB565 buffers: one is filled from the
+// frame while DMA sends the other
+static uint16_t* chunks[2] = {nullptr, nullptr};
+static int nextChunk = 0;
+static bool dmaReady = false;
+static uint16_t wire[16]; // Palette the frame is pushed through, in panel byte order
+
+// Pixel hash of every tile as it is on the panel now
+static uint32_t tileHash[TILES_Y][TILES_X];
+static std::atomic<bool> panelTouched(true);
+
+static TaskHandle_t renderTask = nullptr; // Task inside renderFrame()
+static RenderStats stats;
+static uint32_t frameId = 1;
+
+// The last full page, kept so the next one can animate away from it
+static std::function<void()> lastDraw;
+static RenderTransition pendingTransition = TRANSITION_NONE;
+
+// --- HELPER: The frame inside a render on its task, otherwise the panel ---
+Gfx gfx() {
+  if (renderTask != nullptr && xTaskGetCurrentTaskHandle() == renderTask) return Gfx(frame, true, true);
+  panelTouched = true;
+  return Gfx(tft, false, true);
+}
+
+void renderInvalidate() {
+  panelTouched = true;
+}
+
+uint32_t renderFrameId() {
+  return frameId;
+}
+
+bool renderPanelTouched() {
+  return panelTouched;
+}
+
+void renderTransitionNext(RenderTransition transition) {
+  pendingTransition = transition;
+}
+
+bool renderTransitionPending() {
+  return pendingTransition != TRANSITION_NONE;
+}
+
+// --- HELPER: FNV-1a over one tile of the frame (never 0, see renderScroll) ---
+static uint32_t hashTile(int x, int y) {
+  const uint8_t* bytes = (const uint8_t*)frame.getPointer();
+  uint32_t hash = 2166136261u;
+  for (int row = 0; row < RENDER_TILE_H; row++) {
+    const uint8_t* p = bytes + (y + row) * ROW_BYTES + x / 2;
+    for (int col = 0; col < RENDER_TILE_W / 2; col++) {
+      hash = (hash ^ p[col]) * 16777619u;
+    }
+  }
+  return hash ? hash : 1;
+}
+
+// --- HELPER: Allocate the frame and the push buffers on first use ---
+static bool ensureFrame() {
+  if (!frameReady) {
+    frame.setColorDepth(4);
+    bool ok = frame.createSprite(SCREEN_WIDTH, SCREEN_HEIGHT) != nullptr;
+    for (uint16_t*& chunk : chunks) {
+      if (ok && chunk == nullptr) chunk = (uint16_t*)malloc(CHUNK_PIXELS * sizeof(uint16_t));
+      ok = ok && chunk != nullptr;
+    }
+    if (!ok) {
+      Serial.println("[render] Frame allocation failed, drawing direct");
+      frame.deleteSprite();
+      for (uint16_t*& chunk : chunks) {
+        free(chunk);
+        chunk = nullptr;
+      }
+      return false;
+    }
+    dmaReady = tft.initDMA();
+    frameLock = xSemaphoreCreateMutex();
+    frameReady = true;
+  }
+  return true;
+}
+
+// --- HELPER: Bracket writes to the frame, so the web server never reads half a row ---
+static void lockFrame() {
+  xSemaphoreTake(frameLock, portMAX_DELAY);
+}
+static void unlockFrame() {
+  xSemaphoreGive(frameLock);
+}
+
+// --- HELPER: Record one frame or partial update ---
+static void noteUpdate(const char* what, unsigned long bytes, unsigned long rects, unsigned long started) {
+  stats.frames++;
+  stats.lastBytes = bytes;
+  stats.lastRects = rects;
+  stats.lastMs = millis() - started;
+  stats.totalBytes += bytes;
+  stats.fullBytes += SCREEN_WIDTH * SCREEN_HEIGHT * 2;
+  Serial.printf("[render] %s: %lu bytes in %lu rects (%lu%% of a full repaint), %lu ms\n", what, bytes, rects,
+                bytes * 100 / (SCREEN_WIDTH * SCREEN_HEIGHT * 2), stats.lastMs);
+}
+
+// =====================================================
+// --- PUSHING ---
+// The frame holds theme slots; they become RGB565 only here, a buffer
+// at a time, through `wire`.
+// =====================================================
+
+// --- HELPER: Load the theme palette into `wire`, blended toward the background (255 = as is) ---
+static void loadWirePalette(uint8_t alpha) {
+  const uint16_t* palette = themePalette();
+  for (int slot = 0; slot < 16; slot++) {
+    uint16_t color = (alpha == 255) ? palette[slot] : tft.alphaBlend(alpha, palette[slot], palette[SLOT_BG]);
+    wire[slot] = (color >> 8) | (color << 8);
+  }
+}
+
+// --- HELPER: Bracket a run of pushRect() calls ---
+static bool pushSwap = false;
+static void beginPush() {
+  pushSwap = tft.getSwapBytes();
+  tft.setSwapBytes(false); // The buffers are already in panel order
+  tft.startWrite();
+}
+static void endPush() {
+  if (dmaReady) tft.dmaWait();
+  tft.endWrite();
+  tft.setSwapBytes(pushSwap);
+}
+
+// --- HELPER: Send a rect of the frame to the panel (and tell the mirror); returns the buffers used ---
+static unsigned long pushRect(int x, int y, int w, int h, bool capture, unsigned long& bytes) {
+  const uint8_t* frameBytes = (const uint8_t*)frame.getPointer();
+  int rows = CHUNK_PIXELS / w;
+  unsigned long count = 0;
+
+  for (int top = y; top < y + h; top += rows, count++) {
+    int n = min(rows, y + h - top);
+    uint16_t* buf = chunks[nextChunk];
+    nextChunk ^= 1;
+
+    // Look every pixel up in the palette (the other buffer may still be on the wire), then send it
+    {
+      PROFILE_SCOPE(PROF_SPI_PUSH, w * n);
+      uint16_t* out = buf;
+      for (int row = top; row < top + n; row++) {
+        const uint8_t* line = frameBytes + row * ROW_BYTES;
+        for (int col = x; col < x + w; col++) {
+          uint8_t pair = line[col >> 1];
+          *out++ = wire[(col & 1) ? (pair & 0x0F) : (pair >> 4)];
+        }
+      }
+      if (dmaReady) {
+        tft.dmaWait(); // The previous buffer has to be out first
+        tft.pushImageDMA(x, top, w, n, buf);
+      } else {
+        tft.pushImage(x, top, w, n, buf);
+      }
+    }
+    bytes += w * n * 2;
+  }
+  if (capture) mirrorDirty(x, y, w, h); // Viewers get it from the frame at their own rate
+  return count;
+}
+
+// =====================================================
+// --- TRANSITIONS ---
+// Every animation frame is composed in the frame from the two pages'
+// draw functions and pushed whole, a buffer at a time by DMA. A fade
+// only composes each page once: its frames differ in palette only.
+// =====================================================
+
+// --- HELPER: Draw a page into the frame with its left edge at screen column dx ---
+static void composePage(int dx, const std::function<void()>& draw) {
+  frame.setViewport(dx, 0, SCREEN_WIDTH, SCREEN_HEIGHT, true);
+  draw();
+  frame.resetViewport();
+}
+
+// --- HELPER: Compose and push one animation frame, progress 0..1 ---
+// `composed` is the page of a fade in the frame: 0 none, 1 old, 2 new.
+static void pushTransitionFrame(RenderTransition transition, float progress, const std::function<void()>& from,
+                                const std::function<void()>& to, int& composed) {
+  float eased = 1.0 - (1.0 - progress) * (1.0 - progress) * (1.0 - progress); // Ease-out cubic
+  lockFrame();
+
+  if (transition != TRANSITION_FADE) {
+    // Old page leaves to the left, new page follows it in from the right (mirrored going back)
+    int direction = transition == TRANSITION_SLIDE_BACK ? -1 : 1;
+    int offset = (int)(eased * SCREEN_WIDTH);
+    PROFILE_CALL(PROF_FRAME_CLEAR, SCREEN_WIDTH * SCREEN_HEIGHT, frame.fillSprite(SLOT_BG));
+    composePage(-offset * direction, from);
+    composePage((SCREEN_WIDTH - offset) * direction, to);
+    loadWirePalette(255);
+  } else {
+    // Fade the old page out to the background, then the new one in
+    int half = eased >= 0.5 ? 2 : 1;
+    if (composed != half) {
+      PROFILE_CALL(PROF_FRAME_CLEAR, SCREEN_WIDTH * SCREEN_HEIGHT, frame.fillSprite(SLOT_BG));
+      composePage(0, half == 2 ? to : from);
+      composed = half;
+    }
+    PROFILE_CALL(PROF_FADE, 16, loadWirePalette((uint8_t)(255 * (half == 2 ? (eased - 0.5) * 2 : 1.0 - eased * 2))));
+  }
+  PROFILE_DRAW_OVERLAY(Gfx(frame, true));
+
+  unsigned long bytes = 0;
+  pushRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, false, bytes);
+  unlockFrame();
+}
+
+// --- HELPER: Play a transition at TRANSITION_FPS, skipping frames we are late for ---
+static void playTransition(RenderTransition transition, const std::function<void()>& from, const std::function<void()>& to) {
+  const unsigned long frameMs = 1000 / TRANSITION_FPS;
+  const int frames = TRANSITION_MS / frameMs;
+  unsigned long started = millis();
+  unsigned long shown = 0, dropped = 0;
+  int composed = 0;
+
+  beginPush();
+  for (int i = 1; i < frames; i++) {
+    if (touchEventPending()) break; // Don't hold the next gesture up; the page is drawn in full below
+    long wait = (long)(started + i * frameMs - millis());
+    if (wait < -(long)frameMs) { // Over a frame behind: drop this one to catch up
+      dropped++;
+      continue;
+    }
+    if (wait > 0) delay(wait);
+    PROFILE_FRAME_BEGIN(PROF_PAGE_TRANSITION);
+    pushTransitionFrame(transition, (float)i / frames, from, to, composed);
+    PROFILE_FRAME_END();
+    shown++;
+  }
+  endPush();
+
+  unsigned long elapsed = millis() - started;
+  stats.transitions++;
+  stats.transitionFrames += shown;
+  stats.droppedFrames += dropped;
+  stats.lastTransitionFps = elapsed > 0 ? shown * 1000 / elapsed : 0;
+  Serial.printf("[render] %s: %lu frames, %lu dropped, %lu fps (%s)\n", transition == TRANSITION_FADE ? "fade" : "slide",
+                shown, dropped, stats.lastTransitionFps, dmaReady ? "DMA" : "blocking");
+}
+
+void renderFrame(const std::function<void()>& draw) {
+  frameId++;
+  if (!ensureFrame()) {
+    // Not enough heap: draw straight to the panel like before
+    tft.fillScreen(CAT_BG);
+    draw();
+    return;
+  }
+
+  // Animate from the last page if one was asked for and the panel still shows it
+  RenderTransition transition = pendingTransition;
+  pendingTransition = TRANSITION_NONE;
+  renderTask = xTaskGetCurrentTaskHandle();
+  if (transition != TRANSITION_NONE && lastDraw && !panelTouched) {
+    playTransition(transition, lastDraw, draw);
+    panelTouched = true; // The tile hashes are of the old page: push the final frame whole
+  }
+  lastDraw = draw;
+
+  unsigned long started = millis();
+  bool full = panelTouched.exchange(false);
+  unsigned long bytes = 0, rects = 0;
+  PROFILE_FRAME_BEGIN(currentPage);
+
+  // 1. Compose the whole page, once
+  lockFrame();
+  PROFILE_CALL(PROF_FRAME_CLEAR, SCREEN_WIDTH * SCREEN_HEIGHT, frame.fillSprite(SLOT_BG));
+  draw();
+  PROFILE_DRAW_OVERLAY(Gfx(frame, true));
+
+  // 2. Diff: merge each run of changed tiles in a tile row into one window
+  loadWirePalette(255);
+  beginPush();
+  for (int row = 0; row < TILES_Y; row++) {
+    int runStart = -1;
+    for (int col = 0; col <= TILES_X; col++) {
+      bool dirty = false;
+      if (col < TILES_X) {
+        uint32_t hash;
+        PROFILE_CALL(PROF_TILE_HASH, RENDER_TILE_W * RENDER_TILE_H, hash = hashTile(col * RENDER_TILE_W, row * RENDER_TILE_H));
+        dirty = full || hash != tileHash[row][col];
+        tileHash[row][col] = hash;
+      }
+      if (dirty && runStart < 0) runStart = col;
+      if (!dirty && runStart >= 0) {
+        // 3. Push just that window of the frame
+        int x = runStart * RENDER_TILE_W;
+        rects += pushRect(x, row * RENDER_TILE_H, (col - runStart) * RENDER_TILE_W, RENDER_TILE_H, true, bytes);
+        runStart = -1;
+      }
+    }
+  }
+  endPush();
+  unlockFrame();
+
+  PROFILE_FRAME_END();
+  renderTask = nullptr;
+  noteUpdate("frame", bytes, rects, started);
+}
+
+// --- HELPER: Compose one rect in the frame and push it; returns the SPI windows used ---
+static unsigned long pushRegion(RenderRect r, const std::function<void(const RenderRect&)>& draw, unsigned long& bytes) {
+  // Clip to the screen
+  if (r.x < 0) { r.w += r.x; r.x = 0; }
+  if (r.y < 0) { r.h += r.y; r.y = 0; }
+  if (r.x + r.w > SCREEN_WIDTH) r.w = SCREEN_WIDTH - r.x;
+  if (r.y + r.h > SCREEN_HEIGHT) r.h = SCREEN_HEIGHT - r.y;
+  if (r.w <= 0 || r.h <= 0) return 0;
+
+  // Clip only: drawing stays in screen coordinates
+  frame.setViewport(r.x, r.y, r.w, r.h, false);
+  PROFILE_CALL(PROF_FRAME_CLEAR, r.w * r.h, frame.fillRect(r.x, r.y, r.w, r.h, SLOT_BG));
+  draw(r);
+  PROFILE_DRAW_OVERLAY(Gfx(frame, true));
+  frame.resetViewport();
+  unsigned long count = pushRect(r.x, r.y, r.w, r.h, true, bytes);
+
+  // The rest of each tile was already on the panel, so the frame matches it again
+  for (int row = r.y / RENDER_TILE_H; row <= (r.y + r.h - 1) / RENDER_TILE_H; row++) {
+    for (int col = r.x / RENDER_TILE_W; col <= (r.x + r.w - 1) / RENDER_TILE_W; col++) {
+      tileHash[row][col] = hashTile(col * RENDER_TILE_W, row * RENDER_TILE_H);
+    }
+  }
+  return count;
+}
+
+void renderRegions(const std::vector<RenderRect>& rects, const std::function<void(const RenderRect&)>& draw) {
+  if (rects.empty()) return;
+  if (!ensureFrame()) {
+    for (const RenderRect& r : rects) {
+      tft.fillRect(r.x, r.y, r.w, r.h, CAT_BG);
+      draw(r);
+    }
+    return;
+  }
+
+  unsigned long started = millis();
+  unsigned long bytes = 0, count = 0;
+  renderTask = xTaskGetCurrentTaskHandle();
+  PROFILE_FRAME_BEGIN(currentPage);
+
+  loadWirePalette(255);
+  lockFrame();
+  beginPush();
+  for (const RenderRect& r : rects) count += pushRegion(r, draw, bytes);
+#if RENDER_PROFILER
+  // Fresh numbers in the overlay with every update
+  if (profilerOverlayOn()) count += pushRegion({0, 0, PROFILE_OVERLAY_W, PROFILE_OVERLAY_H}, draw, bytes);
+#endif
+  endPush();
+  unlockFrame();
+
+  PROFILE_FRAME_END();
+  renderTask = nullptr;
+  noteUpdate("update", bytes, count, started);
+}
+
+// --- HELPER: Move rows [y, y + h) of the frame dx (even) pixels to the left ---
+static void shiftRows(int y, int h, int dx) {
+  uint8_t* bytes = (uint8_t*)frame.getPointer();
+  for (int row = y; row < y + h; row++) {
+    uint8_t* line = bytes + row * ROW_BYTES;
+    memmove(line, line + dx / 2, ROW_BYTES - dx / 2);
+  }
+}
+
+bool renderScroll(int16_t y, int16_t h, int16_t dx, const std::function<void(const RenderRect&)>& drawIn) {
+  if (y < 0 || h <= 0 || y + h > SCREEN_HEIGHT || dx <= 0 || dx > SCREEN_WIDTH || (dx & 1)) return false;
+  if (!ensureFrame()) return false;
+
+  // 1. Move what is already there
+  lockFrame();
+  PROFILE_CALL(PROF_SCROLL, SCREEN_WIDTH * h, shiftRows(y, h, dx));
+
+  // 2. Draw only the columns that came in on the right
+  RenderRect in = {(int16_t)(SCREEN_WIDTH - dx), y, dx, h};
+  renderTask = xTaskGetCurrentTaskHandle();
+  frame.setViewport(in.x, in.y, in.w, in.h, false);
+  frame.fillRect(in.x, in.y, in.w, in.h, SLOT_BG);
+  drawIn(in);
+  frame.resetViewport();
+  renderTask = nullptr;
+
+  // 3. Push the rows
+  unsigned long pushed = 0;
+  loadWirePalette(255);
+  beginPush();
+  pushRect(0, y, SCREEN_WIDTH, h, true, pushed);
+  endPush();
+  unlockFrame();
+
+  // The panel no longer matches these rows' hashes
+  for (int row = y / RENDER_TILE_H; row <= (y + h - 1) / RENDER_TILE_H; row++) {
+    for (int col = 0; col < TILES_X; col++) tileHash[row][col] = 0;
+  }
+
+  // Steps per second, over whole seconds
+  static unsigned long windowStart = 0, windowFrames = 0;
+  unsigned long now = millis();
+  if (now - windowStart >= 1000) {
+    stats.stripFps = (now - windowStart < 2000) ? windowFrames * 1000 / (now - windowStart) : 0;
+    windowStart = now;
+    windowFrames = 0;
+  }
+  windowFrames++;
+  stats.stripFrames++;
+  return true;
+}
+
+bool renderRepaint() {
+  if (!frameReady || panelTouched) return false;
+
+  unsigned long started = millis();
+  unsigned long bytes = 0, rects = 0;
+  PROFILE_FRAME_BEGIN(currentPage);
+  loadWirePalette(255);
+  beginPush();
+  rects = pushRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, true, bytes);
+  endPush();
+  PROFILE_FRAME_END();
+  noteUpdate("repaint", bytes, rects, started);
+  return true;
+}
+
+bool renderReadPixels(int x, int y, int w, uint16_t* out) {
+  if (!frameReady) return false;
+  const uint16_t* palette = themePalette();
+  lockFrame();
+  const uint8_t* line = (const uint8_t*)frame.getPointer() + y * ROW_BYTES;
+  for (int col = x; col < x + w; col++) {
+    uint8_t pair = line[col >> 1];
+    *out++ = palette[(col & 1) ? (pair & 0x0F) : (pair >> 4)];
+  }
+  unlockFrame();
+  return true;
+}
+
+RenderStats getRenderStats() {
+  return stats;
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <TFT_eSPI.h>
+#include "profiler.h" // For profilerRecord
+#include "theme.h"    // For themeSlotOf
+#include <functional>
+#include <vector>
+
+// =========================================================================
+// INDEXED FRAME RENDERER
+// Pages are composed off-screen into a full-screen 4-bit TFT_eSprite
+// (37.5 KB, where a 16-bit one would need 150 KB) instead of straight
+// onto the panel. Its pixels are theme slots, not colours: they become
+// RGB565 through the theme palette (theme.h) only as they are pushed,
+// a tile row at a time, so switching theme is a re-push of the frame.
+//
+// The frame is split into tiles; a tile is only sent over SPI if its
+// pixels differ from what the last frame left on the panel, so an
+// unchanged header, footer or label costs nothing and there is no
+// fill-then-redraw flicker. Between frames the sprite holds exactly
+// what is on the panel.
+//
+// Drawing code calls gfx() instead of using `tft` directly.
+// =========================================================================
+
+// --- What gfx() returns ---
+// The TFT_eSPI calls the pages draw with. Colours are always RGB565
+// (CAT_*); on the indexed frame each one is turned into its theme slot
+// on the way in, elsewhere it is passed through, so the same drawing
+// code works on the frame, the panel and 16-bit sprites (a TFT_eSPI
+// converts to a plain Gfx). With RENDER_PROFILER set, the calls of a
+// timed Gfx are counted per primitive (see profiler.h). Fonts and
+// measuring can go through the TFT_eSPI& conversion; colours must not.
+#if RENDER_PROFILER
+#define GFX_TIMED(primitive, pixels, ...) \
+  do { \
+    unsigned long started_ = micros(); \
+    __VA_ARGS__; \
+    if (timed) profilerRecord(primitive, pixels, micros() - started_); \
+  } while (0)
+#else
+#define GFX_TIMED(primitive, pixels, ...) __VA_ARGS__
+#endif
+
+class Gfx {
+public:
+  Gfx(TFT_eSPI& target, bool indexed = false, bool timed = false) : target(target), indexed(indexed), timed(timed) {}
+  operator TFT_eSPI&() const { return target; }
+
+  // State: not timed
+  void setTextColor(uint16_t color) { target.setTextColor(ink(color)); }
+  void setTextColor(uint16_t fg, uint16_t bg, bool bgfill = false) { target.setTextColor(ink(fg), ink(bg), bgfill); }
+  void setTextDatum(uint8_t datum) { target.setTextDatum(datum); }
+  void setTextSize(uint8_t size) { target.setTextSize(size); }
+  void setTextFont(uint8_t font) { target.setTextFont(font); }
+  void setFreeFont(const GFXfont* font) { target.setFreeFont(font); }
+  int16_t textWidth(const String& text) { return target.textWidth(text); }
+  int16_t fontHeight() { return target.fontHeight(); }
+  int16_t width() { return target.width(); }
+  int16_t height() { return target.height(); }
+
+  int16_t drawString(const char* text, int32_t x, int32_t y) {
+    int16_t w = 0;
+    GFX_TIMED(PROF_TEXT, (uint32_t)w * target.fontHeight(), w = target.drawString(text, x, y));
+    return w;
+  }
+  int16_t drawString(const String& text, int32_t x, int32_t y) { return drawString(text.c_str(), x, y); }
+
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    GFX_TIMED(PROF_FILL_RECT, w * h, target.fillRect(x, y, w, h, ink(color)));
+  }
+  void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    GFX_TIMED(PROF_ROUND_RECT, w * h, target.fillRoundRect(x, y, w, h, r, ink(color)));
+  }
+  void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    GFX_TIMED(PROF_LINE, max(abs(x1 - x0), abs(y1 - y0)) + 1, target.drawLine(x0, y0, x1, y1, ink(color)));
+  }
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    GFX_TIMED(PROF_FAST_LINE, w, target.drawFastHLine(x, y, w, ink(color)));
+  }
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    GFX_TIMED(PROF_FAST_LINE, h, target.drawFastVLine(x, y, h, ink(color)));
+  }
+  void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+    GFX_TIMED(PROF_CIRCLE, 44 * r / 7, target.drawCircle(x, y, r, ink(color))); // ~2 pi r
+  }
+  void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
+    GFX_TIMED(PROF_FILL_CIRCLE, 22 * r * r / 7, target.fillCircle(x, y, r, ink(color))); // ~pi r^2
+  }
+
+private:
+  TFT_eSPI& target;
+  bool indexed; // Colours are written as theme slots
+  bool timed;   // Counted by the profiler
+
+  uint32_t ink(uint32_t color) const { return indexed ? themeSlotOf(color) : color; }
+};
+
+// The draw target: the frame while renderFrame() runs on the calling
+// task, otherwise the panel itself. Drawing straight to the panel (boot
+// and status messages, always from loop()) makes the next frame a full
+// one, since the panel no longer matches the tile hashes. Other tasks
+// must not draw at all: they would share the SPI bus and the font state
+// with loop(); they post a command instead (see command_queue.h).
+Gfx gfx();
+
+// Draws a whole page with `draw` (in screen coordinates, starting from a
+// CAT_BG background) and pushes only the tiles that changed. `draw` is
+// kept until the next frame, to animate away from, so it must be
+// repeatable, side-effect free and not capture anything that goes out
+// of scope.
+void renderFrame(const std::function<void()>& draw);
+
+// Page transitions. The next renderFrame() animates from the page on
+// screen to its own page over TRANSITION_MS, then draws it as usual.
+// The animation only uses the two pages' draw functions, so it never
+// waits on the network; pages that are not ready yet (status pages)
+// should cancel it with TRANSITION_NONE. A slide composes both pages
+// per animation frame; a fade composes each page once and only blends
+// the palette from frame to frame.
+enum RenderTransition {
+  TRANSITION_NONE,
+  TRANSITION_SLIDE,      // New page pushes the old one out to the left
+  TRANSITION_SLIDE_BACK, // ...or to the right (going back)
+  TRANSITION_FADE,       // Old page fades to the background, new one fades in
+};
+void renderTransitionNext(RenderTransition transition);
+
+// True while a transition waits for the next renderFrame(). A page that
+// would only update what changed (a swipe to the next ticker) should
+// draw a whole frame instead, so the slide plays.
+bool renderTransitionPending();
+
+// Forces the next frame to push every tile.
+void renderInvalidate();
+
+// Redraws just `rects` (screen coordinates) on top of the last frame.
+// For each rect, `draw` is called with the frame clipped to it and
+// cleared to CAT_BG; it should draw everything that overlaps the rect.
+struct RenderRect {
+  int16_t x, y, w, h;
+};
+void renderRegions(const std::vector<RenderRect>& rects, const std::function<void(const RenderRect&)>& draw);
+
+// Scrolls rows [y, y + h) of the frame `dx` pixels to the left, for
+// content that moves every frame (the ticker tape): the rows are moved
+// in RAM, `drawIn` is called with the frame clipped to the columns that
+// came in on the right (cleared to CAT_BG, screen coordinates) and the
+// rows are pushed. Nothing else is composed or diffed. `dx` must be even
+// (two pixels share a byte). Callers bracket the step with
+// PROFILE_FRAME_BEGIN / END themselves. False if there is no frame.
+bool renderScroll(int16_t y, int16_t h, int16_t dx, const std::function<void(const RenderRect&)>& drawIn);
+
+// Pushes the whole frame again through the current theme palette, after
+// themeApply(). False if the panel does not show the frame (nothing has
+// been rendered, or something drew straight to the panel since): redraw
+// the page instead.
+bool renderRepaint();
+
+// Any task: copies pixels [x, x + w) of row `y` of the frame, as last
+// pushed to the panel, in RGB565 through the current theme palette
+// (the screen mirror). Waits while a frame or update is being written.
+// False if there is no frame.
+bool renderReadPixels(int x, int y, int w, uint16_t* out);
+
+// Changes with every renderFrame(). A retained page remembers the id of
+// the frame it drew; if it differs, something else has been on screen.
+uint32_t renderFrameId();
+
+// True if something has drawn straight to the panel since the last frame
+bool renderPanelTouched();
+
+struct RenderStats {
+  unsigned long frames = 0;      // Full frames and partial updates
+  unsigned long lastBytes = 0;   // Pixel bytes sent by the last one
+  unsigned long lastRects = 0;   // SPI windows it took
+  unsigned long lastMs = 0;      // Compose + push time
+  unsigned long totalBytes = 0;  // Since boot
+  unsigned long fullBytes = 0;   // What the same frames would have cost as full repaints
+  unsigned long transitions = 0;
+  unsigned long transitionFrames = 0; // Animation frames shown
+  unsigned long droppedFrames = 0;    // Skipped to keep the animation on time
+  unsigned long lastTransitionFps = 0;
+  unsigned long stripFrames = 0;      // renderScroll() calls
+  unsigned long stripFps = 0;         // ...in the last full second they ran
+};
+RenderStats getRenderStats();
@@ -0,0 +1,135 @@
+#include "screen_mirror.h"
+#include "config.h"     // For SCREEN_*, RENDER_TILE_H, SCREEN_MIRROR_INTERVAL_MS
+#include "render.h"     // For renderReadPixels
+#include "power.h"      // For powerTimerDue, powerWake
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#define MIRROR_STRIPS (SCREEN_HEIGHT / RENDER_TILE_H)
+
+// Changed columns [x0, x1) of each strip since the last WebSocket send (loop() task)
+static int16_t dirtyX0[MIRROR_STRIPS];
+static int16_t dirtyX1[MIRROR_STRIPS];
+static std::atomic<bool> allDirty(false); // A new viewer needs the whole screen
+
+static AsyncWebSocket mirrorSocket("/screen_ws");
+
+// --- HELPER: Append pixels (native byte order) as runs ---
+static void encodeRuns(std::vector<uint8_t>& out, const uint16_t* pixels, int count) {
+  int i = 0;
+  while (i < count) {
+    uint16_t color = pixels[i];
+    int len = 1;
+    while (i + len < count && len < 255 && pixels[i + len] == color) len++;
+    out.push_back(len);
+    out.push_back(color & 0xFF);
+    out.push_back(color >> 8);
+    i += len;
+  }
+}
+
+// --- HELPER: Pixels [x, x + w) of screen row y, from the renderer's frame ---
+static void readRow(int y, int x, int w, uint16_t* line) {
+  if (!renderReadPixels(x, y, w, line)) memset(line, 0, w * sizeof(uint16_t)); // Nothing rendered yet: black, like the panel
+}
+
+// --- HELPER: Write a little-endian rect header ---
+static void putRect(std::vector<uint8_t>& out, int x, int y, int w, int h) {
+  for (int value : {x, y, w, h}) {
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+  }
+}
+
+void mirrorDirty(int x, int y, int w, int h) {
+  for (int strip = y / RENDER_TILE_H; strip <= (y + h - 1) / RENDER_TILE_H; strip++) {
+    if (dirtyX1[strip] <= dirtyX0[strip]) {
+      dirtyX0[strip] = x;
+      dirtyX1[strip] = x + w;
+    } else {
+      dirtyX0[strip] = min((int)dirtyX0[strip], x);
+      dirtyX1[strip] = max((int)dirtyX1[strip], x + w);
+    }
+  }
+}
+
+void screenMirrorTick() {
+  static unsigned long lastSend = 0;
+  if (mirrorSocket.count() == 0) return; // Nobody watching: nothing to wake up for
+  if (!powerTimerDue(lastSend, SCREEN_MIRROR_INTERVAL_MS)) return;
+
+  mirrorSocket.cleanupClients();
+  if (!mirrorSocket.availableForWriteAll()) return; // A slow viewer: the strips stay dirty until next time
+
+  if (allDirty.exchange(false)) mirrorDirty(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+  static uint16_t line[SCREEN_WIDTH];
+  std::vector<uint8_t> message;
+  for (int strip = 0; strip < MIRROR_STRIPS; strip++) {
+    // One message per changed strip, just its changed columns, encoded from the frame now
+    int x0 = dirtyX0[strip], x1 = dirtyX1[strip];
+    if (x1 <= x0) continue;
+    dirtyX0[strip] = dirtyX1[strip] = 0;
+
+    message.clear();
+    putRect(message, x0, strip * RENDER_TILE_H, x1 - x0, RENDER_TILE_H);
+    PROFILE_SCOPE(PROF_MIRROR, (x1 - x0) * RENDER_TILE_H);
+    for (int y = strip * RENDER_TILE_H; y < (strip + 1) * RENDER_TILE_H; y++) {
+      readRow(y, x0, x1 - x0, line);
+      encodeRuns(message, line, x1 - x0);
+    }
+    mirrorSocket.binaryAll((uint8_t*)message.data(), message.size());
+  }
+}
+
+// State of one /screen download between chunks
+struct ScreenStream {
+  int row = 0;
+  std::vector<uint8_t> pending; // Bytes that did not fit the last chunk
+};
+
+void setupScreenMirror(AsyncWebServer& server) {
+  // --- API: Current Screen (RLE565, encoded from the frame a row at a time as the chunks go out) ---
+  server.on("/screen", HTTP_GET, [](AsyncWebServerRequest *request){
+    std::shared_ptr<ScreenStream> stream = std::make_shared<ScreenStream>();
+    const char magic[] = "R565";
+    stream->pending.assign(magic, magic + 4);
+    putRect(stream->pending, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream",
+      [stream](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        size_t len = 0;
+        while (len < maxLen) {
+          // 1. Whatever was left over from the last row
+          if (!stream->pending.empty()) {
+            size_t n = min(maxLen - len, stream->pending.size());
+            memcpy(buffer + len, stream->pending.data(), n);
+            stream->pending.erase(stream->pending.begin(), stream->pending.begin() + n);
+            len += n;
+            continue;
+          }
+          if (stream->row >= SCREEN_HEIGHT) break;
+
+          // 2. Next row: read whole, so it can't change halfway
+          uint16_t line[SCREEN_WIDTH];
+          readRow(stream->row++, 0, SCREEN_WIDTH, line);
+          encodeRuns(stream->pending, line, SCREEN_WIDTH);
+        }
+        return len; // 0 ends the response
+      });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+  });
+
+  // --- WebSocket: Changed strips as they are drawn ---
+  mirrorSocket.onEvent([](AsyncWebSocket *socket, AsyncWebSocketClient *client, AwsEventType type,
+                          void *arg, uint8_t *data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+      Serial.printf("[mirror] Viewer %u connected\n", client->id());
+      allDirty = true;
+      powerWake(); // Its first frame goes out on the next pass
+    }
+  });
+  server.addHandler(&mirrorSocket);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// =========================================================================
+// SCREEN MIRROR
+// Lets the web GUI show what a wall-mounted unit is displaying. Nothing
+// is copied as it is drawn: the renderer's 4-bit frame (render.h)
+// already holds the whole screen, so both endpoints encode from it,
+// through the theme palette, when they send:
+//
+//   GET /screen   The whole screen, a row at a time as the chunks go out
+//   /screen_ws    WebSocket; a full screen on connect, then only the
+//                 8-row strips that changed, at most every
+//                 SCREEN_MIRROR_INTERVAL_MS
+//
+// Both use the same "RLE565" rectangle: x, y, w, h as little-endian
+// uint16, then runs of [count uint8][RGB565 uint16 LE] filling the rect
+// row by row (/screen prefixes it with the magic "R565").
+//
+// Drawing that bypasses the renderer (boot messages, the web server's
+// status text) does not show until the next frame.
+// =========================================================================
+
+// Registers /screen and /screen_ws on the web server
+void setupScreenMirror(AsyncWebServer& server);
+
+// Marks a rect the renderer just pushed as changed, for the next
+// WebSocket send. loop() task only.
+void mirrorDirty(int x, int y, int w, int h);
+
+// Sends changed strips to WebSocket viewers. Call every loop() iteration.
+void screenMirrorTick();
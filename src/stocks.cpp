@@ -2,167 +2,267 @@
 #include "globals.h"    // For tft, colors, etc.
 #include "config.h"     // For CAs
 #include "secrets.h"    // For finnhub_api_key
-#include "drawing.h"    // For drawHeader, drawFooter, etc.
-#include "utils.h"      // For HTTPSRequest, truncateDecimal
+#include "drawing.h"    // For drawStatusPage, drawRangeBar, chrome widgets
+#include "utils.h"      // For HTTPSRequestJson, truncateDecimal
+#include "data_cache.h" // For TtlCache
+#include "trade_stream.h" // For getLivePrice
+#include "price_history.h" // For priceHistoryAdd, priceHistorySparkline
 #include <ArduinoJson.h>
-#include "Free_Fonts.h"
+#include "render.h"     // For gfx()
+#include "widgets.h"    // For WidgetPage
+#include "layout.h"     // For layoutFor, layoutFill
+#include "watchlist.h"  // For watchlistOnQuote
+#include "power.h"      // For powerTimerDue
 
 //  - Visualizing a layout with huge price, a grid for Open/Prev, and a progress bar for the day's range.
 
-// --- HELPER: Draw High/Low/Current Price Bar ---
-void drawPriceBar(float low, float high, float current, uint16_t color) {
-  // --- ADJUSTMENTS HERE ---
-  // Increased barX from 60 to 75 to shorten the bar width
-  // Moved barY from 205 to 190 to move it away from the footer
-  int barX = 75; 
-  int barY = 190; 
-  int barW = SCREEN_WIDTH - (barX * 2); // Width is calculated based on margins
-  int barH = 6; // Thickness of the bar
-
-  // 1. Draw Labels (Low on left, High on right)
-  tft.setTextColor(CAT_MUTED, CAT_BG);
-  #if USE_FREE_FONTS
-    tft.setFreeFont(FSS9);
-  #else
-    tft.setTextFont(2);
-  #endif
-  
-  // Draw Low Price (Right-aligned to the start of the bar)
-  tft.setTextDatum(MR_DATUM); 
-  tft.drawString(String(low, 2), barX - 8, barY + 3);
-
-  // Draw High Price (Left-aligned to the end of the bar)
-  tft.setTextDatum(ML_DATUM); 
-  tft.drawString(String(high, 2), barX + barW + 8, barY + 3);
-
-  // 2. Draw the Background Bar (Pill shape)
-  tft.fillRoundRect(barX, barY, barW, barH, 3, CAT_MUTED);
-
-  // 3. Calculate Position of the dot
-  if (high == low) high += 0.01; // Prevent Div/0
-  float range = high - low;
-  float percent = (current - low) / range;
-  
-  // Clamp values to ensure dot stays inside the bar
-  if (percent < 0.0) percent = 0.0;
-  if (percent > 1.0) percent = 1.0;
-
-  int indicatorX = barX + (int)(percent * barW);
-
-  // 4. Draw Current Price Indicator
-  // The "CAT_BG" outline creates a clean separation "cutout" effect
-  tft.fillCircle(indicatorX, barY + 3, 6, color); 
-  tft.drawCircle(indicatorX, barY + 3, 6, CAT_BG); 
+// --- Stock page widgets (placed by the "stocks" layout, see layout.h) ---
+static WidgetPage stockPage;
+static uint32_t stockLayoutVersion = 0;
+
+// --- HELPER: Draw the intraday sparkline (between the change line and the grid) ---
+static void drawSparkline(const WidgetSpec& spark, const SparkColumn* cols, size_t count, uint16_t color) {
+  const int colW = 2;
+  const int sparkX = spark.x;
+  const int sparkY = spark.y;
+  const int sparkH = spark.h;
+
+  // A layout narrower than the history shows the latest columns
+  size_t fit = spark.w / colW;
+  if (count > fit) {
+    cols += count - fit;
+    count = fit;
+  }
+  if (count < 2) return; // A single point isn't a line
+
+  // 1. Vertical scale from the columns, not the raw samples
+  float lo = cols[0].lo, hi = cols[0].hi;
+  for (size_t i = 1; i < count; i++) {
+    if (cols[i].lo < lo) lo = cols[i].lo;
+    if (cols[i].hi > hi) hi = cols[i].hi;
+  }
+  if (hi - lo < 0.01) { hi += 0.005; lo -= 0.005; } // Flat line: center it
+  float scale = (sparkH - 1) / (hi - lo);
+
+  // 2. Each column is its high-low wick, joined at the closing prices
+  int prevX = 0, prevY = 0;
+  for (size_t i = 0; i < count; i++) {
+    int x = sparkX + i * colW;
+    int yHi = sparkY + sparkH - 1 - (int)((cols[i].hi - lo) * scale);
+    int yLo = sparkY + sparkH - 1 - (int)((cols[i].lo - lo) * scale);
+    int yLast = sparkY + sparkH - 1 - (int)((cols[i].last - lo) * scale);
+    gfx().drawFastVLine(x, yHi, yLo - yHi + 1, color);
+    if (i > 0) gfx().drawLine(prevX, prevY, x, yLast, color);
+    prevX = x;
+    prevY = yLast;
+  }
 }
 
-// --- MAIN FUNCTION ---
-void fetchAndDisplayTicker(String ticker) {
-  Serial.print("Fetching data for: ");
-  Serial.println(ticker);
+// --- Quote cache (loop() task only) ---
+static TtlCache<StockQuote> quoteCache(QUOTE_TTL_MS, QUOTE_CACHE_SIZE);
 
-  drawHeader("Stocks");
-  drawFooter(PAGE_STOCKS);
-  drawStatusMessage("Fetching quote...", CAT_MUTED);
+// --- HELPER: JSON Filter for the Quote Endpoint ---
+// Built once; deserializeJson() drops every other field while reading
+static const JsonDocument& quoteFilter() {
+  static StaticJsonDocument<128> filter;
+  if (filter.isNull()) {
+    for (const char* key : {"c", "h", "l", "o", "pc", "d", "dp"}) {
+      filter[key] = true;
+    }
+  }
+  return filter;
+}
 
-  // --- Step 1: API Request ---
+// --- NETWORK: Fetch & Parse (runs on the network worker) ---
+bool fetchStockQuote(const String& ticker, StockQuote& quote) {
   // Finnhub Quote Endpoint: c=Current, h=High, l=Low, o=Open, pc=PrevClose, d=Change, dp=Percent
   String quoteUrl = "https://finnhub.io/api/v1/quote?symbol=" + ticker + "&token=" + String(finnhub_api_key);
-  String quoteResponse = HTTPSRequest(quoteUrl, test_root_ca);
 
-  DynamicJsonDocument doc(1024);
-  DeserializationError error = deserializeJson(doc, quoteResponse);
-
-  // --- Step 2: Parse Data ---
-  // Default values
-  float current = 0.0, high = 0.0, low = 0.0, open = 0.0, prevClose = 0.0, change = 0.0, pctChange = 0.0;
-  bool valid = false;
+  // Parsed straight off the socket; only the filtered fields are kept
+  StaticJsonDocument<256> doc;
+  DeserializationError error = HTTPSRequestJson(quoteUrl, test_root_ca, doc, quoteFilter());
 
   if (error) {
     Serial.print("JSON Error: "); Serial.println(error.c_str());
-    drawStatusMessage("JSON Error", CAT_RED);
-  } else if (doc["c"].as<float>() == 0.0 && doc["h"].as<float>() == 0.0) {
+    quote.error = "JSON Error";
+    return false;
+  }
+  if (doc["c"].as<float>() == 0.0 && doc["h"].as<float>() == 0.0) {
     // API returns 0s for invalid tickers
-    drawStatusMessage("Invalid Ticker", CAT_RED);
-  } else {
-    valid = true;
-    current = doc["c"].as<float>();
-    high = doc["h"].as<float>();
-    low = doc["l"].as<float>();
-    open = doc["o"].as<float>();
-    prevClose = doc["pc"].as<float>();
-    change = doc["d"].as<float>();
-    pctChange = doc["dp"].as<float>();
+    quote.error = "Invalid Ticker";
+    return false;
   }
 
-  // --- Step 3: Draw UI ---
-  tft.fillScreen(CAT_BG);
-  drawHeader("Stocks");
-  drawFooter(PAGE_STOCKS);
-  tft.setTextDatum(MC_DATUM);
+  quote.current = doc["c"].as<float>();
+  quote.high = doc["h"].as<float>();
+  quote.low = doc["l"].as<float>();
+  quote.open = doc["o"].as<float>();
+  quote.prevClose = doc["pc"].as<float>();
+  quote.change = doc["d"].as<float>();
+  quote.pctChange = doc["dp"].as<float>();
+  quote.valid = true;
+  return true;
+}
 
-  if (!valid) {
-    tft.setTextColor(CAT_RED, CAT_BG);
-    tft.drawString("Data Unavailable", SCREEN_WIDTH/2, SCREEN_HEIGHT/2);
+// --- DRAW: Stock Page ---
+// Fills in the widgets and lets the page redraw whatever changed; a new
+// trade usually only touches a few price digits and the range dot.
+void drawStockPage(const String& ticker, const StockQuote& quote, long ageMs, uint16_t ageColor) {
+  if (!quote.valid) {
+    drawStatusPage("Stocks", PAGE_STOCKS, quote.error.length() > 0 ? quote.error : "Data Unavailable", CAT_RED);
     return;
   }
 
-  // Determine Color (Green for up, Red for down)
-  uint16_t color = (change >= 0) ? CAT_GREEN : CAT_RED;
-  String sign = (change >= 0) ? "+" : "";
-
-  // 3a. Ticker Symbol (Top)
-  tft.setTextColor(CAT_MUTED, CAT_BG);
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB12);
-  #else
-  tft.setTextFont(4);
-  #endif
-  tft.drawString(ticker, SCREEN_WIDTH / 2, 55); 
-
-  // 3b. Current Price (Huge, Center)
-  tft.setTextColor(CAT_TEXT, CAT_BG);
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB24);
-  #else
-  tft.setTextFont(8);
-  #endif
-  tft.drawString("$" + String(current, 2), SCREEN_WIDTH / 2, 90);
-
-  // 3c. Change & Percent (Below Price)
-  String changeStr = sign + String(change, 2) + " (" + sign + String(pctChange, 2) + "%)";
-  tft.setTextColor(color, CAT_BG);
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB12); // Bold medium
-  #else
-  tft.setTextFont(4);
-  #endif
-  tft.drawString(changeStr, SCREEN_WIDTH / 2, 125);
-
-  // 3d. Secondary Info Grid (Open | Prev Close)
-  int midY = 165;
-  int leftX = SCREEN_WIDTH / 4;
-  int rightX = (SCREEN_WIDTH / 4) * 3;
-
-  // Labels
-  tft.setTextColor(CAT_MUTED, CAT_BG);
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSS9); // Small
-  #else
-  tft.setTextFont(2);
-  #endif
-  tft.drawString("OPEN", leftX, midY);
-  tft.drawString("PREV CLOSE", rightX, midY);
-
-  // Values
-  tft.setTextColor(CAT_TEXT, CAT_BG);
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB9); // Bold Small
-  #else
-  tft.setTextFont(2);
-  #endif
-  tft.drawString(String(open, 2), leftX, midY + 18);
-  tft.drawString(String(prevClose, 2), rightX, midY + 18);
-
-  // 3e. Day Range Bar (Bottom)
-  drawPriceBar(low, high, current, color);
-}
\ No newline at end of file
+  LayoutData data;
+  data.page = PAGE_STOCKS;
+  data.ticker = &ticker;
+  data.quote = &quote;
+  data.ageMs = ageMs;
+  data.ageColor = ageColor;
+
+  const PageLayout& layout = layoutFor(PAGE_STOCKS, stockPage, stockLayoutVersion);
+  for (size_t i = 0; i < layout.items.size(); i++) {
+    if (layoutFill(layout, i, stockPage[i], data)) continue;
+    if (layout.items[i].type != LAYOUT_SPARKLINE) continue;
+
+    // Intraday sparkline, hashed on its columns so it only redraws when one moves
+    static SparkColumn cols[SPARK_COLUMNS];
+    size_t count = priceHistorySparkline(ticker, cols);
+    uint16_t color = layoutColor(layout.items[i], data);
+    WidgetSpec spec = layout.specs[i];
+    stockPage[i].hash = widgetHash(cols, count * sizeof(SparkColumn), widgetHashColor(color));
+    std::vector<SparkColumn> shown(cols, cols + count); // This ticker's, even after a swipe to the next
+    stockPage[i].draw = [spec, shown, color]() { drawSparkline(spec, shown.data(), shown.size(), color); };
+  }
+
+  stockPage.render();
+}
+
+// --- HELPER: Overlay the latest streamed trade on a polled quote ---
+// The quote still supplies open / prev close; the trade moves the price,
+// the change line and (if it breaks out) the day range.
+static StockQuote withLivePrice(const String& ticker, const StockQuote& quote) {
+  LivePrice live;
+  if (!tradeStreamEnabled || !quote.valid || !getLivePrice(ticker, live)) return quote;
+
+  StockQuote merged = quote;
+  merged.current = live.price;
+  merged.change = live.price - quote.prevClose;
+  merged.pctChange = (quote.prevClose != 0.0) ? (merged.change / quote.prevClose) * 100.0 : 0.0;
+  if (live.price > merged.high) merged.high = live.price;
+  if (live.price < merged.low) merged.low = live.price;
+  return merged;
+}
+
+// --- HELPER: Draw a cached quote with its age in the footer ---
+static void drawCachedQuote(const String& ticker, const TtlCache<StockQuote>::Entry& entry) {
+  StockQuote shown = withLivePrice(ticker, entry.value);
+
+  // A recent streamed trade makes the price live, whatever the quote's age
+  unsigned long ageMs = quoteCache.ageMs(entry);
+  uint16_t ageColor = entry.lastFetchFailed ? CAT_RED : (quoteCache.isFresh(entry) ? CAT_MUTED : CAT_YELLOW);
+  LivePrice live;
+  if (tradeStreamEnabled && getLivePrice(ticker, live) && millis() - live.updatedAt < 60000) {
+    ageMs = millis() - live.updatedAt;
+    ageColor = CAT_GREEN;
+  }
+
+  drawStockPage(ticker, shown, ageMs, ageColor);
+}
+
+// --- HELPER: Store a finished fetch, redraw if it is on screen ---
+static void onQuoteFetched(const String& ticker, bool ok, const StockQuote& quote) {
+  // A failed refresh keeps the last good quote in the cache
+  if (ok) {
+    quoteCache.put(ticker, quote);
+    priceHistoryAdd(ticker, quote.current);
+  } else {
+    quoteCache.markFailed(ticker);
+  }
+  watchlistOnQuote(ticker); // Re-ranks it, and redraws its cell if the grid is up
+
+  // The page may have moved on while we were fetching
+  if (currentPage != PAGE_STOCKS || lastTicker != ticker) return;
+
+  TtlCache<StockQuote>::Entry* entry = quoteCache.get(ticker);
+  if (entry != nullptr) {
+    drawCachedQuote(ticker, *entry);
+  } else {
+    drawStockPage(ticker, quote); // Nothing good to fall back on
+  }
+}
+
+// --- HELPER: Queue a quote fetch (merged with one already in flight) ---
+static bool scheduleQuote(const String& ticker, NetPriority priority) {
+  bool queued = netSchedule<StockQuote>("quote:" + ticker, PROVIDER_FINNHUB, priority,
+    [ticker](StockQuote& quote) {
+      return fetchStockQuote(ticker, quote);
+    },
+    [ticker](bool ok, const StockQuote& quote) {
+      onQuoteFetched(ticker, ok, quote);
+    });
+
+  TtlCache<StockQuote>::Entry* cached = quoteCache.get(ticker);
+  if (queued && cached != nullptr) cached->refreshing = true;
+  return queued;
+}
+
+// --- MAIN FUNCTION ---
+void fetchAndDisplayTicker(String ticker, NetPriority priority) {
+  // Serve from the cache straight away; only go upstream when the
+  // entry is missing or past its TTL (stale-while-revalidate).
+  TtlCache<StockQuote>::Entry* cached = quoteCache.get(ticker);
+  if (cached != nullptr) {
+    drawCachedQuote(ticker, *cached);
+    if (quoteCache.isFresh(*cached)) {
+      quoteCache.hits++;
+      Serial.printf("Quote cache hit (%lu s old, %lu hits / %lu misses)\n", quoteCache.ageMs(*cached) / 1000, quoteCache.hits, quoteCache.misses);
+      return;
+    }
+    quoteCache.stale++;
+    if (cached->refreshing && priority != NET_PRIO_INTERACTIVE) return; // Already revalidating
+  } else {
+    quoteCache.misses++;
+    drawStatusPage("Stocks", PAGE_STOCKS, "Fetching quote...", CAT_MUTED);
+  }
+
+  Serial.print("Fetching data for: ");
+  Serial.println(ticker);
+
+  // An interactive request for a queued refresh just bumps its priority
+  if (!scheduleQuote(ticker, priority) && cached == nullptr) {
+    drawStatusPage("Stocks", PAGE_STOCKS, "Network Busy", CAT_RED);
+  }
+}
+
+bool getCachedQuote(const String& ticker, StockQuote& quote) {
+  TtlCache<StockQuote>::Entry* cached = quoteCache.get(ticker);
+  if (cached == nullptr || !cached->value.valid) return false;
+  quote = withLivePrice(ticker, cached->value);
+  return true;
+}
+
+bool prefetchTicker(const String& ticker) {
+  TtlCache<StockQuote>::Entry* cached = quoteCache.get(ticker);
+  if (cached != nullptr && (quoteCache.isFresh(*cached) || cached->refreshing)) return true;
+  return scheduleQuote(ticker, NET_PRIO_ROTATION);
+}
+
+// --- LIVE PRICES: Redraw when a new trade arrives for the ticker on screen ---
+void refreshLivePrice() {
+  static unsigned long lastCheck = 0;
+  static unsigned long lastDrawnTrade = 0;
+
+  if (!tradeStreamEnabled || currentPage != PAGE_STOCKS) return;
+  if (!powerTimerDue(lastCheck, LIVE_PRICE_REDRAW_MS)) return;
+
+  LivePrice live;
+  if (!getLivePrice(lastTicker, live) || live.updatedAt == lastDrawnTrade) return;
+
+  // Needs the polled quote for open / prev close
+  TtlCache<StockQuote>::Entry* entry = quoteCache.get(lastTicker);
+  if (entry == nullptr || !entry->value.valid) return;
+
+  lastDrawnTrade = live.updatedAt;
+  drawCachedQuote(lastTicker, *entry);
+}
@@ -1,7 +1,33 @@
 #pragma once
 #include <Arduino.h>
+#include "net_worker.h" // For NetPriority
 
-void fetchAndDisplayTicker(String ticker);
+// Parsed Finnhub quote (c, h, l, o, pc, d, dp)
+struct StockQuote {
+  float current = 0.0, high = 0.0, low = 0.0, open = 0.0, prevClose = 0.0, change = 0.0, pctChange = 0.0;
+  bool valid = false;
+  String error; // Status text to show when !valid
+};
 
-// Helper to draw the visual range bar
-void drawPriceBar(float low, float high, float current, uint16_t color);
\ No newline at end of file
+// Shows the stock page for `ticker` right away (from the last good quote
+// if we have one) and queues a fresh quote on the network worker.
+void fetchAndDisplayTicker(String ticker, NetPriority priority = NET_PRIO_ROTATION);
+
+// Warms the quote cache for a ticker that is about to be shown. False
+// only if a fetch was needed and the queue was full.
+bool prefetchTicker(const String& ticker);
+
+// The last good quote for `ticker` with any newer streamed trade on top,
+// without fetching. False if there is none yet. loop() task only.
+bool getCachedQuote(const String& ticker, StockQuote& quote);
+
+// Blocking fetch. Only call this from the network worker.
+bool fetchStockQuote(const String& ticker, StockQuote& quote);
+
+// Shows the stock page for an already-parsed quote, redrawing only what
+// changed since the last call. A negative ageMs leaves the data age blank.
+void drawStockPage(const String& ticker, const StockQuote& quote, long ageMs = -1, uint16_t ageColor = 0);
+
+// Redraws the stock page when the trade stream has a newer price for
+// the ticker on screen (rate limited). Call every loop() iteration.
+void refreshLivePrice();
@@ -0,0 +1,93 @@
+#include "theme.h"
+#include "globals.h"    // For CAT_* colors
+#include "drawing.h"    // For color_from_hex
+
+// 24-bit colour of every slot, per theme, in ThemeSlot order
+static const uint32_t themeHex[THEME_COUNT][THEME_SLOTS] = {
+  // Catppuccin Mocha
+  {0x1E1E2E, 0xCDD6F4, 0x6C7086, 0xCBA6F7, 0x181825, // Base, Text, Overlay0, Mauve, Mantle
+   0xA6E3A1, 0xF38BA8, 0xF9E2AF, 0x89B4FA, 0xFFFFFF, // Green, Red, Yellow, Blue, pure white
+   0x9399B2, 0x505050, 0x7B7D7B, 0x000000},           // Overlay1, storm cloud and top, black
+  // Catppuccin Latte
+  {0xEFF1F5, 0x4C4F69, 0x9CA0B0, 0x8839EF, 0xE6E9EF, // Base, Text, Overlay0, Mauve, Mantle
+   0x40A02B, 0xD20F39, 0xDF8E1D, 0x1E66F5, 0x5C5F77, // Green, Red, Yellow, Blue, Subtext1 (strongest on light)
+   0x8C8FA1, 0x6C6F85, 0x7C7F93, 0x000000},           // Overlay1, Subtext0, Overlay2, black
+  // High contrast
+  {0x000000, 0xFFFFFF, 0xC0C0C0, 0x00FFFF, 0x202020, // Black background, grey header
+   0x00FF00, 0xFF3030, 0xFFFF00, 0x40A0FF, 0xF8F8F8, // White is one step off the text
+   0x909090, 0x505050, 0x787878, 0x080808},           // Black is one step off the background
+};
+
+static const char* const themeNames[THEME_COUNT] = {"mocha", "latte", "contrast"};
+
+// --- Current theme (loop() task) ---
+static uint16_t palette[16];
+static uint16_t lastColor = 0;  // Last lookup of themeSlotOf()
+static uint8_t lastSlot = 0xFF; // ...0xFF: none yet
+
+const char* themeName(int theme) {
+  return (theme >= 0 && theme < THEME_COUNT) ? themeNames[theme] : themeNames[THEME_MOCHA];
+}
+
+int themeFromName(const String& name) {
+  for (int theme = 0; theme < THEME_COUNT; theme++) {
+    if (name == themeNames[theme]) return theme;
+  }
+  return THEME_MOCHA;
+}
+
+void themeApply(int theme) {
+  if (theme < 0 || theme >= THEME_COUNT) theme = THEME_MOCHA;
+  for (int slot = 0; slot < 16; slot++) {
+    palette[slot] = color_from_hex(themeHex[theme][slot < THEME_SLOTS ? slot : SLOT_BG]);
+  }
+  lastSlot = 0xFF;
+
+  // Two slots of one colour would be merged in the frame and split wrongly on the next switch
+  for (int a = 0; a < THEME_SLOTS; a++) {
+    for (int b = a + 1; b < THEME_SLOTS; b++) {
+      if (palette[a] == palette[b]) Serial.printf("[theme] %s: slots %d and %d are both %04X\n", themeName(theme), a, b, palette[a]);
+    }
+  }
+
+  CAT_BG      = palette[SLOT_BG];
+  CAT_TEXT    = palette[SLOT_TEXT];
+  CAT_MUTED   = palette[SLOT_MUTED];
+  CAT_ACCENT  = palette[SLOT_ACCENT];
+  CAT_SURFACE = palette[SLOT_SURFACE];
+  CAT_GREEN   = palette[SLOT_GREEN];
+  CAT_RED     = palette[SLOT_RED];
+  CAT_YELLOW  = palette[SLOT_YELLOW];
+  CAT_BLUE    = palette[SLOT_BLUE];
+  CAT_WHITE   = palette[SLOT_WHITE];
+  CAT_GREY    = palette[SLOT_GREY];
+  Serial.printf("[theme] %s\n", themeName(theme));
+}
+
+const uint16_t* themePalette() {
+  return palette;
+}
+
+uint16_t themeColor(ThemeSlot slot) {
+  return palette[slot];
+}
+
+uint8_t themeSlotOf(uint32_t color) {
+  uint16_t c = color;
+  if (lastSlot != 0xFF && c == lastColor) return lastSlot; // Runs of calls share a colour
+  lastColor = c;
+
+  // Exact match, else the nearest by squared 6-bit channel distance
+  long best = LONG_MAX;
+  for (uint8_t slot = 0; slot < THEME_SLOTS; slot++) {
+    uint16_t p = palette[slot];
+    if (p == c) return lastSlot = slot;
+    long dr = ((c >> 11) - (p >> 11)) * 2, dg = ((c >> 5) & 0x3F) - ((p >> 5) & 0x3F), db = ((c & 0x1F) - (p & 0x1F)) * 2;
+    long distance = dr * dr + dg * dg + db * db;
+    if (distance < best) {
+      best = distance;
+      lastSlot = slot;
+    }
+  }
+  return lastSlot;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// THEMES
+// Every colour the pages draw with is one of a few named slots, and a
+// theme is just the RGB565 value of each slot. themeApply() copies them
+// into the CAT_* globals, so drawing code keeps passing colours as before.
+//
+// The renderer's frame stores slots rather than colours (see render.h):
+// a colour drawn into it is looked up in the current palette, and the
+// palette turns slots back into RGB565 as pixels go out to the panel.
+// Switching theme therefore only pushes the frame again through the new
+// palette; no page is redrawn. For that to work the slots of a theme
+// must all have different RGB565 values. Colours that are not in the
+// palette (a #RRGGBB in /layout.json) are drawn as the nearest slot.
+// =========================================================================
+
+enum ThemeSlot {
+  SLOT_BG,
+  SLOT_TEXT,
+  SLOT_MUTED,
+  SLOT_ACCENT,
+  SLOT_SURFACE,
+  SLOT_GREEN,
+  SLOT_RED,
+  SLOT_YELLOW,
+  SLOT_BLUE,
+  SLOT_WHITE,
+  SLOT_GREY,
+  SLOT_STORM_DARK,  // Thunderstorm cloud
+  SLOT_STORM_LIGHT, // ...and its top
+  SLOT_BLACK,       // Profiler overlay box
+  THEME_SLOTS       // At most 16: the frame holds 4 bits a pixel
+};
+
+enum Theme {
+  THEME_MOCHA,         // Catppuccin Mocha (dark, the default)
+  THEME_LATTE,         // Catppuccin Latte (light)
+  THEME_HIGH_CONTRAST, // Saturated colours on black
+  THEME_COUNT
+};
+
+// "mocha", "latte", "contrast" (settings.json, /set_theme)
+const char* themeName(int theme);
+int themeFromName(const String& name);
+
+// Makes `theme` current: its palette and the CAT_* globals.
+// loop() task, between frames.
+void themeApply(int theme);
+
+// RGB565 of each slot in the current theme, 16 entries (spare ones are
+// the background), and of a single slot
+const uint16_t* themePalette();
+uint16_t themeColor(ThemeSlot slot);
+
+// The slot an RGB565 colour is drawn as: the one with that value in the
+// current palette, else the nearest
+uint8_t themeSlotOf(uint32_t color);
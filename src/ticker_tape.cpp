@@ -0,0 +1,165 @@
+#include "ticker_tape.h"
+#include "globals.h"    // For tft, stockTickerList, colors
+#include "config.h"     // For TAPE_*, SCREEN_*
+#include "drawing.h"    // For drawHeader, drawFooter, drawStatusPage
+#include "stocks.h"     // For getCachedQuote, prefetchTicker
+#include "render.h"     // For gfx(), renderFrame(), renderScroll()
+#include "widgets.h"    // For applyFont
+#include "power.h"      // For powerTimerDue
+#include <deque>
+
+// One symbol on the tape, formatted and measured when it enters
+struct TapeCell {
+  String symbol, price, change;
+  uint16_t changeColor;
+  int16_t priceX, changeX; // From the cell's left edge
+  int16_t width;           // Including the gap after it
+};
+
+// --- Tape state (loop() task only) ---
+static std::deque<TapeCell> cells; // On screen, left to right
+static int32_t headX = 0;          // Screen column of cells.front()
+static int32_t tailX = 0;          // ...and of the next cell to enter
+static size_t nextSymbol = 0;      // stockTickerList index entering next
+static bool tapeRunning = false;
+
+// Scrolling clock: how far the tape should have moved is worked out from
+// the time since movedSince, so a slow loop() makes a longer step, not a
+// slower tape
+static unsigned long lastStepMs = 0;
+static unsigned long movedSinceMs = 0;
+static long movedPx = 0;
+
+// --- HELPER: Format and measure a symbol from the quote cache ---
+static TapeCell makeCell(const String& symbol) {
+  TapeCell cell;
+  cell.symbol = symbol;
+
+  StockQuote quote;
+  if (getCachedQuote(symbol, quote)) {
+    cell.price = String(quote.current, 2);
+    cell.change = String(quote.change >= 0 ? "+" : "") + String(quote.pctChange, 2) + "%";
+    cell.changeColor = quote.change >= 0 ? CAT_GREEN : CAT_RED;
+  } else {
+    cell.price = "--"; // Filled in on its next lap
+    cell.changeColor = CAT_MUTED;
+  }
+
+  // Measured on the panel object; nothing is drawn
+  applyFont(tft, FONT_MEDIUM_BOLD);
+  cell.priceX = tft.textWidth(cell.symbol) + 8;
+  applyFont(tft, FONT_MEDIUM);
+  cell.changeX = cell.priceX + tft.textWidth(cell.price) + 8;
+  cell.width = cell.changeX + tft.textWidth(cell.change) + TAPE_GAP;
+  return cell;
+}
+
+// --- HELPER: Add symbols on the right until the tape reaches the screen edge ---
+static void fillTape() {
+  while (tailX < SCREEN_WIDTH && !stockTickerList.empty()) {
+    nextSymbol %= stockTickerList.size(); // The list may have shrunk
+    String symbol = stockTickerList[nextSymbol++];
+
+    // Read before the refresh is queued: a fresh quote comes in on the next lap
+    cells.push_back(makeCell(symbol));
+    tailX += cells.back().width;
+    prefetchTicker(symbol);
+  }
+}
+
+// --- HELPER: Draw the cells overlapping columns [xFrom, xTo) ---
+// gfx() clips; skipping the cells outside the range just saves the glyph work.
+static void drawCells(int xFrom, int xTo) {
+  int mid = TAPE_Y + TAPE_H / 2;
+  int x = headX;
+  gfx().setTextDatum(ML_DATUM);
+  for (const TapeCell& cell : cells) {
+    if (x >= xTo) break;
+    if (x + cell.width > xFrom) {
+      applyFont(gfx(), FONT_MEDIUM_BOLD);
+      gfx().setTextColor(CAT_TEXT);
+      gfx().drawString(cell.symbol, x, mid);
+      applyFont(gfx(), FONT_MEDIUM);
+      gfx().drawString(cell.price, x + cell.priceX, mid);
+      gfx().setTextColor(cell.changeColor);
+      gfx().drawString(cell.change, x + cell.changeX, mid);
+      gfx().fillRect(x + cell.width - TAPE_GAP / 2 - 1, mid - 1, 3, 3, CAT_MUTED);
+    }
+    x += cell.width;
+  }
+}
+
+// --- MAIN FUNCTION ---
+void showTickerTape() {
+  if (stockTickerList.empty()) {
+    drawStatusPage("Ticker Tape", PAGE_TAPE, "No Tickers", CAT_MUTED);
+    return;
+  }
+
+  if (!tapeRunning) {
+    // Start over from the first symbol, at the left edge
+    cells.clear();
+    headX = tailX = 0;
+    nextSymbol = 0;
+    fillTape();
+    tapeRunning = true;
+  }
+
+  // Reads the tape as it is when drawn, so sliding away shows it where it stopped
+  renderFrame([]() {
+    drawHeader("Ticker Tape");
+    gfx().drawFastHLine(0, TAPE_Y - 1, SCREEN_WIDTH, CAT_SURFACE);
+    gfx().drawFastHLine(0, TAPE_Y + TAPE_H, SCREEN_WIDTH, CAT_SURFACE);
+    drawCells(0, SCREEN_WIDTH);
+    drawFooter(PAGE_TAPE);
+  });
+
+  // Scrolling carries on from what is on the panel now
+  lastStepMs = movedSinceMs = millis(); // Not counting the slide in
+  movedPx = 0;
+}
+
+void prefetchTickerTape() {
+  for (const String& symbol : stockTickerList) prefetchTicker(symbol);
+}
+
+void tickerTapeTick() {
+  if (!tapeRunning) return;
+  if (currentPage != PAGE_TAPE) {
+    tapeRunning = false; // Left the page (the cells stay for the slide away)
+    return;
+  }
+  if (cells.empty()) return;
+
+  if (!powerTimerDue(lastStepMs, 1000 / TAPE_FPS)) return;
+  unsigned long now = lastStepMs;
+
+  // 1. How far the tape is due to have moved, in whole pixel pairs (two share
+  // a byte of the frame); after a stall, carry on from here
+  long dx = ((long)((now - movedSinceMs) * TAPE_SPEED_PX_S / 1000) - movedPx) & ~1L;
+  if (dx <= 0) return;
+  const long maxStep = (4 * TAPE_SPEED_PX_S / TAPE_FPS + 2) & ~1L;
+  if (dx > maxStep || movedPx > 3600L * TAPE_SPEED_PX_S) {
+    dx = min(dx, maxStep);
+    movedSinceMs = now;
+    movedPx = 0;
+  } else {
+    movedPx += dx;
+  }
+
+  PROFILE_FRAME_BEGIN(PAGE_TAPE);
+
+  // 2. Drop cells that will have left, add the ones coming in
+  headX -= dx;
+  tailX -= dx;
+  while (!cells.empty() && headX + cells.front().width <= 0) {
+    headX += cells.front().width;
+    cells.pop_front();
+  }
+  fillTape();
+
+  // 3. Move the tape's rows of the frame, draw only the columns that came in and push them;
+  // the rest of the page stays as it is
+  renderScroll(TAPE_Y, TAPE_H, dx, [](const RenderRect& in) { drawCells(in.x, in.x + in.w); });
+  PROFILE_FRAME_END();
+}
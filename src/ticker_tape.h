@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// TICKER TAPE
+// An optional page that scrolls every symbol of stockTickerList past in
+// one continuous line (symbol, price, colored change), like an exchange
+// board. The tape is TAPE_H rows of the renderer's frame: each step
+// moves them left in RAM, draws just the columns that came in on the
+// right and pushes those rows (renderScroll()), so the rest of the page
+// is never recomposed.
+//
+// Prices are read from the quote cache as each symbol enters on the
+// right, and a refresh is queued for any that is missing or stale, so
+// the tape never waits on the network; a symbol without a quote yet
+// shows "--" until its next lap.
+// =========================================================================
+
+// Draws the page and starts the tape from the first symbol (or carries
+// on, if it is already running). Call when currentPage is PAGE_TAPE.
+void showTickerTape();
+
+// Queues a refresh of every symbol's quote, ahead of the page.
+void prefetchTickerTape();
+
+// Scrolls the tape by however far it should have moved since the last
+// step, at most TAPE_FPS times a second, and stops it once the page is
+// left. Call every loop() iteration.
+void tickerTapeTick();
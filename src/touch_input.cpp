@@ -0,0 +1,158 @@
+#include "touch_input.h"
+#include "globals.h"    // For ts
+#include "config.h"     // For TOUCH_* pins, calibration and gesture settings
+#include "power.h"      // For powerWake
+#include <driver/gpio.h>
+#include <atomic>
+
+static TaskHandle_t touchTask = nullptr;
+static QueueHandle_t eventQueue = nullptr; // touch task -> loop()
+
+// --- Counters (touch task and ISR write, /touch_stats reads) ---
+static std::atomic<unsigned long> statIrqs(0);
+static std::atomic<unsigned long> statSamples(0);
+static std::atomic<unsigned long> statTaps(0);
+static std::atomic<unsigned long> statSwipes(0);
+static std::atomic<unsigned long> statLongPresses(0);
+static std::atomic<unsigned long> statDropped(0);
+
+// --- Latency (loop() task writes) ---
+static unsigned long statHandled = 0;
+static unsigned long statOverBudget = 0;
+static float latencyLast = 0, latencySum = 0, latencyMax = 0;
+
+// Pen down: wake the task. The interrupt is on the low level, which
+// also wakes the chip from light sleep; it stays off until the task has
+// followed the press to its end (our own SPI reads pull the line low too).
+static void IRAM_ATTR onPenDown() {
+  gpio_intr_disable((gpio_num_t)TOUCH_IRQ);
+  statIrqs++;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(touchTask, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// --- HELPER: Read the controller once; false if it is not pressed ---
+static bool sample(int16_t& x, int16_t& y) {
+  statSamples++;
+  TS_Point p = ts.getPoint();
+  if (p.z <= TOUCH_Z_MIN || p.z >= TOUCH_Z_MAX) return false;
+
+  // Convert raw ADC values to screen pixels
+  x = map(p.x, TOUCH_X_MIN, TOUCH_X_MAX, 0, SCREEN_WIDTH);
+  y = map(p.y, TOUCH_Y_MIN, TOUCH_Y_MAX, 0, SCREEN_HEIGHT);
+  return true;
+}
+
+// --- HELPER: Hand a gesture to loop() ---
+static void emit(TouchGesture gesture, int16_t x, int16_t y, unsigned long at) {
+  TouchEvent event = {gesture, x, y, at};
+  if (xQueueSend(eventQueue, &event, 0) != pdTRUE) {
+    statDropped++;
+    return;
+  }
+  if (gesture == GESTURE_TAP) statTaps++;
+  else if (gesture == GESTURE_LONG_PRESS) statLongPresses++;
+  else statSwipes++;
+  powerWake(); // loop() may be asleep in powerIdle()
+  Serial.printf("[touch] %s at %d,%d\n", touchGestureName(gesture), x, y);
+}
+
+// --- The sampling task: sleeps until pen down, follows the press until it lifts ---
+static void touchTaskMain(void* param) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    int16_t startX, startY;
+    if (!sample(startX, startY)) { // Glitch
+      gpio_intr_enable((gpio_num_t)TOUCH_IRQ);
+      continue;
+    }
+    unsigned long downAt = millis();
+    int16_t x = startX, y = startY;
+    bool longPressed = false;
+    int misses = 0;
+    unsigned long liftedAt = 0;
+
+    while (misses < TOUCH_RELEASE_SAMPLES) {
+      vTaskDelay(pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+      int16_t nx, ny;
+      if (!sample(nx, ny)) {
+        if (misses++ == 0) liftedAt = micros(); // Confirmed by the next reads
+        continue;
+      }
+      misses = 0;
+      x = nx;
+      y = ny;
+
+      bool still = abs(x - startX) < TOUCH_MOVE_SLOP_PX && abs(y - startY) < TOUCH_MOVE_SLOP_PX;
+      if (!longPressed && still && millis() - downAt >= TOUCH_LONG_PRESS_MS) {
+        longPressed = true; // Fires now; the release that follows is not a tap
+        emit(GESTURE_LONG_PRESS, startX, startY, micros());
+      }
+    }
+
+    if (!longPressed) {
+      int dx = x - startX, dy = y - startY;
+      if (abs(dx) >= TOUCH_SWIPE_MIN_PX && abs(dx) > 2 * abs(dy)) {
+        emit(dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT, startX, startY, liftedAt);
+      } else if (abs(dx) < TOUCH_MOVE_SLOP_PX && abs(dy) < TOUCH_MOVE_SLOP_PX) {
+        emit(GESTURE_TAP, startX, startY, liftedAt);
+      }
+    }
+    gpio_intr_enable((gpio_num_t)TOUCH_IRQ); // Lifted: wait for the next press
+  }
+}
+
+void startTouchInput() {
+  eventQueue = xQueueCreate(TOUCH_QUEUE_LEN, sizeof(TouchEvent));
+  xTaskCreatePinnedToCore(touchTaskMain, "touch", TOUCH_TASK_STACK, nullptr, TOUCH_TASK_PRIORITY, &touchTask, TOUCH_TASK_CORE);
+  pinMode(TOUCH_IRQ, INPUT);
+  attachInterrupt(digitalPinToInterrupt(TOUCH_IRQ), onPenDown, ONLOW_WE); // Also wakes from light sleep
+  Serial.printf("[touch] Sampling on pen-down interrupts (GPIO %d)\n", TOUCH_IRQ);
+}
+
+bool takeTouchEvent(TouchEvent& out) {
+  return eventQueue != nullptr && xQueueReceive(eventQueue, &out, 0) == pdTRUE;
+}
+
+bool touchEventPending() {
+  return eventQueue != nullptr && uxQueueMessagesWaiting(eventQueue) > 0;
+}
+
+void touchEventHandled(const TouchEvent& event) {
+  float ms = (micros() - event.at) / 1000.0f;
+  statHandled++;
+  latencyLast = ms;
+  latencySum += ms;
+  if (ms > latencyMax) latencyMax = ms;
+  if (ms > TOUCH_LATENCY_BUDGET_MS) {
+    statOverBudget++;
+    Serial.printf("[touch] %s took %.1f ms to act on (budget %d ms)\n", touchGestureName(event.gesture), ms, TOUCH_LATENCY_BUDGET_MS);
+  }
+}
+
+TouchStats getTouchStats() {
+  TouchStats stats;
+  stats.irqs = statIrqs;
+  stats.samples = statSamples;
+  stats.taps = statTaps;
+  stats.swipes = statSwipes;
+  stats.longPresses = statLongPresses;
+  stats.dropped = statDropped;
+  stats.handled = statHandled;
+  stats.overBudget = statOverBudget;
+  stats.lastLatencyMs = latencyLast;
+  stats.meanLatencyMs = statHandled > 0 ? latencySum / statHandled : 0;
+  stats.maxLatencyMs = latencyMax;
+  return stats;
+}
+
+const char* touchGestureName(TouchGesture gesture) {
+  switch (gesture) {
+    case GESTURE_TAP: return "tap";
+    case GESTURE_SWIPE_LEFT: return "swipe_left";
+    case GESTURE_SWIPE_RIGHT: return "swipe_right";
+    default: return "long_press";
+  }
+}
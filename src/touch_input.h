@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// TOUCH INPUT
+// The XPT2046 pulls TOUCH_IRQ low when the panel is pressed. That level
+// wakes the chip if it is in light sleep (see power.h) and a small task
+// on core 0, which reads the controller over SPI every TOUCH_SAMPLE_MS
+// while the finger stays down and sleeps otherwise. An idle screen
+// therefore costs no SPI traffic, and a long loop() pass cannot make it
+// miss a touch.
+//
+// The task classifies each press as it goes:
+//   tap         lifted without moving more than TOUCH_MOVE_SLOP_PX
+//   swipe       lifted after TOUCH_SWIPE_MIN_PX of mostly sideways travel
+//   long press  held still for TOUCH_LONG_PRESS_MS (fires while held)
+// and queues it for loop() as a TouchEvent. Drags that are none of these
+// are dropped.
+//
+// Each event is stamped when it is recognized. touchEventHandled() turns
+// the stamp into the touch-to-action latency, which /touch_stats reports
+// against TOUCH_LATENCY_BUDGET_MS.
+// =========================================================================
+
+enum TouchGesture {
+  GESTURE_TAP,
+  GESTURE_SWIPE_LEFT,  // Finger moved right to left
+  GESTURE_SWIPE_RIGHT,
+  GESTURE_LONG_PRESS,
+};
+
+struct TouchEvent {
+  TouchGesture gesture;
+  int16_t x, y;     // Screen pixel the press started at
+  unsigned long at; // micros() when it was recognized
+};
+
+struct TouchStats {
+  unsigned long irqs;        // Pen-down interrupts
+  unsigned long samples;     // SPI reads of the controller
+  unsigned long taps;
+  unsigned long swipes;
+  unsigned long longPresses;
+  unsigned long dropped;     // Gestures loop() had no room for
+  unsigned long handled;
+  unsigned long overBudget;  // Acted on later than TOUCH_LATENCY_BUDGET_MS
+  float lastLatencyMs;
+  float meanLatencyMs;
+  float maxLatencyMs;
+};
+
+// Attaches the TOUCH_IRQ interrupt and starts the sampling task.
+// Call once, after ts.begin().
+void startTouchInput();
+
+// Takes the next gesture. loop() task only; false when there is none.
+bool takeTouchEvent(TouchEvent& out);
+
+// True if a gesture is waiting. Page transitions stop early on one.
+bool touchEventPending();
+
+// Records the latency of a gesture loop() has just acted on.
+void touchEventHandled(const TouchEvent& event);
+
+TouchStats getTouchStats();
+
+// "tap", "swipe_left", "swipe_right", "long_press"
+const char* touchGestureName(TouchGesture gesture);
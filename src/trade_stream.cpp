@@ -0,0 +1,234 @@
+#include "trade_stream.h"
+#include "globals.h"    // For tradeStreamEnabled, tradeStreamUrl (copied, never read by the task)
+#include "config.h"     // For test_root_ca, TRADE_STREAM_* settings, COMMAND_TEXT_LEN
+#include "secrets.h"    // For finnhub_api_key
+#include <WebSocketsClient.h>
+#include <ArduinoJson.h>
+#include <map>
+#include <algorithm>    // For std::find
+
+static WebSocketsClient ws;
+
+// Shared with other tasks, guarded by streamLock
+static SemaphoreHandle_t streamLock = nullptr;
+static std::map<String, LivePrice> livePrices;
+static std::vector<String> desiredSymbols;
+static bool streamEnabled = false;            // Copies of tradeStreamEnabled / tradeStreamUrl,
+static char streamUrl[COMMAND_TEXT_LEN] = ""; // taken by tradeStreamReconfigure()
+
+// Stream task only
+static std::vector<String> subscribedSymbols;
+static bool running = false; // ws.begin() has been called
+
+static volatile bool symbolsChanged = false;
+static volatile bool reconfigure = true;
+static volatile bool connected = false;
+
+// --- HELPER: Split "wss://host:port/path" ---
+static bool parseStreamUrl(const String& url, String& host, uint16_t& port, String& path, bool& tls) {
+  int schemeEnd = url.indexOf("://");
+  if (schemeEnd == -1) return false;
+
+  String scheme = url.substring(0, schemeEnd);
+  tls = scheme.equalsIgnoreCase("wss");
+  if (!tls && !scheme.equalsIgnoreCase("ws")) return false;
+
+  int hostStart = schemeEnd + 3;
+  int pathStart = url.indexOf('/', hostStart);
+  String hostPort = (pathStart == -1) ? url.substring(hostStart) : url.substring(hostStart, pathStart);
+  path = (pathStart == -1) ? "/" : url.substring(pathStart);
+
+  int colon = hostPort.indexOf(':');
+  if (colon != -1) {
+    host = hostPort.substring(0, colon);
+    port = hostPort.substring(colon + 1).toInt();
+  } else {
+    host = hostPort;
+    port = tls ? 443 : 80;
+  }
+  return host.length() > 0;
+}
+
+// --- HELPER: {"type":"subscribe","symbol":"AAPL"} ---
+static void sendSubscription(const char* type, const String& symbol) {
+  String msg = String("{\"type\":\"") + type + "\",\"symbol\":\"" + symbol + "\"}";
+  ws.sendTXT(msg);
+  Serial.printf("[stream] %s %s\n", type, symbol.c_str());
+}
+
+// Brings the live subscriptions in line with stockTickerList
+static void syncSubscriptions() {
+  std::vector<String> desired;
+  xSemaphoreTake(streamLock, portMAX_DELAY);
+  desired = desiredSymbols;
+  symbolsChanged = false;
+  xSemaphoreGive(streamLock);
+
+  for (const String& symbol : subscribedSymbols) {
+    if (std::find(desired.begin(), desired.end(), symbol) == desired.end()) {
+      sendSubscription("unsubscribe", symbol);
+    }
+  }
+  for (const String& symbol : desired) {
+    if (std::find(subscribedSymbols.begin(), subscribedSymbols.end(), symbol) == subscribedSymbols.end()) {
+      sendSubscription("subscribe", symbol);
+    }
+  }
+  subscribedSymbols = desired;
+
+  // Forget prices for symbols that left the list
+  xSemaphoreTake(streamLock, portMAX_DELAY);
+  for (auto it = livePrices.begin(); it != livePrices.end();) {
+    if (std::find(desired.begin(), desired.end(), it->first) == desired.end()) it = livePrices.erase(it);
+    else ++it;
+  }
+  xSemaphoreGive(streamLock);
+}
+
+// --- HELPER: JSON Filter for trade messages ---
+// {"type":"trade","data":[{"s":"AAPL","p":189.1,"t":1700000000000,"v":10}, ...]}
+static const JsonDocument& tradeFilter() {
+  static StaticJsonDocument<96> filter;
+  if (filter.isNull()) {
+    filter["type"] = true;
+    filter["data"][0]["s"] = true;
+    filter["data"][0]["p"] = true;
+  }
+  return filter;
+}
+
+static void handleMessage(uint8_t* payload, size_t length) {
+  DynamicJsonDocument doc(TRADE_STREAM_DOC_SIZE);
+  DeserializationError error = deserializeJson(doc, (const char*)payload, length, DeserializationOption::Filter(tradeFilter()));
+  if (error || doc["type"] != "trade") return; // Also skips {"type":"ping"}
+
+  unsigned long now = millis();
+  xSemaphoreTake(streamLock, portMAX_DELAY);
+  for (JsonObject trade : doc["data"].as<JsonArray>()) {
+    const char* symbol = trade["s"];
+    if (symbol == nullptr) continue;
+    LivePrice& live = livePrices[String(symbol)]; // Last trade in the batch wins
+    live.price = trade["p"].as<float>();
+    live.updatedAt = now;
+  }
+  xSemaphoreGive(streamLock);
+}
+
+static void onStreamEvent(WStype_t type, uint8_t* payload, size_t length) {
+  switch (type) {
+    case WStype_CONNECTED:
+      Serial.println("[stream] Connected");
+      connected = true;
+      subscribedSymbols.clear(); // A new socket starts with no subscriptions
+      symbolsChanged = true;
+      break;
+    case WStype_DISCONNECTED:
+      if (connected) Serial.println("[stream] Disconnected");
+      connected = false;
+      break;
+    case WStype_TEXT:
+      handleMessage(payload, length);
+      break;
+    default:
+      break;
+  }
+}
+
+static void beginStream(const String& url) {
+  String host, path;
+  uint16_t port;
+  bool tls;
+  if (!parseStreamUrl(url, host, port, path, tls)) {
+    Serial.printf("[stream] Invalid stream URL: %s\n", url.c_str());
+    return;
+  }
+  path += (path.indexOf('?') == -1) ? "?token=" : "&token=";
+  path += finnhub_api_key;
+
+  Serial.printf("[stream] Connecting to %s://%s:%u\n", tls ? "wss" : "ws", host.c_str(), port);
+  if (tls) {
+#if ALLOW_INSECURE_TEST
+    ws.beginSSL(host.c_str(), port, path.c_str());
+#else
+    ws.beginSslWithCA(host.c_str(), port, path.c_str(), test_root_ca);
+#endif
+  } else {
+    ws.begin(host.c_str(), port, path.c_str());
+  }
+  ws.onEvent(onStreamEvent);
+  ws.setReconnectInterval(TRADE_STREAM_RECONNECT_MS);
+  ws.enableHeartbeat(15000, 3000, 2); // Detect half-open sockets
+  running = true;
+}
+
+// --- The task body (core 0) ---
+static void tradeStreamTask(void* param) {
+  for (;;) {
+    if (reconfigure) {
+      reconfigure = false;
+      if (running) {
+        ws.disconnect();
+        running = false;
+        connected = false;
+      }
+      xSemaphoreTake(streamLock, portMAX_DELAY);
+      bool enabled = streamEnabled;
+      String url = streamUrl;
+      xSemaphoreGive(streamLock);
+      if (enabled) beginStream(url);
+    }
+
+    if (!running) {
+      vTaskDelay(pdMS_TO_TICKS(250));
+      continue;
+    }
+
+    ws.loop();
+    if (connected && symbolsChanged) syncSubscriptions();
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+
+// --- Public Functions ---
+
+void startTradeStream() {
+  if (streamLock != nullptr) return; // Already running
+  streamLock = xSemaphoreCreateMutex();
+  tradeStreamReconfigure(); // The settings loaded from flash
+  xTaskCreatePinnedToCore(tradeStreamTask, "trade_stream", TRADE_STREAM_STACK, nullptr, 1, nullptr, NET_TASK_CORE);
+}
+
+void tradeStreamReconfigure() {
+  if (streamLock == nullptr) return;
+  // The globals belong to loop(); the task only ever reads this copy
+  xSemaphoreTake(streamLock, portMAX_DELAY);
+  streamEnabled = tradeStreamEnabled;
+  strlcpy(streamUrl, tradeStreamUrl.c_str(), sizeof(streamUrl));
+  xSemaphoreGive(streamLock);
+  reconfigure = true;
+}
+
+void tradeStreamSync(const std::vector<String>& symbols) {
+  if (streamLock == nullptr) return;
+  xSemaphoreTake(streamLock, portMAX_DELAY);
+  desiredSymbols = symbols;
+  symbolsChanged = true;
+  xSemaphoreGive(streamLock);
+}
+
+bool getLivePrice(const String& symbol, LivePrice& out) {
+  if (streamLock == nullptr) return false;
+  bool found = false;
+  xSemaphoreTake(streamLock, portMAX_DELAY);
+  auto it = livePrices.find(symbol);
+  if (it != livePrices.end()) {
+    out = it->second;
+    found = true;
+  }
+  xSemaphoreGive(streamLock);
+  return found;
+}
+
+bool tradeStreamConnected() {
+  return connected;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+// =========================================================================
+// FINNHUB TRADE STREAM (optional)
+// One WebSocket to Finnhub's trade feed, subscribed to every symbol in
+// stockTickerList. Trades update an in-memory last-price table that the
+// stock page reads instead of waiting for the next quote poll.
+//
+// The endpoint is tradeStreamUrl (default wss://ws.finnhub.io), so it can
+// be pointed at tools/finnhub_ws_replay.py for offline testing.
+// =========================================================================
+
+struct LivePrice {
+  float price = 0.0;
+  unsigned long updatedAt = 0; // millis() when the trade arrived
+};
+
+// Starts the stream task (it idles while tradeStreamEnabled is false)
+void startTradeStream();
+
+// loop() task: call after tradeStreamEnabled / tradeStreamUrl change.
+// The stream task reconnects with a copy of them.
+void tradeStreamReconfigure();
+
+// Call whenever stockTickerList changes; (un)subscribes to match it
+void tradeStreamSync(const std::vector<String>& symbols);
+
+// Latest streamed trade for a symbol. Safe to call from any task.
+bool getLivePrice(const String& symbol, LivePrice& out);
+
+bool tradeStreamConnected();
@@ -4,40 +4,279 @@
 #include "config.h" // For ALLOW_INSECURE_TEST
 #include "globals.h" // For Serial
 
-// Move the function HTTPSRequest() from your .ino file here
-String HTTPSRequest(String url, const char* root_ca) {
-  String response = "";
+// =========================================================================
+// HTTPS CONNECTION POOL
+// One WiFiClientSecure (and so one mbedTLS context) plus one HTTPClient
+// per upstream host. HTTP/1.1 keep-alive leaves the TLS session open
+// between requests, so repeat fetches skip both the handshake and the
+// CA parse. Only the network worker calls HTTPSRequest(), so no locking.
+// =========================================================================
+struct PooledConnection {
+  String host;
   WiFiClientSecure client;
+  HTTPClient http;
+  unsigned long lastUsed = 0;
+};
+
+static PooledConnection* pool[HTTPS_POOL_SIZE] = {nullptr};
+static HttpsPoolStats poolStats;
+
+// Extracts "finnhub.io" from "https://finnhub.io/api/v1/quote?..."
+static String hostFromUrl(const String& url) {
+  int start = url.indexOf("://");
+  start = (start == -1) ? 0 : start + 3;
+  int end = url.indexOf('/', start);
+  String host = (end == -1) ? url.substring(start) : url.substring(start, end);
+  int colon = host.indexOf(':');
+  if (colon != -1) host = host.substring(0, colon);
+  return host;
+}
+
+// Finds (or creates) the pooled connection for a host.
+// If every slot is taken, the least recently used host is evicted.
+static PooledConnection* getConnection(const String& host, const char* root_ca) {
+  int freeSlot = -1;
+  int lruSlot = -1;
+  for (int i = 0; i < HTTPS_POOL_SIZE; i++) {
+    if (pool[i] == nullptr) {
+      if (freeSlot == -1) freeSlot = i;
+      continue;
+    }
+    if (pool[i]->host == host) return pool[i];
+    if (lruSlot == -1 || pool[i]->lastUsed < pool[lruSlot]->lastUsed) lruSlot = i;
+  }
 
+  if (freeSlot == -1) {
+    Serial.printf("[https] Pool full, evicting %s\n", pool[lruSlot]->host.c_str());
+    pool[lruSlot]->client.stop();
+    delete pool[lruSlot];
+    pool[lruSlot] = nullptr;
+    freeSlot = lruSlot;
+  }
+
+  PooledConnection* conn = new PooledConnection();
+  conn->host = host;
 #if ALLOW_INSECURE_TEST
-  client.setInsecure();
+  conn->client.setInsecure();
   Serial.println("WARNING: TLS certificate verification DISABLED (ALLOW_INSECURE_TEST=1)");
 #else
-  if (root_ca != nullptr) {
-    client.setCACert(root_ca);
-    Serial.println("Using embedded CA");
-  } else {
+  conn->client.setCACert(root_ca);
+#endif
+  conn->http.setReuse(true); // Send "Connection: keep-alive" and keep the socket after end()
+  pool[freeSlot] = conn;
+  return conn;
+}
+
+// Caps the number of live TLS sessions (each one pins its mbedTLS buffers)
+// by closing the least recently used open connection other than `keep`.
+static void closeIdleConnections(PooledConnection* keep) {
+  int open = 0;
+  int lruSlot = -1;
+  for (int i = 0; i < HTTPS_POOL_SIZE; i++) {
+    if (pool[i] == nullptr || pool[i] == keep || !pool[i]->client.connected()) continue;
+    open++;
+    if (lruSlot == -1 || pool[i]->lastUsed < pool[lruSlot]->lastUsed) lruSlot = i;
+  }
+  if (open >= HTTPS_POOL_MAX_OPEN && lruSlot != -1) {
+    Serial.printf("[https] Closing idle connection to %s\n", pool[lruSlot]->host.c_str());
+    pool[lruSlot]->client.stop();
+  }
+}
+
+// Sends a GET on the pooled connection for `url`, reconnecting once if a
+// reused socket turns out to be stale. On success the response headers
+// have been read and the caller owns the body; it must call
+// conn->http.end() when done. Returns nullptr on failure.
+static PooledConnection* beginGet(const String& url, const char* root_ca) {
+#if !ALLOW_INSECURE_TEST
+  if (root_ca == nullptr) {
     Serial.println("ERROR: No root CA provided!");
-    return "Error: No CA";
+    return nullptr;
   }
 #endif
 
-  HTTPClient http;
-  http.begin(client, url);
+  PooledConnection* conn = getConnection(hostFromUrl(url), root_ca);
+  poolStats.requests++;
+
+  // Servers drop idle keep-alive sockets; don't bother trying one that is surely gone
+  if (conn->client.connected() && millis() - conn->lastUsed > HTTPS_POOL_IDLE_MS) {
+    conn->client.stop();
+  }
+
+  // Two attempts: if a reused socket turns out to be stale, reconnect once
+  for (int attempt = 0; attempt < 2; attempt++) {
+    bool reused = conn->client.connected();
+    if (!reused) closeIdleConnections(conn);
+
+    conn->http.begin(conn->client, url);
+    const char* headerKeys[] = {"Transfer-Encoding"};
+    conn->http.collectHeaders(headerKeys, 1); // Needed to de-chunk streamed bodies
+    int httpCode = conn->http.GET();
 
-  int httpCode = http.GET();
+    if (httpCode > 0) {
+      if (reused) poolStats.handshakesAvoided++;
+      else poolStats.handshakes++;
 
-  if (httpCode > 0) {
-    Serial.printf("HTTP GET code: %d\n", httpCode);
-    response = http.getString();
-  } else {
-    Serial.printf("GET request failed, code: %d, error: %s\n", httpCode, http.errorToString(httpCode).c_str());
+      Serial.printf("HTTP GET code: %d (%s, %lu handshakes avoided)\n", httpCode, reused ? "reused" : "new TLS session", poolStats.handshakesAvoided);
+      return conn;
+    }
+
+    String errorText = conn->http.errorToString(httpCode);
+    conn->http.end();
+    conn->client.stop();
+
+    if (reused) {
+      Serial.printf("[https] Pooled connection to %s was stale (%s), reconnecting\n", conn->host.c_str(), errorText.c_str());
+      poolStats.reconnects++;
+      continue;
+    }
+    Serial.printf("GET request failed, code: %d, error: %s\n", httpCode, errorText.c_str());
+    break;
   }
+  return nullptr;
+}
+
+// Leaves the socket open for the next request to this host
+static void endGet(PooledConnection* conn) {
+  conn->http.end();
+  conn->lastUsed = millis();
+}
+
+String HTTPSRequest(String url, const char* root_ca) {
+  PooledConnection* conn = beginGet(url, root_ca);
+  if (conn == nullptr) return "";
 
-  http.end();
+  String response = conn->http.getString();
+  endGet(conn);
   return response;
 }
 
+// =========================================================================
+// STREAMED RESPONSE BODIES
+// Presents just the body of the current response as a Stream, undoing
+// chunked transfer encoding and stopping at Content-Length, so a parser
+// can read straight from the socket without the whole payload in RAM.
+// =========================================================================
+class HttpBodyStream : public Stream {
+public:
+  HttpBodyStream(Client& raw, int contentLength, bool chunked)
+    : raw(raw), chunked(chunked), remaining(contentLength) {
+    if (chunked) remaining = 0; // Read the first chunk header on demand
+  }
+
+  int available() override {
+    if (finished) return 0;
+    int avail = raw.available();
+    if (!chunked && remaining >= 0 && avail > remaining) avail = remaining;
+    return avail;
+  }
+
+  int read() override {
+    if (peeked >= 0) {
+      int c = peeked;
+      peeked = -1;
+      return c;
+    }
+    return nextByte();
+  }
+
+  int peek() override {
+    if (peeked < 0) peeked = nextByte();
+    return peeked;
+  }
+
+  size_t write(uint8_t) override { return 0; } // Read-only
+
+  // Consumes whatever the parser did not read, so the kept-alive
+  // socket is positioned at the start of the next response.
+  void drain() {
+    peeked = -1;
+    while (nextByte() >= 0) {}
+  }
+
+private:
+  Client& raw;
+  bool chunked;
+  int remaining;  // Bytes left in the body (or in the current chunk); -1 = until close
+  bool finished = false;
+  int peeked = -1;
+
+  // Waits up to the stream timeout for one raw byte
+  int rawByte() {
+    unsigned long start = millis();
+    do {
+      int c = raw.read();
+      if (c >= 0) return c;
+      if (!raw.connected()) return -1; // Closed and fully read
+      delay(1);
+    } while (millis() - start < HTTPS_STREAM_TIMEOUT_MS);
+    return -1;
+  }
+
+  // Reads a CRLF-terminated line (chunk sizes and trailers)
+  String rawLine() {
+    String line;
+    int c;
+    while ((c = rawByte()) >= 0 && c != '\n') {
+      if (c != '\r') line += (char)c;
+    }
+    return line;
+  }
+
+  int nextByte() {
+    if (finished) return -1;
+
+    if (chunked && remaining == 0) {
+      remaining = (int)strtol(rawLine().c_str(), nullptr, 16);
+      if (remaining <= 0) {
+        while (rawLine().length() > 0) {} // Skip trailers up to the blank line
+        finished = true;
+        return -1;
+      }
+    }
+    if (!chunked && remaining == 0) {
+      finished = true;
+      return -1;
+    }
+
+    int c = rawByte();
+    if (c < 0) {
+      finished = true; // Timeout or connection closed
+      return -1;
+    }
+    if (remaining > 0) {
+      remaining--;
+      if (chunked && remaining == 0) rawLine(); // CRLF after the chunk data
+    }
+    return c;
+  }
+};
+
+bool HTTPSRequestStream(const String& url, const char* root_ca, HttpStreamReader reader) {
+  PooledConnection* conn = beginGet(url, root_ca);
+  if (conn == nullptr) return false;
+
+  bool chunked = conn->http.header("Transfer-Encoding").equalsIgnoreCase("chunked");
+  HttpBodyStream body(conn->http.getStream(), conn->http.getSize(), chunked);
+  bool ok = reader(body);
+  body.drain();
+  endGet(conn);
+  return ok;
+}
+
+DeserializationError HTTPSRequestJson(const String& url, const char* root_ca, JsonDocument& doc, const JsonDocument& filter) {
+  DeserializationError error = DeserializationError::EmptyInput;
+  HTTPSRequestStream(url, root_ca, [&](Stream& body) {
+    error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+    return !error;
+  });
+  return error;
+}
+
+HttpsPoolStats getHttpsPoolStats() {
+  return poolStats;
+}
+
 // Move the function to_upper() from your .ino file here
 void to_upper(const char *str, char *out_str)
 {
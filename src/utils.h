@@ -1,7 +1,30 @@
 #pragma once
 #include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+
+// Counters for the pooled HTTPS connections in HTTPSRequest()
+struct HttpsPoolStats {
+  unsigned long requests = 0;
+  unsigned long handshakes = 0;        // Full TLS handshakes performed
+  unsigned long handshakesAvoided = 0; // Requests served on a kept-alive session
+  unsigned long reconnects = 0;        // Reused sockets that turned out to be stale
+};
 
 // Helper functions
+// HTTPSRequest() keeps one TLS connection open per host between calls.
+// Only call it from the network worker task.
 String HTTPSRequest(String url, const char* root_ca);
+
+// Streaming variant: hands the response body (de-chunked, bounded by
+// Content-Length) to `reader` instead of buffering it into a String.
+// Returns false if the request failed or `reader` returned false.
+typedef std::function<bool(Stream& body)> HttpStreamReader;
+bool HTTPSRequestStream(const String& url, const char* root_ca, HttpStreamReader reader);
+
+// Parses the response straight from the socket into `doc`, keeping only
+// the fields present in `filter`. Returns EmptyInput if the request failed.
+DeserializationError HTTPSRequestJson(const String& url, const char* root_ca, JsonDocument& doc, const JsonDocument& filter);
+HttpsPoolStats getHttpsPoolStats();
 void to_upper(const char *str, char *out_str);
 float truncateDecimal(float value);
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "watchlist.h"
+#include "globals.h"    // For stockTickerList, watchlistSort, colors
+#include "config.h"     // For WATCHLIST_*, SCREEN_*, LIVE_PRICE_REDRAW_MS
+#include "drawing.h"    // For setHeaderWidget, setFooterWidget, drawStatusPage
+#include "stocks.h"     // For getCachedQuote, prefetchTicker
+#include "render.h"     // For gfx()
+#include "widgets.h"    // For WidgetPage
+#include "power.h"      // For powerTimerDue
+#include <algorithm>
+
+#define WATCHLIST_CELLS (WATCHLIST_COLS * WATCHLIST_ROWS)
+#define CELL_W (SCREEN_WIDTH / WATCHLIST_COLS)
+#define CELL_H ((SCREEN_HEIGHT - HEADER_H - FOOTER_H - 1) / WATCHLIST_ROWS)
+#define GRID_TOP (HEADER_H + 1)
+
+// One symbol and what its cell shows
+struct WatchEntry {
+  String symbol;
+  size_t listIndex = 0; // In stockTickerList
+  bool hasQuote = false;
+  bool requested = false; // Its refresh was queued (or not needed) on this visit
+  float price = 0.0, pctChange = 0.0;
+};
+
+// --- Ranking (loop() task only) ---
+static std::vector<WatchEntry> entries; // Best first
+static uint32_t listSignature = 0;      // Of the stockTickerList the entries were built from
+static int rankedBy = -1;               // The watchlistSort they are in
+
+// --- Page state ---
+static size_t visits = SIZE_MAX; // Visits to the page (the first makes it 0)
+static size_t screen = 0;        // Screenful shown: visits, wrapped
+static bool onScreen = false;
+
+const char* watchlistSortName(int sort) {
+  switch (sort) {
+    case WATCHLIST_GAINERS: return "gainers";
+    case WATCHLIST_LOSERS: return "losers";
+    default: return "list";
+  }
+}
+
+int watchlistSortFromName(const String& name) {
+  if (name == "gainers") return WATCHLIST_GAINERS;
+  if (name == "losers") return WATCHLIST_LOSERS;
+  return WATCHLIST_LIST_ORDER;
+}
+
+// --- HELPER: Rank order; symbols without a quote go last, ties stay in list order ---
+static bool ranksBefore(const WatchEntry& a, const WatchEntry& b) {
+  if (rankedBy != WATCHLIST_LIST_ORDER && a.hasQuote != b.hasQuote) return a.hasQuote;
+  if (a.hasQuote && b.hasQuote && a.pctChange != b.pctChange) {
+    if (rankedBy == WATCHLIST_GAINERS) return a.pctChange > b.pctChange;
+    if (rankedBy == WATCHLIST_LOSERS) return a.pctChange < b.pctChange;
+  }
+  return a.listIndex < b.listIndex;
+}
+
+// --- HELPER: Move entries[i] up or down past its neighbours to its rank ---
+// Only valid when the rest of the list is already in order (one quote moved).
+static void rerank(size_t i) {
+  while (i > 0 && ranksBefore(entries[i], entries[i - 1])) {
+    std::swap(entries[i], entries[i - 1]);
+    i--;
+  }
+  while (i + 1 < entries.size() && ranksBefore(entries[i + 1], entries[i])) {
+    std::swap(entries[i], entries[i + 1]);
+    i++;
+  }
+}
+
+// --- HELPER: Read an entry's quote from the cache; true if its cell changed ---
+static bool refreshEntry(WatchEntry& entry) {
+  StockQuote quote;
+  bool has = getCachedQuote(entry.symbol, quote);
+  if (has == entry.hasQuote && (!has || (quote.current == entry.price && quote.pctChange == entry.pctChange))) return false;
+  entry.hasQuote = has;
+  entry.price = has ? quote.current : 0.0;
+  entry.pctChange = has ? quote.pctChange : 0.0;
+  return true;
+}
+
+// --- HELPER: Refresh every entry; true if any changed ---
+// Several prices may have moved, so re-sort the whole list (a few dozen
+// entries at most); rerank() only fixes up a single moved entry.
+static bool refreshAll() {
+  bool changed = false;
+  for (WatchEntry& entry : entries) changed |= refreshEntry(entry);
+  if (changed) std::stable_sort(entries.begin(), entries.end(), ranksBefore);
+  return changed;
+}
+
+// --- HELPER: Rebuild if the ticker list changed, fully re-sort if the sort mode did ---
+static void syncEntries() {
+  uint32_t signature = 2166136261u;
+  for (const String& symbol : stockTickerList) signature = widgetHash(",", 1, widgetHash(symbol, signature));
+  if (signature == listSignature && rankedBy == watchlistSort) return;
+
+  if (signature != listSignature) {
+    entries.clear();
+    for (size_t i = 0; i < stockTickerList.size(); i++) {
+      WatchEntry entry;
+      entry.symbol = stockTickerList[i];
+      entry.listIndex = i;
+      refreshEntry(entry);
+      entries.push_back(entry);
+    }
+    listSignature = signature;
+  }
+  rankedBy = watchlistSort;
+  std::stable_sort(entries.begin(), entries.end(), ranksBefore);
+}
+
+// --- HELPER: Queue refreshes for the entries not asked for on this visit ---
+// The queue holds NET_QUEUE_LEN jobs and a full one refuses jobs of equal
+// priority, so only take free slots (leaving a few for the other pages),
+// the screenful on show first; the next ticks queue the rest.
+static void requestQuotes() {
+  size_t first = screen * WATCHLIST_CELLS;
+  for (size_t n = 0; n < entries.size(); n++) {
+    WatchEntry& entry = entries[(first + n) % entries.size()];
+    if (entry.requested) continue;
+    if (netQueueFree() <= WATCHLIST_QUEUE_RESERVE || !prefetchTicker(entry.symbol)) return;
+    entry.requested = true;
+  }
+}
+
+// =====================================================
+// --- PAGE ---
+// Header, footer, the grid lines, then a symbol / price / change
+// widget per cell, row by row.
+// =====================================================
+
+enum { WL_HEADER, WL_FOOTER, WL_GRID, WL_FIRST_CELL };
+#define CELL_WIDGETS 3 // Symbol, price, change
+
+static WidgetPage gridPage;
+static bool gridLaidOut = false;
+
+// --- HELPER: Build the widget table from the grid size ---
+static void layOutGrid() {
+  std::vector<WidgetSpec> specs = {
+    {WIDGET_CUSTOM, 0, 0, SCREEN_WIDTH, HEADER_H + 1, 0, 0, TL_DATUM, FONT_SMALL, 0},
+    {WIDGET_CUSTOM, 0, SCREEN_HEIGHT - FOOTER_H, SCREEN_WIDTH, FOOTER_H, 0, 0, TL_DATUM, FONT_SMALL, 0},
+    {WIDGET_CUSTOM, 0, GRID_TOP, SCREEN_WIDTH, CELL_H * WATCHLIST_ROWS, 0, 0, TL_DATUM, FONT_SMALL, 0},
+  };
+  for (int cell = 0; cell < WATCHLIST_CELLS; cell++) {
+    int16_t x = (cell % WATCHLIST_COLS) * CELL_W, y = GRID_TOP + (cell / WATCHLIST_COLS) * CELL_H;
+    int16_t line = (CELL_H - 2) / 3;
+    specs.push_back({WIDGET_LABEL, (int16_t)(x + 1), (int16_t)(y + 1), CELL_W - 2, line, (int16_t)(x + 6), (int16_t)(y + 1 + line / 2), ML_DATUM, FONT_SMALL_BOLD, 0});
+    specs.push_back({WIDGET_VALUE, (int16_t)(x + 1), (int16_t)(y + 1 + line), CELL_W - 2, line, (int16_t)(x + 6), (int16_t)(y + 1 + line + line / 2), ML_DATUM, FONT_MEDIUM_BOLD, 0});
+    specs.push_back({WIDGET_LABEL, (int16_t)(x + 1), (int16_t)(y + 1 + 2 * line), CELL_W - 2, line, (int16_t)(x + 6), (int16_t)(y + 1 + 2 * line + line / 2), ML_DATUM, FONT_SMALL, 0});
+  }
+  gridPage.setLayout(specs.data(), specs.size());
+  gridLaidOut = true;
+}
+
+// --- HELPER: Cell borders ---
+static void drawGridLines() {
+  for (int col = 1; col < WATCHLIST_COLS; col++) {
+    gfx().drawFastVLine(col * CELL_W, GRID_TOP, CELL_H * WATCHLIST_ROWS, CAT_SURFACE);
+  }
+  for (int row = 1; row < WATCHLIST_ROWS; row++) {
+    gfx().drawFastHLine(0, GRID_TOP + row * CELL_H, SCREEN_WIDTH, CAT_SURFACE);
+  }
+}
+
+// --- HELPER: Fill in the widgets from the ranking and draw what changed ---
+static void renderWatchlist() {
+  size_t screens = max((size_t)1, (entries.size() + WATCHLIST_CELLS - 1) / WATCHLIST_CELLS);
+  screen = visits % screens;
+
+  String title = watchlistSort == WATCHLIST_GAINERS ? "Top Gainers" : (watchlistSort == WATCHLIST_LOSERS ? "Top Losers" : "Watchlist");
+  if (screens > 1) title += " " + String(screen + 1) + "/" + String(screens);
+  setHeaderWidget(gridPage[WL_HEADER], title);
+  setFooterWidget(gridPage[WL_FOOTER], PAGE_WATCHLIST);
+  gridPage[WL_GRID].hash = 1; // Never changes
+  gridPage[WL_GRID].draw = drawGridLines;
+
+  for (int cell = 0; cell < WATCHLIST_CELLS; cell++) {
+    size_t rank = screen * WATCHLIST_CELLS + cell;
+    WidgetContent& symbol = gridPage[WL_FIRST_CELL + cell * CELL_WIDGETS];
+    WidgetContent& price = gridPage[WL_FIRST_CELL + cell * CELL_WIDGETS + 1];
+    WidgetContent& change = gridPage[WL_FIRST_CELL + cell * CELL_WIDGETS + 2];
+    if (rank >= entries.size()) {
+      symbol.text = price.text = change.text = "";
+      continue;
+    }
+
+    const WatchEntry& entry = entries[rank];
+    symbol.text = entry.symbol;
+    symbol.color = CAT_TEXT;
+    price.color = CAT_TEXT;
+    if (entry.hasQuote) {
+      price.text = String(entry.price, 2);
+      change.text = String(entry.pctChange >= 0 ? "+" : "") + String(entry.pctChange, 2) + "%";
+      change.color = entry.pctChange >= 0 ? CAT_GREEN : CAT_RED;
+    } else {
+      price.text = "--"; // Until its quote arrives
+      change.text = "";
+      change.color = CAT_MUTED;
+    }
+  }
+
+  gridPage.render();
+}
+
+// --- MAIN FUNCTION ---
+void showWatchlist() {
+  if (stockTickerList.empty()) {
+    drawStatusPage("Watchlist", PAGE_WATCHLIST, "No Tickers", CAT_MUTED);
+    return;
+  }
+  if (!gridLaidOut) layOutGrid();
+
+  syncEntries();
+
+  // Each visit to the page shows the next screenful
+  if (!onScreen) {
+    onScreen = true;
+    visits++;
+    for (WatchEntry& entry : entries) entry.requested = false; // Refresh again (fresh quotes are skipped)
+  }
+
+  refreshAll(); // Trades that came in while another page was up
+  renderWatchlist();
+  requestQuotes(); // Missing and stale quotes fill in as they arrive, this screenful first
+}
+
+void prefetchWatchlist() {
+  syncEntries();
+  requestQuotes();
+}
+
+void watchlistOnQuote(const String& ticker) {
+  if (entries.empty()) return; // Built when the page is first shown
+  syncEntries();
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (entries[i].symbol != ticker) continue;
+    if (!refreshEntry(entries[i])) return;
+    rerank(i);
+    break;
+  }
+  if (onScreen && currentPage == PAGE_WATCHLIST) renderWatchlist();
+}
+
+void watchlistTick() {
+  static unsigned long lastCheck = 0;
+
+  if (onScreen && currentPage != PAGE_WATCHLIST) onScreen = false; // Left the page
+  if (!onScreen) return;
+  if (!powerTimerDue(lastCheck, LIVE_PRICE_REDRAW_MS)) return;
+
+  // The web GUI may have changed the list or the sort mode
+  uint32_t signature = listSignature;
+  int sort = rankedBy;
+  syncEntries();
+  bool changed = signature != listSignature || sort != rankedBy;
+  requestQuotes(); // As the queue drains
+  if (tradeStreamEnabled) changed |= refreshAll();
+  if (changed) renderWatchlist();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// WATCHLIST GRID
+// An optional page that shows WATCHLIST_COLS x WATCHLIST_ROWS symbols of
+// stockTickerList at once, each a cell with symbol, price and % change,
+// ordered by watchlistSort. With more symbols than cells, each visit to
+// the page shows the next screenful.
+//
+// The order is kept up to date as quotes arrive: a new quote (or, with
+// live prices on, a streamed trade) moves its symbol up or down the
+// ranking by swapping it past its neighbours, instead of sorting the
+// whole list. The cells are retained widgets, so only cells whose
+// symbol, price or change moved are redrawn.
+// =========================================================================
+
+enum WatchlistSort {
+  WATCHLIST_LIST_ORDER, // As in the rotation list
+  WATCHLIST_GAINERS,    // Highest % change first
+  WATCHLIST_LOSERS,     // Lowest % change first
+};
+
+// "list", "gainers", "losers" (settings.json, /set_watchlist)
+const char* watchlistSortName(int sort);
+int watchlistSortFromName(const String& name);
+
+// Draws the page (queuing refreshes for symbols without a fresh quote).
+// Call when currentPage is PAGE_WATCHLIST.
+void showWatchlist();
+
+// Queues refreshes of the symbols' quotes ahead of the page, as many as
+// the network queue has room for; watchlistTick() queues the rest.
+void prefetchWatchlist();
+
+// Re-ranks `ticker` after its quote was fetched, and redraws the cells
+// that changed if the page is up.
+void watchlistOnQuote(const String& ticker);
+
+// Picks up streamed trades and queues the quote refreshes that did not
+// fit in the network queue yet, every LIVE_PRICE_REDRAW_MS while the
+// page is up. Call every loop() iteration.
+void watchlistTick();
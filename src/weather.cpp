@@ -1,9 +1,16 @@
 #include "weather.h"
 #include "globals.h"    // For tft, colors, etc.
 #include "config.h"     // For CAs
-#include "drawing.h"    // For drawHeader, etc.
-#include "utils.h"      // For HTTPSRequest
+#include "drawing.h"    // For drawStatusPage, chrome widgets
+#include "utils.h"      // For HTTPSRequestJson, HTTPSRequestStream
+#include "geocode_cache.h" // For resolveLocation, normalizeLocation
+#include "data_cache.h" // For TtlCache
 #include <ArduinoJson.h>
+#include "render.h"     // For gfx()
+#include "widgets.h"    // For WidgetPage
+#include "layout.h"     // For layoutFor, layoutFill
+#include "icon_cache.h" // For iconCacheGet, drawRleIcon
+#include "theme.h"      // For themeColor
 #include "Free_Fonts.h" // For FSSB12, FSSB18, etc.
 #include <time.h>       // For gmtime()
 
@@ -39,211 +46,596 @@ String getDayOfWeek(time_t unixtime) {
   }
 }
 
-// --- HELPER: Draw Geometric Weather Icons ---
-void drawWeatherIcon(int x, int y, int code, int size, bool isNight) {
+// --- Icon classes: WMO codes that share a drawing ---
+enum IconClass : uint8_t {
+  ICON_CLEAR, ICON_MAINLY_CLEAR, ICON_PARTLY_CLOUDY, ICON_CLOUDY,
+  ICON_RAIN, ICON_SNOW, ICON_STORM, ICON_UNKNOWN
+};
+
+static IconClass iconClassOf(int code) {
+  if (code == 0) return ICON_CLEAR;
+  if (code == 1) return ICON_MAINLY_CLEAR;
+  if (code == 2) return ICON_PARTLY_CLOUDY;
+  if (code == 3 || code == 45 || code == 48) return ICON_CLOUDY;
+  if ((code >= 51 && code <= 67) || (code >= 80 && code <= 82)) return ICON_RAIN;
+  if ((code >= 71 && code <= 77) || (code >= 85 && code <= 86)) return ICON_SNOW;
+  if (code >= 95 && code <= 99) return ICON_STORM;
+  return ICON_UNKNOWN;
+}
+
+// --- HELPER: Paint a Geometric Weather Icon (rasterized once per class/size/night) ---
+static void paintWeatherIcon(Gfx g, int x, int y, IconClass icon, int size, bool isNight) {
   int r = size / 2; 
   
-  // 0: Clear Sky (Sun)
-  if (code == 0 || code == 1) {
-    tft.fillCircle(x, y, r, CAT_YELLOW);
-    if (code == 0) tft.drawCircle(x, y, r + 4, CAT_YELLOW);
+  // 0, 1: Clear Sky (Sun, or a crescent Moon at night)
+  if (icon == ICON_CLEAR || icon == ICON_MAINLY_CLEAR) {
+    if (isNight) {
+      g.fillCircle(x, y, r, CAT_TEXT);
+      g.fillCircle(x + (r/2), y - (r/3), r * 0.85, CAT_BG); // Cut out the crescent
+      if (icon == ICON_CLEAR) {
+        g.fillCircle(x + r, y + (r/2), 2, CAT_TEXT); // Stars
+        g.fillCircle(x + (r/3), y + r, 1, CAT_TEXT);
+      }
+    } else {
+      g.fillCircle(x, y, r, CAT_YELLOW);
+      if (icon == ICON_CLEAR) g.drawCircle(x, y, r + 4, CAT_YELLOW);
+    }
   }
   
   // 2, 3, 45, 48: Cloudy / Fog
-  else if (code == 2 || code == 3 || code == 45 || code == 48) {
-    tft.fillCircle(x - (r/2), y + (r/4), r * 0.8, CAT_GREY); // Left puff
-    tft.fillCircle(x + (r/2), y + (r/4), r * 0.8, CAT_GREY); // Right puff
-    tft.fillCircle(x, y - (r/4), r, (code == 2) ? CAT_WHITE : CAT_GREY); // Main puff
+  else if (icon == ICON_PARTLY_CLOUDY || icon == ICON_CLOUDY) {
+    uint16_t mainPuff = (icon == ICON_PARTLY_CLOUDY && !isNight) ? CAT_WHITE : CAT_GREY;
+    g.fillCircle(x - (r/2), y + (r/4), r * 0.8, CAT_GREY); // Left puff
+    g.fillCircle(x + (r/2), y + (r/4), r * 0.8, CAT_GREY); // Right puff
+    g.fillCircle(x, y - (r/4), r, mainPuff); // Main puff
   }
   
   // 51-67, 80-82: Rain
-  else if ((code >= 51 && code <= 67) || (code >= 80 && code <= 82)) {
+  else if (icon == ICON_RAIN) {
     // Cloud Base
-    tft.fillCircle(x - (r/2), y, r * 0.7, CAT_GREY); 
-    tft.fillCircle(x + (r/2), y, r * 0.7, CAT_GREY);
-    tft.fillCircle(x, y - (r/4), r * 0.8, CAT_WHITE);
+    g.fillCircle(x - (r/2), y, r * 0.7, CAT_GREY); 
+    g.fillCircle(x + (r/2), y, r * 0.7, CAT_GREY);
+    g.fillCircle(x, y - (r/4), r * 0.8, isNight ? CAT_GREY : CAT_WHITE);
     // Rain Drops
-    tft.drawLine(x - 5, y + r, x - 5, y + r + (r/2), CAT_BLUE);
-    tft.drawLine(x + 5, y + r, x + 5, y + r + (r/2), CAT_BLUE);
-    tft.drawLine(x, y + r + 5, x, y + r + (r/2) + 5, CAT_BLUE);
+    g.drawLine(x - 5, y + r, x - 5, y + r + (r/2), CAT_BLUE);
+    g.drawLine(x + 5, y + r, x + 5, y + r + (r/2), CAT_BLUE);
+    g.drawLine(x, y + r + 5, x, y + r + (r/2) + 5, CAT_BLUE);
   }
   
   // 71-77, 85-86: Snow
-  else if ((code >= 71 && code <= 77) || (code >= 85 && code <= 86)) {
+  else if (icon == ICON_SNOW) {
     // Cloud Base
-    tft.fillCircle(x - (r/2), y, r * 0.7, CAT_GREY); 
-    tft.fillCircle(x + (r/2), y, r * 0.7, CAT_GREY);
-    tft.fillCircle(x, y - (r/4), r * 0.8, CAT_WHITE);
+    g.fillCircle(x - (r/2), y, r * 0.7, CAT_GREY); 
+    g.fillCircle(x + (r/2), y, r * 0.7, CAT_GREY);
+    g.fillCircle(x, y - (r/4), r * 0.8, isNight ? CAT_GREY : CAT_WHITE);
     // Snowflakes (White dots)
-    tft.fillCircle(x - 5, y + r, 2, CAT_WHITE);
-    tft.fillCircle(x + 5, y + r, 2, CAT_WHITE);
-    tft.fillCircle(x, y + r + 5, 2, CAT_WHITE);
+    g.fillCircle(x - 5, y + r, 2, CAT_WHITE);
+    g.fillCircle(x + 5, y + r, 2, CAT_WHITE);
+    g.fillCircle(x, y + r + 5, 2, CAT_WHITE);
   }
   
   // 95-99: Thunderstorm
-  else if (code >= 95 && code <= 99) {
+  else if (icon == ICON_STORM) {
     // Dark Cloud
-    tft.fillCircle(x - (r/2), y, r * 0.7, 0x528A); 
-    tft.fillCircle(x + (r/2), y, r * 0.7, 0x528A);
-    tft.fillCircle(x, y - (r/4), r * 0.8, 0x7BEF);
+    g.fillCircle(x - (r/2), y, r * 0.7, themeColor(SLOT_STORM_DARK)); 
+    g.fillCircle(x + (r/2), y, r * 0.7, themeColor(SLOT_STORM_DARK));
+    g.fillCircle(x, y - (r/4), r * 0.8, themeColor(SLOT_STORM_LIGHT));
     // Lightning Bolt (Yellow ZigZag)
-    tft.drawLine(x, y + (r/2), x - 5, y + r, CAT_YELLOW);
-    tft.drawLine(x - 5, y + r, x + 5, y + r, CAT_YELLOW);
-    tft.drawLine(x + 5, y + r, x, y + r + (r/2) + 5, CAT_YELLOW);
+    g.drawLine(x, y + (r/2), x - 5, y + r, CAT_YELLOW);
+    g.drawLine(x - 5, y + r, x + 5, y + r, CAT_YELLOW);
+    g.drawLine(x + 5, y + r, x, y + r + (r/2) + 5, CAT_YELLOW);
   }
-  else {
-     // Unknown
-     tft.setTextColor(CAT_TEXT);
-     tft.drawString("?", x, y);
+}
+
+// --- HELPER: Draw Geometric Weather Icons ---
+// Each (class, size, day/night) is rasterized once into the icon cache
+// and blitted from there.
+void drawWeatherIcon(int x, int y, int code, int size, bool isNight) {
+  IconClass icon = iconClassOf(code);
+  if (icon == ICON_UNKNOWN) {
+    gfx().setTextColor(CAT_TEXT);
+    gfx().drawString("?", x, y);
+    return;
   }
+
+  uint32_t key = ((uint32_t)icon << 16) | ((uint32_t)size << 1) | (isNight ? 1 : 0);
+  int reach = size; // Drops and the sun's ring stay well within one size of the centre
+  const RleIcon* cached = iconCacheGet(key, reach, [icon, size, isNight](Gfx g, int cx, int cy) {
+    paintWeatherIcon(g, cx, cy, icon, size, isNight);
+  });
+
+  if (cached != nullptr) drawRleIcon(*cached, x, y);
+  else paintWeatherIcon(gfx(), x, y, icon, size, isNight); // No memory to cache it
 }
 
-// --- MAIN FUNCTION ---
-void fetchAndDisplayWeather(String locationName) {
-  Serial.printf("Fetching weather for: %s\n", locationName.c_str());
-  
-  drawHeader("Weather");
-  drawFooter(PAGE_WEATHER);
-  drawStatusMessage("Finding location...", CAT_MUTED);
-
-  String lat, lon;
-
-  // --- Step 1: Geocoding ---
-  { 
-    String locNameFormatted = locationName;
-    locNameFormatted.trim();
-    if (locNameFormatted.indexOf(',') != -1) locNameFormatted.replace(", ", "&");
-    locNameFormatted.replace(" ", "+");
-    
-    String geoUrl = "https://geocoding-api.open-meteo.com/v1/search?name=" + locNameFormatted + "&count=1";
-    String geoResponse = HTTPSRequest(geoUrl, open_meteo_ca);
-    
-    DynamicJsonDocument geoDoc(1024);
-    DeserializationError geoError = deserializeJson(geoDoc, geoResponse);
-
-    if (geoError || !geoDoc.containsKey("results") || geoDoc["results"].size() == 0) {
-      drawStatusMessage("Loc Error", CAT_RED);
-      return;
+// --- HELPER: JSON Filter for the Forecast Endpoint ---
+// Built once; deserializeJson() drops every other field while reading
+static const JsonDocument& forecastFilter() {
+  static StaticJsonDocument<384> filter;
+  if (filter.isNull()) {
+    for (const char* key : {"time", "temperature_2m", "weather_code", "is_day"}) {
+      filter["current"][key] = true;
+    }
+    for (const char* key : {"temperature_2m", "precipitation_probability"}) {
+      filter["hourly"][key] = true;
+    }
+    for (const char* key : {"time", "weather_code", "temperature_2m_max", "temperature_2m_min"}) {
+      filter["daily"][key] = true;
     }
-    lat = geoDoc["results"][0]["latitude"].as<String>();
-    lon = geoDoc["results"][0]["longitude"].as<String>();
-  } 
+    filter["utc_offset_seconds"] = true;
+  }
+  return filter;
+}
+
+// --- Forecast cache, keyed by normalized location (loop() task only) ---
+static TtlCache<WeatherData> forecastCache(FORECAST_TTL_MS, FORECAST_CACHE_SIZE);
+
+// --- HELPER: Keep only what the page draws from one parsed forecast ---
+static bool parseForecast(JsonDocument& doc, WeatherData& weather) {
+  if (!doc.containsKey("current") || !doc.containsKey("daily")) return false;
+
+  weather.tempNow = doc["current"]["temperature_2m"].as<int>();
+  weather.codeNow = doc["current"]["weather_code"].as<int>();
+  weather.isDay = doc["current"]["is_day"].as<int>() != 0;
+  weather.utcOffset = doc["utc_offset_seconds"].as<long>();
+
+  JsonArray dailyTime = doc["daily"]["time"];
+  JsonArray dailyCode = doc["daily"]["weather_code"];
+  JsonArray dailyMax = doc["daily"]["temperature_2m_max"];
+  JsonArray dailyMin = doc["daily"]["temperature_2m_min"];
+
+  weather.days = 0;
+  for (int i = 0; i < WEATHER_DAYS && i < (int)dailyTime.size(); i++) {
+    weather.dayTime[i] = dailyTime[i];
+    weather.dayCode[i] = dailyCode[i];
+    weather.dayMax[i] = dailyMax[i].as<int>();
+    weather.dayMin[i] = dailyMin[i].as<int>();
+    weather.days++;
+  }
+
+  // Hourly series, quantized once here so drawing needs no floats.
+  // forecast_hours starts at the current (local) hour.
+  long now = doc["current"]["time"].as<long>();
+  JsonArray hourlyTemp = doc["hourly"]["temperature_2m"];
+  JsonArray hourlyRain = doc["hourly"]["precipitation_probability"];
+  HourlyForecast& hourly = weather.hourly;
+  hourly.start = now - (((now + weather.utcOffset) % 3600) + 3600) % 3600;
+  hourly.count = 0;
+  for (int i = 0; i < HOURLY_POINTS && i < (int)hourlyTemp.size(); i++) {
+    long halfC = lroundf(hourlyTemp[i].as<float>() * 2.0f);
+    hourly.tempHalfC[i] = (int8_t)constrain(halfC, -128L, 127L);
+    hourly.rainPct[i] = (uint8_t)constrain(hourlyRain[i].as<int>(), 0, 100);
+    hourly.count++;
+  }
+
+  weather.valid = true;
+  return true;
+}
+
+// --- NETWORK: Geocode, Fetch & Parse (runs on the network worker) ---
+bool fetchWeatherData(const String& locationName, WeatherData& weather) {
+  // --- Step 1: Geocoding (usually a cache hit) ---
+  GeoLocation loc;
+  if (!resolveLocation(locationName, loc)) {
+    weather.error = "Loc Error";
+    return false;
+  }
 
   // --- Step 2: Forecast API ---
-  drawStatusMessage("Fetching data...", CAT_MUTED);
-  
-  String url = "https://api.open-meteo.com/v1/forecast?latitude=" + lat + "&longitude=" + lon;
+  String url = "https://api.open-meteo.com/v1/forecast?latitude=" + String(loc.lat, 4) + "&longitude=" + String(loc.lon, 4);
   url += "&current=temperature_2m,weather_code,is_day"; 
   url += "&daily=weather_code,temperature_2m_max,temperature_2m_min";
+  url += "&hourly=temperature_2m,precipitation_probability&forecast_hours=48";
   url += "&temperature_unit=celsius&timeformat=unixtime&forecast_days=4";
+  url += "&timezone=" + loc.timezone; // Daily buckets follow the location's own midnight
   
-  String response = HTTPSRequest(url, open_meteo_ca);
-  DynamicJsonDocument doc(4096);
-  DeserializationError error = deserializeJson(doc, response);
+  // Parsed straight off the socket; only the filtered fields are kept
+  DynamicJsonDocument doc(FORECAST_DOC_SIZE);
+  DeserializationError error = HTTPSRequestJson(url, open_meteo_ca, doc, forecastFilter());
 
-  tft.fillScreen(CAT_BG);
-  drawHeader("Weather");
-  drawFooter(PAGE_WEATHER);
-  tft.setTextDatum(MC_DATUM); 
+  if (error || !parseForecast(doc, weather)) {
+    weather.error = "API Error";
+    return false;
+  }
+  return true;
+}
 
-  if (error || !doc.containsKey("current") || !doc.containsKey("daily")) {
-    drawStatusMessage("API Error", CAT_RED);
-    return;
+// --- HELPER: Skip whitespace and peek at the next character of a streamed body ---
+static int peekToken(Stream& body) {
+  int c;
+  while ((c = body.peek()) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+    body.read();
   }
+  return c;
+}
 
-  // --- Step 3: Draw MAIN Current Weather ---
-  String tempToday = String(doc["current"]["temperature_2m"].as<int>()); 
-  int codeToday = doc["current"]["weather_code"].as<int>();
-  String descToday = getWeatherDescription(codeToday);
-  
-  String maxToday = String(doc["daily"]["temperature_2m_max"][0].as<int>());
-  String minToday = String(doc["daily"]["temperature_2m_min"][0].as<int>());
+// --- NETWORK: One forecast request for a batch of locations (runs on the network worker) ---
+bool fetchWeatherBatch(WeatherBatch& batch) {
+  batch.forecasts.assign(batch.locations.size(), WeatherData());
 
-  // Location Name
-  tft.setTextColor(CAT_MUTED, CAT_BG);
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB12);
-  #else
-  tft.setTextFont(4);
-  #endif
-  tft.drawString(locationName, SCREEN_WIDTH / 2, HEADER_H + 15);
+  // --- Step 1: Geocode every location (usually cache hits) ---
+  std::vector<size_t> requested; // Batch index of each coordinate in the URL
+  String lats, lons, zones;
+  for (size_t i = 0; i < batch.locations.size(); i++) {
+    GeoLocation loc;
+    if (!resolveLocation(batch.locations[i], loc)) {
+      batch.forecasts[i].error = "Loc Error";
+      continue;
+    }
+    if (!requested.empty()) {
+      lats += ',';
+      lons += ',';
+      zones += ',';
+    }
+    lats += String(loc.lat, 4);
+    lons += String(loc.lon, 4);
+    zones += loc.timezone;
+    requested.push_back(i);
+  }
+  if (requested.empty()) return false;
 
-  // Large Weather Icon 
-  drawWeatherIcon(80, 95, codeToday, 50); 
+  // --- Step 2: Forecast API, all coordinates at once ---
+  String url = "https://api.open-meteo.com/v1/forecast?latitude=" + lats + "&longitude=" + lons;
+  url += "&current=temperature_2m,weather_code,is_day";
+  url += "&daily=weather_code,temperature_2m_max,temperature_2m_min";
+  url += "&hourly=temperature_2m,precipitation_probability&forecast_hours=48";
+  url += "&temperature_unit=celsius&timeformat=unixtime&forecast_days=4";
+  url += "&timezone=" + zones; // One per coordinate
+
+  // --- Step 3: Parse the response one location at a time ---
+  // Several coordinates come back as a JSON array in request order, a
+  // single one as a bare object. Each element is deserialized straight
+  // off the socket into the same small document.
+  size_t parsed = 0;
+  HTTPSRequestStream(url, open_meteo_ca, [&](Stream& body) {
+    DynamicJsonDocument doc(FORECAST_DOC_SIZE);
+    bool isArray = (peekToken(body) == '[');
+    if (isArray) body.read();
+
+    while (parsed < requested.size() && peekToken(body) == '{') {
+      // Stops right after the element's closing brace
+      DeserializationError error = deserializeJson(doc, body, DeserializationOption::Filter(forecastFilter()));
+      if (error) break;
+
+      WeatherData& weather = batch.forecasts[requested[parsed]];
+      if (!parseForecast(doc, weather)) weather.error = "API Error";
+      parsed++;
+
+      if (!isArray || peekToken(body) != ',') break;
+      body.read();
+    }
+    return parsed > 0;
+  });
+
+  for (size_t i = parsed; i < requested.size(); i++) {
+    batch.forecasts[requested[i]].error = "API Error";
+  }
+  Serial.printf("Batched forecast: %u of %u locations\n", (unsigned)parsed, (unsigned)batch.locations.size());
+  return parsed > 0;
+}
+
+// --- Weather and hourly page widgets (placed by the layout, see layout.h) ---
+static WidgetPage weatherPage;
+static uint32_t weatherLayoutVersion = 0;
+static WidgetPage hourlyPage;
+static uint32_t hourlyLayoutVersion = 0;
+
+// --- HELPER: Big current temperature with a drawn degree sign ---
+static void drawCurrentTemp(const WidgetSpec& spec, int tempNow) {
+  String tempToday = String(tempNow);
+
+  gfx().setTextColor(CAT_TEXT, CAT_BG);
+  gfx().setTextDatum(spec.datum);
+  applyFont(gfx(), spec.font);
+  gfx().drawString(tempToday + "C", spec.ax, spec.ay);
 
-  // Big Temp 
-  tft.setTextColor(CAT_TEXT, CAT_BG);
-  tft.setTextDatum(ML_DATUM); 
-  #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB24); 
-  #else
-  tft.setTextFont(8);
-  #endif
-  tft.drawString(tempToday + "C", 140, 85);
-  
   // Manual degree circle
-  int tempWidth = tft.textWidth(tempToday);
-  tft.drawCircle(140 + tempWidth + 6, 70, 3, CAT_TEXT); 
+  int tempWidth = gfx().textWidth(tempToday);
+  gfx().drawCircle(spec.ax + tempWidth + 6, spec.ay - 15, 3, CAT_TEXT);
+}
+
+// --- HELPER: One day card of the 3-day outlook ---
+static void drawForecastCard(const WidgetSpec& spec, const String& day, int code, int maxT, int minT) {
+  int centerX = spec.ax;
+  int startY = spec.ay;
+
+  // 1. Day Name
+  gfx().setTextColor(CAT_TEXT, CAT_BG);
+  applyFont(gfx(), spec.font);
+  gfx().setTextDatum(MC_DATUM);
+  gfx().drawString(day, centerX, startY);
 
-  // Description & High/Low 
-  tft.setTextDatum(MC_DATUM); 
-  tft.setTextColor(CAT_ACCENT, CAT_BG);
+  // 2. Icon
+  drawWeatherIcon(centerX, startY + 28, code, spec.size);
+
+  // 3. High / Low
+  gfx().setTextColor(CAT_MUTED, CAT_BG);
+  gfx().setTextDatum(MC_DATUM);
+  gfx().drawString("/", centerX, startY + 58);
+
+  gfx().setTextColor(CAT_WHITE, CAT_BG);
+  gfx().setTextDatum(MR_DATUM);
+  gfx().drawString(String(maxT), centerX - 5, startY + 58);
+
+  gfx().setTextColor(CAT_GREY, CAT_BG);
+  gfx().setTextDatum(ML_DATUM);
+  gfx().drawString(String(minT), centerX + 5, startY + 58);
+}
+
+// --- DRAW: Weather Page ---
+// Fills in the widgets and lets the page redraw whatever changed.
+void drawWeatherPage(const String& locationName, const WeatherData& weather, long ageMs, uint16_t ageColor) {
+  if (!weather.valid) {
+    drawStatusPage("Weather", PAGE_WEATHER, weather.error.length() > 0 ? weather.error : "API Error", CAT_RED);
+    return;
+  }
+
+  LayoutData data;
+  data.page = PAGE_WEATHER;
+  data.location = &locationName;
+  data.weather = &weather;
+  data.ageMs = ageMs;
+  data.ageColor = ageColor;
+
+  const PageLayout& layout = layoutFor(PAGE_WEATHER, weatherPage, weatherLayoutVersion);
+  for (size_t i = 0; i < layout.items.size(); i++) {
+    if (layoutFill(layout, i, weatherPage[i], data)) continue;
+    WidgetContent& widget = weatherPage[i];
+    WidgetSpec spec = layout.specs[i]; // Copied into the draw: a reload frees the table
+
+    // Big current temperature
+    if (layout.items[i].type == LAYOUT_TEMP) {
+      int tempNow = weather.tempNow;
+      widget.hash = widgetHash(&tempNow, sizeof(tempNow));
+      widget.draw = [spec, tempNow]() { drawCurrentTemp(spec, tempNow); };
+      continue;
+    }
+
+    // One day of the outlook, blank past the end of the forecast
+    int d = layout.items[i].day;
+    if (layout.items[i].type != LAYOUT_CARD || weather.days <= d) {
+      widget.hash = 0;
+      widget.draw = nullptr;
+      continue;
+    }
+    String day = getDayOfWeek(weather.dayTime[d] + weather.utcOffset);
+    int code = weather.dayCode[d];
+    int maxT = weather.dayMax[d];
+    int minT = weather.dayMin[d];
+    int fields[3] = {code, maxT, minT};
+    widget.hash = widgetHash(fields, sizeof(fields), widgetHash(day));
+    widget.draw = [spec, day, code, maxT, minT]() { drawForecastCard(spec, day, code, maxT, minT); };
+  }
+
+  weatherPage.render();
+}
+
+// --- HELPER: The hourly charts ---
+// Temperature line on top, rain chance bars below, day names at local
+// midnight, from the top-left of the chart widget. The series is already
+// packed to integers, so this is all integer math.
+static void drawHourlyChart(const WidgetSpec& spec, const HourlyForecast& hourly, long utcOffset) {
+  const int chartX = spec.x + 32;
+  const int stepX = 6;  // 48 points x 6 px
+  const int tempY = spec.y + 8, tempH = 70;
+  const int rainY = spec.y + 92, rainH = 44;
+  const int labelY = spec.y + 150;
+  int lastX = chartX + (hourly.count - 1) * stepX;
+
+  // 1. Temperature scale (half-degrees), padded so the line never touches the edges
+  int lo = hourly.tempHalfC[0], hi = lo;
+  for (int i = 1; i < hourly.count; i++) {
+    if (hourly.tempHalfC[i] < lo) lo = hourly.tempHalfC[i];
+    if (hourly.tempHalfC[i] > hi) hi = hourly.tempHalfC[i];
+  }
+  lo -= 1;
+  hi += 1;
+  int range = hi - lo;
+
+  gfx().setTextColor(CAT_MUTED, CAT_BG);
   #if USE_FREE_FONTS
-  tft.setFreeFont(FSSB9);
+  gfx().setFreeFont(FSS9);
   #else
-  tft.setTextFont(2);
+  gfx().setTextFont(1);
   #endif
-  String subText = descToday + " (" + maxToday + "/" + minToday + ")";
-  tft.drawString(subText, SCREEN_WIDTH / 2, 135);
+  gfx().setTextDatum(MR_DATUM);
+  gfx().drawString(String((hi - 1) / 2), chartX - 6, tempY);
+  gfx().drawString(String((lo + 1) / 2), chartX - 6, tempY + tempH);
+  gfx().drawString("%", chartX - 6, rainY + rainH / 2);
 
-  // --- Step 4: Draw 3-Day Forecast ---
-  tft.drawFastHLine(10, 150, SCREEN_WIDTH - 20, CAT_MUTED);
+  // Freezing line, if the range crosses it
+  if (lo < 0 && hi > 0) {
+    int zeroY = tempY + (hi * tempH) / range;
+    for (int x = chartX; x < lastX; x += 4) gfx().drawFastHLine(x, zeroY, 2, CAT_BLUE);
+  }
 
-  JsonArray dailyTime = doc["daily"]["time"];
-  JsonArray dailyCode = doc["daily"]["weather_code"];
-  JsonArray dailyMax = doc["daily"]["temperature_2m_max"];
-  JsonArray dailyMin = doc["daily"]["temperature_2m_min"];
+  // 2. Day boundaries at local midnight, with the day's name
+  gfx().setTextDatum(MC_DATUM);
+  gfx().setTextColor(CAT_MUTED, CAT_BG);
+  int firstHour = ((hourly.start + utcOffset) / 3600) % 24;
+  for (int i = 0; i < hourly.count; i++) {
+    int hour = (firstHour + i) % 24;
+    int x = chartX + i * stepX;
+    if (hour == 0) {
+      gfx().drawFastVLine(x, tempY, rainY + rainH - tempY, CAT_SURFACE);
+      gfx().drawString(getDayOfWeek(hourly.start + utcOffset + i * 3600L), x, labelY);
+    } else if (hour == 12) {
+      gfx().drawString("12", x, labelY);
+    }
+  }
 
-  int cardWidth = (SCREEN_WIDTH - 20) / 3; 
-  int startY = 160;
-  
-  for (int i = 1; i <= 3; i++) {
-    if (dailyTime.size() <= i) break;
-
-    int centerX = 10 + (cardWidth * (i - 1)) + (cardWidth / 2);
-    
-    time_t time = dailyTime[i];
-    String day = getDayOfWeek(time);
-    int code = dailyCode[i];
-    int maxT = dailyMax[i].as<int>();
-    int minT = dailyMin[i].as<int>();
-    
-    // 1. Day Name
-    tft.setTextColor(CAT_TEXT, CAT_BG);
-    #if USE_FREE_FONTS
-    tft.setFreeFont(FSSB9);
-    #else
-    tft.setTextFont(2);
-    #endif
-    tft.setTextDatum(MC_DATUM);
-    tft.drawString(day, centerX, startY);
-
-    // 2. Icon
-    drawWeatherIcon(centerX, startY + 28, code, 30); 
-
-    // 3. High / Low
-    tft.setTextColor(CAT_MUTED, CAT_BG);
-    tft.setTextDatum(MC_DATUM);
-    tft.drawString("/", centerX, startY + 58);
-
-    tft.setTextColor(CAT_WHITE, CAT_BG); 
-    tft.setTextDatum(MR_DATUM); 
-    tft.drawString(String(maxT), centerX - 5, startY + 58);
-
-    tft.setTextColor(CAT_GREY, CAT_BG);
-    tft.setTextDatum(ML_DATUM); 
-    tft.drawString(String(minT), centerX + 5, startY + 58);
-    
-    tft.setTextDatum(MC_DATUM); 
-  }
-}
\ No newline at end of file
+  // 3. Rain chance bars (0-100%)
+  for (int i = 0; i < hourly.count; i++) {
+    int h = (hourly.rainPct[i] * rainH) / 100;
+    if (h > 0) gfx().fillRect(chartX + i * stepX - 2, rainY + rainH - h, stepX - 1, h, CAT_BLUE);
+  }
+  gfx().drawFastHLine(chartX - 2, rainY + rainH, lastX - chartX + 5, CAT_MUTED);
+
+  // 4. Temperature line
+  int prevY = tempY + ((hi - hourly.tempHalfC[0]) * tempH) / range;
+  for (int i = 1; i < hourly.count; i++) {
+    int y = tempY + ((hi - hourly.tempHalfC[i]) * tempH) / range;
+    gfx().drawLine(chartX + (i - 1) * stepX, prevY, chartX + i * stepX, y, CAT_YELLOW);
+    prevY = y;
+  }
+}
+
+// --- DRAW: 48-Hour Hourly Page ---
+void drawHourlyPage(const String& locationName, const WeatherData& weather, long ageMs, uint16_t ageColor) {
+  if (!weather.valid || weather.hourly.count < 2) {
+    drawStatusPage("Hourly", PAGE_HOURLY, weather.error.length() > 0 ? weather.error : "No Hourly Data", CAT_RED);
+    return;
+  }
+
+  LayoutData data;
+  data.page = PAGE_HOURLY;
+  data.location = &locationName;
+  data.weather = &weather;
+  data.ageMs = ageMs;
+  data.ageColor = ageColor;
+
+  // The chart is one widget: a new forecast redraws all of it, a new
+  // data age none of it
+  const HourlyForecast& hourly = weather.hourly;
+  long utcOffset = weather.utcOffset;
+  uint32_t hash = widgetHash(&utcOffset, sizeof(utcOffset));
+  hash = widgetHash(&hourly.start, sizeof(hourly.start), hash);
+  hash = widgetHash(&hourly.count, sizeof(hourly.count), hash);
+  hash = widgetHash(hourly.tempHalfC, hourly.count, hash);
+  hash = widgetHash(hourly.rainPct, hourly.count, hash);
+
+  const PageLayout& layout = layoutFor(PAGE_HOURLY, hourlyPage, hourlyLayoutVersion);
+  for (size_t i = 0; i < layout.items.size(); i++) {
+    if (layoutFill(layout, i, hourlyPage[i], data)) continue;
+    WidgetSpec spec = layout.specs[i];
+    hourlyPage[i].hash = hash;
+    // A copy, since the page may be redrawn (or animated away from) after
+    // the forecast it came from is gone
+    hourlyPage[i].draw = [spec, hourly, utcOffset]() { drawHourlyChart(spec, hourly, utcOffset); };
+  }
+
+  hourlyPage.render();
+}
+
+// --- HELPER: Draw whichever forecast page is current ---
+static void drawForecastPage(const String& locationName, const WeatherData& weather, long ageMs = -1, uint16_t ageColor = 0) {
+  if (currentPage == PAGE_HOURLY) drawHourlyPage(locationName, weather, ageMs, ageColor);
+  else drawWeatherPage(locationName, weather, ageMs, ageColor);
+}
+
+// --- HELPER: Draw a cached forecast with its age in the footer ---
+static void drawCachedWeather(const String& locationName, const TtlCache<WeatherData>::Entry& entry) {
+  unsigned long ageMs = forecastCache.ageMs(entry);
+  uint16_t ageColor = entry.lastFetchFailed ? CAT_RED : (forecastCache.isFresh(entry) ? CAT_MUTED : CAT_YELLOW);
+  drawForecastPage(locationName, entry.value, ageMs, ageColor);
+}
+
+// --- HELPER: Store a finished fetch, redraw if it is on screen ---
+static void onWeatherFetched(const String& key, bool ok, const WeatherData& weather) {
+  // A failed refresh keeps the last good forecast in the cache
+  if (ok) forecastCache.put(key, weather);
+  else forecastCache.markFailed(key);
+
+  // The page may have moved on while we were fetching
+  if ((currentPage != PAGE_WEATHER && currentPage != PAGE_HOURLY) || normalizeLocation(lastWeatherLocation) != key) return;
+
+  TtlCache<WeatherData>::Entry* entry = forecastCache.get(key);
+  if (entry != nullptr) {
+    drawCachedWeather(lastWeatherLocation, *entry);
+  } else {
+    drawForecastPage(lastWeatherLocation, weather); // Nothing good to fall back on
+  }
+}
+
+// --- HELPER: Which batch of weatherLocationList a location is in (-1 = none) ---
+static int batchIndexOf(const String& key) {
+  for (size_t i = 0; i < weatherLocationList.size(); i++) {
+    if (normalizeLocation(weatherLocationList[i]) == key) return i / WEATHER_BATCH_SIZE;
+  }
+  return -1;
+}
+
+// --- HELPER: Queue a batched refresh of one slice of the rotation list ---
+static bool scheduleBatch(int batchIndex, NetPriority priority) {
+  size_t first = batchIndex * WEATHER_BATCH_SIZE;
+  size_t last = min(first + WEATHER_BATCH_SIZE, weatherLocationList.size());
+  std::vector<String> locations(weatherLocationList.begin() + first, weatherLocationList.begin() + last);
+
+  bool queued = netSchedule<WeatherBatch>("weather:batch" + String(batchIndex), PROVIDER_OPEN_METEO, priority,
+    [locations](WeatherBatch& batch) {
+      batch.locations = locations;
+      return fetchWeatherBatch(batch);
+    },
+    [locations](bool ok, const WeatherBatch& batch) {
+      // A job bumped from the queue never ran and has no forecasts
+      const std::vector<String>& fetched = batch.forecasts.empty() ? locations : batch.locations;
+      for (size_t i = 0; i < fetched.size(); i++) {
+        WeatherData weather = (i < batch.forecasts.size()) ? batch.forecasts[i] : WeatherData();
+        onWeatherFetched(normalizeLocation(fetched[i]), weather.valid, weather);
+      }
+    });
+
+  if (queued) {
+    for (const String& location : locations) {
+      TtlCache<WeatherData>::Entry* cached = forecastCache.get(normalizeLocation(location));
+      if (cached != nullptr) cached->refreshing = true;
+    }
+  }
+  return queued;
+}
+
+// --- HELPER: Queue a forecast fetch (merged with one already in flight) ---
+// Locations in the rotation list are refreshed a whole batch at a time;
+// one-off locations get a request of their own.
+static bool scheduleWeather(const String& locationName, const String& key, NetPriority priority) {
+  int batchIndex = batchIndexOf(key);
+  if (batchIndex >= 0) return scheduleBatch(batchIndex, priority);
+
+  bool queued = netSchedule<WeatherData>("weather:" + key, PROVIDER_OPEN_METEO, priority,
+    [locationName](WeatherData& weather) {
+      return fetchWeatherData(locationName, weather);
+    },
+    [key](bool ok, const WeatherData& weather) {
+      onWeatherFetched(key, ok, weather);
+    });
+
+  TtlCache<WeatherData>::Entry* cached = forecastCache.get(key);
+  if (queued && cached != nullptr) cached->refreshing = true;
+  return queued;
+}
+
+// --- MAIN FUNCTION ---
+void fetchAndDisplayWeather(String locationName, NetPriority priority) {
+  String key = normalizeLocation(locationName);
+
+  // Serve from the cache straight away; only go upstream when the
+  // entry is missing or past its TTL (stale-while-revalidate).
+  TtlCache<WeatherData>::Entry* cached = forecastCache.get(key);
+  if (cached != nullptr) {
+    drawCachedWeather(locationName, *cached);
+    if (forecastCache.isFresh(*cached)) {
+      forecastCache.hits++;
+      Serial.printf("Forecast cache hit (%lu s old, %lu hits / %lu misses)\n", forecastCache.ageMs(*cached) / 1000, forecastCache.hits, forecastCache.misses);
+      return;
+    }
+    forecastCache.stale++;
+    if (cached->refreshing && priority != NET_PRIO_INTERACTIVE) return; // Already revalidating
+  } else {
+    forecastCache.misses++;
+    drawStatusPage(currentPage == PAGE_HOURLY ? "Hourly" : "Weather", currentPage, "Fetching weather...", CAT_MUTED);
+  }
+
+  Serial.printf("Fetching weather for: %s\n", locationName.c_str());
+
+  // An interactive request for a queued refresh just bumps its priority
+  if (!scheduleWeather(locationName, key, priority) && cached == nullptr) {
+    drawStatusPage(currentPage == PAGE_HOURLY ? "Hourly" : "Weather", currentPage, "Network Busy", CAT_RED);
+  }
+}
+
+void prefetchWeather(const String& locationName) {
+  String key = normalizeLocation(locationName);
+  TtlCache<WeatherData>::Entry* cached = forecastCache.get(key);
+  if (cached != nullptr && (forecastCache.isFresh(*cached) || cached->refreshing)) return;
+  scheduleWeather(locationName, key, NET_PRIO_ROTATION);
+}
@@ -1,9 +1,65 @@
 #pragma once
 #include <Arduino.h>
+#include "net_worker.h" // For NetPriority
+#include <vector>
 
-void fetchAndDisplayWeather(String locationName);
+#define WEATHER_DAYS 4 // Today + 3-day outlook (forecast_days=4)
+#define HOURLY_POINTS 48 // Hourly page (forecast_hours=48)
+
+// Hourly series for the chart page, packed to ~100 bytes per location:
+// one signed byte per temperature and one byte per rain chance.
+struct HourlyForecast {
+  time_t start = 0;  // UTC time of the first point (the current hour)
+  uint8_t count = 0; // Points in use
+  int8_t tempHalfC[HOURLY_POINTS] = {0}; // Half-degrees C (-64.0 .. +63.5)
+  uint8_t rainPct[HOURLY_POINTS] = {0};  // Precipitation probability, 0-100
+};
+
+// Parsed Open-Meteo forecast, trimmed to what the page draws
+struct WeatherData {
+  int tempNow = 0;
+  int codeNow = 0;
+  bool isDay = true;
+  long utcOffset = 0; // Seconds; dayTime[] is local midnight in this zone
+  int days = 0;
+  time_t dayTime[WEATHER_DAYS] = {0};
+  int dayCode[WEATHER_DAYS] = {0};
+  int dayMax[WEATHER_DAYS] = {0};
+  int dayMin[WEATHER_DAYS] = {0};
+  HourlyForecast hourly;
+  bool valid = false;
+  String error; // Status text to show when !valid
+};
+
+// One batched forecast request: forecasts[i] belongs to locations[i]
+struct WeatherBatch {
+  std::vector<String> locations;
+  std::vector<WeatherData> forecasts;
+};
+
+// Shows the weather (or hourly) page for `locationName` right away (from
+// the last good forecast if we have one) and queues a fresh one on the
+// network worker.
+void fetchAndDisplayWeather(String locationName, NetPriority priority = NET_PRIO_ROTATION);
+
+// Warms the forecast cache for a location that is about to be shown.
+void prefetchWeather(const String& locationName);
+
+// Blocking geocode + forecast fetch. Only call this from the network worker.
+bool fetchWeatherData(const String& locationName, WeatherData& weather);
+
+// Same, for every location in `batch` with a single forecast request.
+// True if at least one forecast came back.
+bool fetchWeatherBatch(WeatherBatch& batch);
+
+// Shows the weather page for an already-parsed forecast, redrawing only
+// what changed since the last call. A negative ageMs leaves the data age blank.
+void drawWeatherPage(const String& locationName, const WeatherData& weather, long ageMs = -1, uint16_t ageColor = 0);
+
+// Shows the 48-hour temperature / rain chance charts. Integer math only.
+void drawHourlyPage(const String& locationName, const WeatherData& weather, long ageMs = -1, uint16_t ageColor = 0);
 
 // Helper functions (optional to expose, but good for debugging)
 String getWeatherDescription(int code);
 String getDayOfWeek(time_t unixtime);
-void drawWeatherIcon(int x, int y, int code, int size, bool isNight = false);
\ No newline at end of file
+void drawWeatherIcon(int x, int y, int code, int size, bool isNight = false);
@@ -1,13 +1,24 @@
 #include "web_server.h"
-#include "globals.h"  // For server, inputUpdated, etc.
+#include "globals.h"  // For server, lists, etc.
 #include "config.h"   // For index_html
-#include "secrets.h"  // For default ssid/password
-#include "utils.h"    // For to_upper
-#include "drawing.h"  // For updateHeaderIP(), drawStatusMessage()
-#include "persistence.h" // For saving settings
+#include "utils.h"    // For to_upper, getHttpsPoolStats
+#include "persistence.h" // For readFile
+#include "trade_stream.h" // For tradeStreamConnected
+#include "net_worker.h" // For netSchedulerStatusJson
+#include "render.h"   // For getRenderStats
+#include "profiler.h" // For profilerJson
+#include "icon_cache.h" // For getIconCacheStats
+#include "screen_mirror.h" // For setupScreenMirror
+#include "layout.h"   // For layoutValidate
+#include "watchlist.h" // For watchlistSortName
+#include "theme.h"     // For themeName, themeFromName
+#include "command_queue.h" // For postCommand
+#include "touch_input.h" // For getTouchStats
+#include "power.h"     // For getPowerStats, nightModeName
+#include "wifi_switch.h" // For wifiSwitchRequest, getWifiSwitchStatus
+#include <LittleFS.h>
 #include <vector>
 #include <ArduinoJson.h>
-#include <algorithm> // For std::find
 #include <WiFi.h>
 #include <Update.h>  // For OTA Updates
 
@@ -16,7 +27,59 @@ void notFound(AsyncWebServerRequest *request) {
   request->send(404, "text/plain", "Not found");
 }
 
+// --- What the handlers show of loop()'s lists and strings (under snapshotLock) ---
+struct WebSnapshot {
+  std::vector<String> stocks;
+  std::vector<String> locations;
+  String ssid;
+  String streamUrl;
+  uint32_t applied = 0; // commandsTaken() when it was published
+};
+static SemaphoreHandle_t snapshotLock = nullptr;
+static WebSnapshot snapshot;
+
+void publishWebSnapshot() {
+  WebSnapshot fresh;
+  fresh.stocks = stockTickerList;
+  fresh.locations = weatherLocationList;
+  fresh.ssid = currentSsid;
+  fresh.streamUrl = tradeStreamUrl;
+  fresh.applied = commandsTaken();
+
+  if (snapshotLock == nullptr) snapshotLock = xSemaphoreCreateMutex();
+  xSemaphoreTake(snapshotLock, portMAX_DELAY);
+  std::swap(snapshot, fresh); // The old copy is freed outside the lock
+  xSemaphoreGive(snapshotLock);
+}
+
+// --- HELPER: A copy of the last snapshot, for one request ---
+static WebSnapshot readSnapshot() {
+  xSemaphoreTake(snapshotLock, portMAX_DELAY);
+  WebSnapshot copy = snapshot;
+  xSemaphoreGive(snapshotLock);
+  return copy;
+}
+
+// --- HELPER: Answer a request that posted a command for loop() ---
+static void sendPosted(AsyncWebServerRequest *request, bool posted) {
+  if (posted) {
+    request->send(200, "text/plain", "OK");
+  } else {
+    request->send(503, "text/plain", "The display is busy, try again.");
+  }
+}
+
+// --- HELPER: Post a command that carries `text` (a list item) and answer ---
+static void sendPostedText(AsyncWebServerRequest *request, CommandType type, const String& text, int32_t value = 0) {
+  if (text.length() >= COMMAND_TEXT_LEN) {
+    request->send(400, "text/plain", "Too long (max " + String(COMMAND_TEXT_LEN - 1) + " characters)");
+    return;
+  }
+  sendPosted(request, postCommand(type, value, 0, text.c_str()));
+}
+
 // Main setup function for all server endpoints
+
 void setup_web_server() {
   
   // --- Main Web Page ---
@@ -27,10 +90,13 @@ void setup_web_server() {
   // --- One-off Stock Fetch ---
   server.on("/get_stock", HTTP_GET, [] (AsyncWebServerRequest *request) {
     if (request->hasParam("ticker")) {
-      lastTicker = request->getParam("ticker")->value();
-      lastTicker.trim();
-      lastTicker.toUpperCase();
-      inputUpdated = true; // Flag for main loop
+      String ticker = request->getParam("ticker")->value();
+      ticker.trim();
+      ticker.toUpperCase();
+      if (!postCommand(CMD_SHOW_TICKER, 0, 0, ticker.c_str())) {
+        sendPosted(request, false);
+        return;
+      }
     }
     request->redirect("/"); // Redirect back to main page
   });
@@ -38,26 +104,45 @@ void setup_web_server() {
   // --- One-off Weather Fetch ---
   server.on("/get_weather", HTTP_GET, [] (AsyncWebServerRequest *request) {
     if (request->hasParam("location")) {
-      lastWeatherLocation = request->getParam("location")->value();
-      lastWeatherLocation.trim();
-      weatherInputUpdated = true; // Flag for main loop
+      String location = request->getParam("location")->value();
+      location.trim();
+      if (!postCommand(CMD_SHOW_LOCATION, 0, 0, location.c_str())) {
+        sendPosted(request, false);
+        return;
+      }
     }
     request->redirect("/"); // Redirect back to main page
   });
 
   // --- API to load lists on web page ---
+  // The lists are loop()'s; "pending" is true until it has applied every edit posted so far
   server.on("/get_lists", HTTP_GET, [](AsyncWebServerRequest *request){
-    StaticJsonDocument<1024> doc;
+    WebSnapshot lists = readSnapshot();
+    StaticJsonDocument<1536> doc;
     JsonArray stocks = doc.createNestedArray("stocks");
-    for (const String& ticker : stockTickerList) {
+    for (const String& ticker : lists.stocks) {
       stocks.add(ticker);
     }
     JsonArray locations = doc.createNestedArray("locations");
-    for (const String& loc : weatherLocationList) {
+    for (const String& loc : lists.locations) {
       locations.add(loc);
     }
+    doc["pending"] = commandsPosted() != lists.applied;
     // Add the current rotation interval
     doc["interval_sec"] = rotationInterval / 1000; // Send as seconds
+    doc["hourly_enabled"] = hourlyEnabled;
+    doc["watchlist_enabled"] = watchlistEnabled;
+    doc["watchlist_sort"] = watchlistSortName(watchlistSort);
+    doc["tape_enabled"] = tapeEnabled;
+    doc["theme"] = themeName(uiTheme);
+    doc["night_mode"] = nightModeName(nightMode);
+    doc["night_start"] = nightStartHour;
+    doc["night_end"] = nightEndHour;
+
+    // Live price stream settings
+    doc["stream_enabled"] = tradeStreamEnabled;
+    doc["stream_url"] = lists.streamUrl;
+    doc["stream_connected"] = tradeStreamConnected();
     
     String jsonResponse;
     serializeJson(doc, jsonResponse);
@@ -65,29 +150,23 @@ void setup_web_server() {
   });
 
   // --- API to Add/Remove Stocks (No Redirect) ---
+  // loop() owns the lists: it checks for duplicates and saves them
   server.on("/add_stock", HTTP_GET, [](AsyncWebServerRequest *request){
     if (request->hasParam("ticker")) {
       String newTicker = request->getParam("ticker")->value();
       newTicker.trim();
       newTicker.toUpperCase();
       if (newTicker.length() > 0) {
-        // Prevent duplicates
-        if (std::find(stockTickerList.begin(), stockTickerList.end(), newTicker) == stockTickerList.end()) {
-          stockTickerList.push_back(newTicker);
-          saveStockList(); // Save to flash
-        }
+        sendPostedText(request, CMD_ADD_STOCK, newTicker);
+        return;
       }
     }
     request->send(200, "text/plain", "OK");
   });
   server.on("/remove_stock", HTTP_GET, [](AsyncWebServerRequest *request){
     if (request->hasParam("ticker")) {
-      String tickerToRemove = request->getParam("ticker")->value();
-      auto it = std::find(stockTickerList.begin(), stockTickerList.end(), tickerToRemove);
-      if (it != stockTickerList.end()) {
-        stockTickerList.erase(it);
-        saveStockList(); // Save to flash
-      }
+      sendPostedText(request, CMD_REMOVE_STOCK, request->getParam("ticker")->value());
+      return;
     }
     request->send(200, "text/plain", "OK");
   });
@@ -98,60 +177,29 @@ void setup_web_server() {
       String newLoc = request->getParam("location")->value();
       newLoc.trim();
       if (newLoc.length() > 0) {
-        // Prevent duplicates
-        if (std::find(weatherLocationList.begin(), weatherLocationList.end(), newLoc) == weatherLocationList.end()) {
-          weatherLocationList.push_back(newLoc);
-          saveWeatherList(); // Save to flash
-        }
+        sendPostedText(request, CMD_ADD_LOCATION, newLoc);
+        return;
       }
     }
     request->send(200, "text/plain", "OK");
   });
   server.on("/remove_location", HTTP_GET, [](AsyncWebServerRequest *request){
     if (request->hasParam("location")) {
-      String locToRemove = request->getParam("location")->value();
-      auto it = std::find(weatherLocationList.begin(), weatherLocationList.end(), locToRemove);
-      if (it != weatherLocationList.end()) {
-        weatherLocationList.erase(it);
-        saveWeatherList(); // Save to flash
-      }
+      sendPostedText(request, CMD_REMOVE_LOCATION, request->getParam("location")->value());
+      return;
     }
     request->send(200, "text/plain", "OK");
   });
 
   // --- NEW ENDPOINT: Update List Order ---
+  // list=a,b,c replaces the whole list, however long; loop() splits it
   server.on("/update_lists", HTTP_GET, [](AsyncWebServerRequest *request){
     if (request->hasParam("type") && request->hasParam("list")) {
       String type = request->getParam("type")->value();
       String listStr = request->getParam("list")->value();
-
-      std::vector<String> newList;
-      // Basic string split logic
-      String currentItem = "";
-      for (int i = 0; i < listStr.length(); i++) {
-        if (listStr[i] == ',') {
-          if (currentItem.length() > 0) {
-            newList.push_back(currentItem);
-          }
-          currentItem = "";
-        } else {
-          currentItem += listStr[i];
-        }
-      }
-      // Add the last item
-      if (currentItem.length() > 0) {
-        newList.push_back(currentItem);
-      }
-
-      // Overwrite the global list and save
-      if (type == "stocks") {
-        stockTickerList = newList;
-        saveStockList();
-        Serial.println("Updated stock list order.");
-      } else if (type == "locations") {
-        weatherLocationList = newList;
-        saveWeatherList();
-        Serial.println("Updated weather list order.");
+      if (type == "stocks" || type == "locations") {
+        sendPosted(request, postCommandLong(CMD_SET_LIST, type == "stocks" ? LIST_STOCKS : LIST_LOCATIONS, listStr));
+        return;
       }
     }
     request->send(200, "text/plain", "OK");
@@ -162,89 +210,272 @@ void setup_web_server() {
     if (request->hasParam("interval_sec")) {
       long newInterval = request->getParam("interval_sec")->value().toInt();
       if (newInterval >= 10) { // Enforce a minimum
-        rotationInterval = newInterval * 1000; // Convert sec to ms
-        saveAppSettings(); // Save to settings.json
-        Serial.printf("Rotation interval set to: %lu ms\n", rotationInterval);
+        sendPosted(request, postCommand(CMD_SET_INTERVAL, newInterval * 1000)); // Convert sec to ms
+        return;
       }
     }
     request->send(200, "text/plain", "OK");
   });
 
-  // --- NEW ENDPOINT: Restore Default Lists ---
-  server.on("/restore_defaults", HTTP_GET, [](AsyncWebServerRequest *request){
-    Serial.println("Restoring default lists from secrets...");
-    
-    // Copy from secrets (defined in secrets.cpp, extern in secrets.h)
-    stockTickerList = defaultStockList;
-    weatherLocationList = defaultWeatherList;
-    
-    // Reset indices
-    currentStockIndex = 0;
-    currentLocIndex = 0;
+  // --- API: Hourly forecast page in the rotation ---
+  server.on("/set_hourly", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (request->hasParam("enabled")) {
+      sendPosted(request, postCommand(CMD_SET_HOURLY, request->getParam("enabled")->value() == "1"));
+      return;
+    }
+    request->send(200, "text/plain", "OK");
+  });
 
-    // Save these defaults back to the persistence files
-    saveStockList();
-    saveWeatherList();
-    
+  // --- API: Watchlist grid page in the rotation, and its order ---
+  server.on("/set_watchlist", HTTP_GET, [](AsyncWebServerRequest *request){
+    int enabled = request->hasParam("enabled") ? request->getParam("enabled")->value() == "1" : -1;
+    int sort = request->hasParam("sort") ? watchlistSortFromName(request->getParam("sort")->value()) : -1;
+    sendPosted(request, postCommand(CMD_SET_WATCHLIST, enabled, sort));
+  });
+
+  // --- API: Ticker Tape page in the rotation ---
+  server.on("/set_tape", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (request->hasParam("enabled")) {
+      sendPosted(request, postCommand(CMD_SET_TAPE, request->getParam("enabled")->value() == "1"));
+      return;
+    }
     request->send(200, "text/plain", "OK");
   });
 
+  // --- API: Colour theme ---
+  server.on("/set_theme", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (request->hasParam("name")) {
+      sendPosted(request, postCommand(CMD_SET_THEME, themeFromName(request->getParam("name")->value())));
+      return;
+    }
+    request->send(200, "text/plain", "OK");
+  });
+
+  // --- API: Night profile (dim or blank the panel between two hours) ---
+  server.on("/set_power", HTTP_GET, [](AsyncWebServerRequest *request){
+    int mode = request->hasParam("night_mode") ? nightModeFromName(request->getParam("night_mode")->value()) : nightMode;
+    int start = request->hasParam("night_start") ? request->getParam("night_start")->value().toInt() : nightStartHour;
+    int end = request->hasParam("night_end") ? request->getParam("night_end")->value().toInt() : nightEndHour;
+    if (start < 0 || start > 23 || end < 0 || end > 23) {
+      request->send(400, "text/plain", "Hours must be 0-23");
+      return;
+    }
+    sendPosted(request, postCommand(CMD_SET_NIGHT, mode, start << 8 | end));
+  });
+
+  // --- API: Live Prices (Finnhub WebSocket) ---
+  server.on("/set_stream", HTTP_GET, [](AsyncWebServerRequest *request){
+    int enabled = request->hasParam("enabled") ? request->getParam("enabled")->value() == "1" : -1;
+    String url; // Empty: keep the current one
+    if (request->hasParam("url")) {
+      url = request->getParam("url")->value();
+      url.trim();
+      if (url.length() == 0) url = TRADE_STREAM_DEFAULT_URL;
+      if (url.length() >= COMMAND_TEXT_LEN) {
+        request->send(400, "text/plain", "URL too long (max " + String(COMMAND_TEXT_LEN - 1) + " characters)");
+        return;
+      }
+    }
+    sendPosted(request, postCommand(CMD_SET_STREAM, enabled, 0, url.c_str()));
+  });
+
+  // --- NEW ENDPOINT: Restore Default Lists ---
+  server.on("/restore_defaults", HTTP_GET, [](AsyncWebServerRequest *request){
+    sendPosted(request, postCommand(CMD_RESTORE_LISTS));
+  });
+
   // --- API for Network Status ---
   server.on("/get_network_status", HTTP_GET, [](AsyncWebServerRequest *request){
-    StaticJsonDocument<128> doc;
-    doc["ssid"] = currentSsid;
+    StaticJsonDocument<256> doc;
+    doc["ssid"] = readSnapshot().ssid;
+
+    // HTTPS connection pool counters
+    HttpsPoolStats tls = getHttpsPoolStats();
+    JsonObject pool = doc.createNestedObject("https_pool");
+    pool["requests"] = tls.requests;
+    pool["handshakes"] = tls.handshakes;
+    pool["handshakes_avoided"] = tls.handshakesAvoided;
+    pool["reconnects"] = tls.reconnects;
+    String jsonResponse;
+    serializeJson(doc, jsonResponse);
+    request->send(200, "application/json", jsonResponse);
+  });
+
+  // --- API for the upstream request scheduler (queue, rate limits) ---
+  server.on("/scheduler_status", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", netSchedulerStatusJson());
+  });
+
+  // --- API for renderer stats (SPI bytes pushed per frame) ---
+  server.on("/render_stats", HTTP_GET, [](AsyncWebServerRequest *request){
+    RenderStats stats = getRenderStats();
+    StaticJsonDocument<512> doc;
+    doc["frames"] = stats.frames;
+    doc["last_bytes"] = stats.lastBytes;
+    doc["last_rects"] = stats.lastRects;
+    doc["last_ms"] = stats.lastMs;
+    doc["total_bytes"] = stats.totalBytes;
+    doc["full_repaint_bytes"] = stats.fullBytes;
+    doc["transitions"] = stats.transitions;
+    doc["transition_frames"] = stats.transitionFrames;
+    doc["dropped_frames"] = stats.droppedFrames;
+    doc["last_transition_fps"] = stats.lastTransitionFps;
+    doc["strip_frames"] = stats.stripFrames;
+    doc["strip_fps"] = stats.stripFps;
+    IconCacheStats icons = getIconCacheStats();
+    doc["icon_cache_entries"] = icons.entries;
+    doc["icon_cache_bytes"] = icons.bytes;
+    doc["icon_cache_hits"] = icons.hits;
+    doc["icon_cache_misses"] = icons.misses;
+    String jsonResponse;
+    serializeJson(doc, jsonResponse);
+    request->send(200, "application/json", jsonResponse);
+  });
+
+  // --- API for touch input (gestures, SPI reads, touch-to-action latency) ---
+  server.on("/touch_stats", HTTP_GET, [](AsyncWebServerRequest *request){
+    TouchStats stats = getTouchStats();
+    StaticJsonDocument<384> doc;
+    doc["irqs"] = stats.irqs;
+    doc["spi_samples"] = stats.samples;
+    doc["taps"] = stats.taps;
+    doc["swipes"] = stats.swipes;
+    doc["long_presses"] = stats.longPresses;
+    doc["dropped"] = stats.dropped;
+    doc["handled"] = stats.handled;
+    doc["last_latency_ms"] = stats.lastLatencyMs;
+    doc["mean_latency_ms"] = stats.meanLatencyMs;
+    doc["max_latency_ms"] = stats.maxLatencyMs;
+    doc["over_budget"] = stats.overBudget;
+    doc["budget_ms"] = TOUCH_LATENCY_BUDGET_MS;
+    doc["rotation_paused"] = rotationPaused;
     String jsonResponse;
     serializeJson(doc, jsonResponse);
     request->send(200, "application/json", jsonResponse);
   });
 
+  // --- API for power use (time in each state, what the chip could set up) ---
+  server.on("/power_stats", HTTP_GET, [](AsyncWebServerRequest *request){
+    PowerStats stats = getPowerStats();
+    StaticJsonDocument<512> doc;
+    doc["mode"] = stats.mode;
+    doc["cpu_max_mhz"] = stats.maxMhz;
+    doc["cpu_min_mhz"] = stats.minMhz;
+    doc["active_s"] = stats.activeMs / 1000.0;
+    doc["idle_s"] = stats.idleMs / 1000.0;
+    uint64_t loopMs = stats.activeMs + stats.idleMs;
+    doc["idle_percent"] = loopMs > 0 ? 100.0 * stats.idleMs / loopMs : 0;
+    doc["idles"] = stats.idles;
+    doc["woken_early"] = stats.woken;
+    doc["panel_full_s"] = stats.panelFullMs / 1000.0;
+    doc["panel_dim_s"] = stats.panelDimMs / 1000.0;
+    doc["panel_off_s"] = stats.panelOffMs / 1000.0;
+    doc["night"] = stats.night;
+    doc["night_mode"] = nightModeName(nightMode);
+    String jsonResponse;
+    serializeJson(doc, jsonResponse);
+    request->send(200, "application/json", jsonResponse);
+  });
+
+#if RENDER_PROFILER
+  // --- API for the render profiler (per-primitive timings, FPS overlay) ---
+  server.on("/render_profile", HTTP_GET, [](AsyncWebServerRequest *request){
+    bool reset = request->hasParam("reset") && request->getParam("reset")->value() == "1";
+    int overlay = request->hasParam("overlay") ? request->getParam("overlay")->value().toInt() : -1;
+    request->send(200, "application/json", profilerJson(reset, overlay));
+  });
+#endif
+
   // --- API for Network Connect ---
+  // Answers at once with a job id; loop() runs the switch (see wifi_switch.h)
   server.on("/connect_wifi", HTTP_GET, [](AsyncWebServerRequest *request){
-    if (request->hasParam("ssid") && request->hasParam("pass")) {
-      String newSsid = request->getParam("ssid")->value();
-      String newPass = request->getParam("pass")->value();
+    if (!request->hasParam("ssid") || !request->hasParam("pass")) {
+      request->send(400, "text/plain", "Missing ssid or pass");
+      return;
+    }
+    String newSsid = request->getParam("ssid")->value();
+    String newPass = request->getParam("pass")->value();
+    if (newSsid.length() == 0 || newSsid.length() > 32) {
+      request->send(400, "text/plain", "SSID must be 1-32 characters");
+      return;
+    }
+    if (newPass.length() > 0 && (newPass.length() < 8 || newPass.length() > 63)) {
+      request->send(400, "text/plain", "Password must be empty or 8-63 characters");
+      return;
+    }
 
-      if (newSsid.length() > 0) {
-        Serial.printf("Connecting to new network: %s\n", newSsid.c_str());
-        drawStatusMessage("Connecting...", CAT_ACCENT);
-        
-        currentSsid = newSsid; // Update global
-        currentPass = newPass; // Update global
-        
-        WiFi.disconnect();
-        WiFi.begin(currentSsid.c_str(), currentPass.c_str());
-        
-        // Wait 10 seconds for connection
-        int retries = 0;
-        while (WiFi.status() != WL_CONNECTED && retries < 20) {
-          delay(500);
-          Serial.print(".");
-          retries++;
-        }
+    uint32_t job = wifiSwitchRequest(newSsid, newPass);
+    if (job == 0) {
+      request->send(409, "text/plain", "A network switch is already under way");
+      return;
+    }
+    Serial.printf("Connecting to new network: %s (job %u)\n", newSsid.c_str(), (unsigned)job);
+    StaticJsonDocument<128> doc;
+    doc["job"] = job;
+    doc["status"] = "/wifi_status?job=" + String(job);
+    String jsonResponse;
+    serializeJson(doc, jsonResponse);
+    request->send(202, "application/json", jsonResponse);
+  });
 
-        if (WiFi.status() == WL_CONNECTED) {
-          Serial.println("\nNew network connected!");
-          updateHeaderIP(); // Redraw header with new IP
-          saveWifiConfig(); // Save the new working config
-        } else {
-          Serial.println("\nFailed to connect. Reverting to default.");
-          drawStatusMessage("Connection Failed", CAT_RED);
-          // Revert to default logic (from secrets.h)
-          currentSsid = ssid;
-          currentPass = password;
-          WiFi.disconnect();
-          WiFi.begin(currentSsid.c_str(), currentPass.c_str());
-          saveWifiConfig(); // Re-save the default
-          // Wait for default to connect
-          while (WiFi.status() != WL_CONNECTED) {
-            delay(500);
-            Serial.print("r");
-          }
-          updateHeaderIP();
-        }
-      }
+  // --- API: Progress of the last /connect_wifi job (?job=N to check it is that one) ---
+  server.on("/wifi_status", HTTP_GET, [](AsyncWebServerRequest *request){
+    WifiSwitchStatus status = getWifiSwitchStatus();
+    if (request->hasParam("job") && (uint32_t)request->getParam("job")->value().toInt() != status.job) {
+      request->send(404, "text/plain", "Unknown job");
+      return;
     }
-    request->redirect("/");
+    StaticJsonDocument<384> doc;
+    doc["job"] = status.job;
+    doc["state"] = wifiSwitchStateName(status.state);
+    doc["done"] = status.done;
+    doc["ssid"] = status.ssid;
+    doc["attempt"] = status.attempt;
+    doc["attempts"] = status.attempts;
+    doc["reason"] = status.lastReason;
+    doc["elapsed_ms"] = status.elapsedMs;
+    doc["connected_ssid"] = WiFi.status() == WL_CONNECTED ? WiFi.SSID() : String("");
+    doc["ip"] = WiFi.localIP().toString();
+    String jsonResponse;
+    serializeJson(doc, jsonResponse);
+    request->send(200, "application/json", jsonResponse);
+  });
+
+  // --- API: Page layouts (see layout.h) ---
+  // GET returns /layout.json, or the built-in layout if there is none
+  server.on("/layout", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (LittleFS.exists(LAYOUT_FILE)) {
+      request->send(200, "application/json", readFile(LAYOUT_FILE));
+    } else {
+      request->send(200, "application/json", default_layout_json);
+    }
+  });
+
+  // POST layout=<json>: checked here, compiled by the main loop
+  server.on("/layout", HTTP_POST, [](AsyncWebServerRequest *request){
+    if (!request->hasParam("layout", true)) {
+      request->send(400, "text/plain", "Missing layout");
+      return;
+    }
+    const String& json = request->getParam("layout", true)->value();
+    String error;
+    if (json.length() > LAYOUT_MAX_BYTES) {
+      request->send(400, "text/plain", "Layout too large (max " + String(LAYOUT_MAX_BYTES) + " bytes)");
+      return;
+    }
+    if (!layoutValidate(json, error)) {
+      request->send(400, "text/plain", error);
+      return;
+    }
+    writeFile(LAYOUT_FILE, json);
+    sendPosted(request, postCommand(CMD_RELOAD_LAYOUT)); // Compiled by loop()
+  });
+
+  // Back to the built-in layout
+  server.on("/restore_layout", HTTP_GET, [](AsyncWebServerRequest *request){
+    LittleFS.remove(LAYOUT_FILE);
+    Serial.println("Restored the built-in layout.");
+    sendPosted(request, postCommand(CMD_RELOAD_LAYOUT));
   });
 
   // --- OTA UPDATE HANDLERS ---
@@ -273,7 +504,7 @@ void setup_web_server() {
       // This is called for each chunk of the file
       if (index == 0) {
         Serial.printf("OTA Update Start: %s\n", filename.c_str());
-        drawStatusMessage("OTA Update...", CAT_ACCENT);
+        postCommand(CMD_OTA_STARTED); // loop() draws the message
         
         // Start the update process
         if (!Update.begin(UPDATE_SIZE_UNKNOWN)) { // Use max available space
@@ -299,6 +530,10 @@ void setup_web_server() {
     }
   );
 
+  // --- Live screen preview (/screen, /screen_ws) ---
+  setupScreenMirror(server);
+
   server.onNotFound(notFound);
+
   server.begin();
 }
\ No newline at end of file
@@ -1,3 +1,8 @@
 #pragma once
 
-void setup_web_server();
\ No newline at end of file
+void setup_web_server();
+
+// loop() task: publishes copies of the rotation lists and the strings
+// loop() owns (network, stream URL) for the web handlers to read. Call
+// before setup_web_server() and after anything changes them.
+void publishWebSnapshot();
\ No newline at end of file
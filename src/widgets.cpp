@@ -0,0 +1,161 @@
+#include "widgets.h"
+#include "globals.h"    // For tft, colors
+#include "config.h"     // For USE_FREE_FONTS
+#include "render.h"     // For gfx(), renderFrame(), renderRegions()
+#include "theme.h"      // For themeSlotOf
+#include "drawing.h"    // For drawRangeBar
+#include "weather.h"    // For drawWeatherIcon
+#include "Free_Fonts.h"
+
+void applyFont(TFT_eSPI& target, FontId font) {
+#if USE_FREE_FONTS
+  switch (font) {
+    case FONT_SMALL:       target.setFreeFont(FSS9); break;
+    case FONT_SMALL_BOLD:  target.setFreeFont(FSSB9); break;
+    case FONT_MEDIUM:      target.setFreeFont(FSS12); break;
+    case FONT_MEDIUM_BOLD: target.setFreeFont(FSSB12); break;
+    case FONT_LARGE_BOLD:  target.setFreeFont(FSSB24); break;
+  }
+#else
+  switch (font) {
+    case FONT_SMALL:
+    case FONT_SMALL_BOLD:  target.setTextFont(2); break;
+    case FONT_MEDIUM:
+    case FONT_MEDIUM_BOLD: target.setTextFont(4); break;
+    case FONT_LARGE_BOLD:  target.setTextFont(8); break;
+  }
+#endif
+  target.setTextSize(1);
+}
+
+uint32_t widgetHash(const void* data, size_t len, uint32_t seed) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  uint32_t hash = seed;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t widgetHash(const String& text, uint32_t seed) {
+  return widgetHash(text.c_str(), text.length(), seed);
+}
+
+uint32_t widgetHashColor(uint16_t color, uint32_t seed) {
+  uint8_t slot = themeSlotOf(color);
+  return widgetHash(&slot, sizeof(slot), seed);
+}
+
+void WidgetPage::setLayout(const WidgetSpec* table, size_t size) {
+  specs.assign(table, table + size);
+  count = size;
+  next.assign(count, WidgetContent());
+  drawn.assign(count, WidgetContent());
+  drawnSlots.assign(count, 0);
+  drawnFrame = 0;
+}
+
+static void drawWidget(const WidgetSpec& spec, const WidgetContent& content) {
+
+  switch (spec.kind) {
+    case WIDGET_LABEL:
+    case WIDGET_VALUE:
+      if (content.text.length() == 0) return;
+      applyFont(gfx(), spec.font);
+      gfx().setTextColor(content.color, CAT_BG);
+      gfx().setTextDatum(spec.datum);
+      gfx().drawString(content.text, spec.ax, spec.ay);
+      break;
+    case WIDGET_BAR:
+      drawRangeBar(spec.ax, spec.ay, spec.size, content.lo, content.hi, content.pos, content.color);
+      break;
+    case WIDGET_ICON:
+      if (content.code < 0) return;
+      drawWeatherIcon(spec.ax, spec.ay, content.code, spec.size, content.night);
+      break;
+    case WIDGET_CUSTOM:
+      if (content.draw) content.draw();
+      break;
+  }
+}
+
+bool WidgetPage::changed(size_t i) const {
+  const WidgetContent& a = next[i];
+  const WidgetContent& b = drawn[i];
+  return a.text != b.text || themeSlotOf(a.color) != drawnSlots[i] || a.lo != b.lo || a.hi != b.hi || a.pos != b.pos ||
+         a.code != b.code || a.night != b.night || a.hash != b.hash;
+}
+
+// --- HELPER: Screen columns [x0, x1) of the glyphs that differ ---
+// Only when the old and new text have the same length and pixel width
+// (digits are tabular in the GFX fonts), so nothing else moves.
+bool WidgetPage::glyphSpan(size_t i, int& x0, int& x1) const {
+  const WidgetSpec& spec = specs[i];
+  const String& before = drawn[i].text;
+  const String& after = next[i].text;
+  if (before.length() != after.length() || before.length() == 0 || themeSlotOf(next[i].color) != drawnSlots[i]) return false;
+  if (before == after) return false; // Changed in something other than its text: nothing to narrow down to
+
+  // Measure on the panel object; nothing is drawn
+  applyFont(tft, spec.font);
+  int width = tft.textWidth(after);
+  if (tft.textWidth(before) != width) return false;
+
+  int length = after.length();
+  int first = 0;
+  while (first < length && before[first] == after[first]) first++;
+  int last = length - 1;
+  while (last > first && before[last] == after[last]) last--;
+
+  int left = spec.ax;                          // TL, ML, BL, L_BASELINE
+  if (spec.datum % 3 == 1) left -= width / 2;  // TC, MC, BC, C_BASELINE
+  if (spec.datum % 3 == 2) left -= width;      // TR, MR, BR, R_BASELINE
+
+  // A pixel of slack for glyphs that overhang their advance
+  x0 = left + tft.textWidth(after.substring(0, first)) - 1;
+  x1 = left + tft.textWidth(after.substring(0, last + 1)) + 1;
+  x0 = max(x0, (int)spec.x);
+  x1 = min(x1, spec.x + spec.w);
+  return x1 > x0;
+}
+
+// --- HELPER: Remember what is on screen now ---
+void WidgetPage::keepDrawn() {
+  drawn = next;
+  for (size_t i = 0; i < count; i++) drawnSlots[i] = themeSlotOf(next[i].color);
+}
+
+void WidgetPage::render() {
+  // 1. Something else is on the panel, or a slide to this page is due: draw the whole page.
+  // The frame keeps its own copy: the next frame may animate away from it
+  // after this page has been refilled (a swipe to the next ticker).
+  if (drawnFrame != renderFrameId() || renderPanelTouched() || renderTransitionPending()) {
+    renderFrame([specs = specs, content = next]() {
+      for (size_t i = 0; i < specs.size(); i++) drawWidget(specs[i], content[i]);
+    });
+    drawnFrame = renderFrameId();
+    keepDrawn();
+    return;
+  }
+
+  // 2. Otherwise collect the rects of what changed
+  std::vector<RenderRect> rects;
+  for (size_t i = 0; i < count; i++) {
+    if (!changed(i)) continue;
+    const WidgetSpec& spec = specs[i];
+    int x0 = spec.x, x1 = spec.x + spec.w;
+    if (spec.kind == WIDGET_VALUE) glyphSpan(i, x0, x1);
+    rects.push_back({(int16_t)x0, spec.y, (int16_t)(x1 - x0), spec.h});
+  }
+
+  // 3. Redraw each rect with every widget under it, in table order
+  renderRegions(rects, [this](const RenderRect& r) {
+    for (size_t i = 0; i < count; i++) {
+      const WidgetSpec& spec = specs[i];
+      if (spec.x < r.x + r.w && r.x < spec.x + spec.w && spec.y < r.y + r.h && r.y < spec.y + spec.h) {
+        drawWidget(spec, next[i]);
+      }
+    }
+  });
+  keepDrawn();
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <functional>
+#include <vector>
+
+// =========================================================================
+// RETAINED WIDGETS
+// The stock and weather pages are tables of widgets (a layout, see
+// layout.h) plus the content each widget shows. A page fills in new content and calls
+// render(): the first time (or after another page was on screen) the
+// whole page is drawn as one frame; after that only widgets whose
+// content changed are redrawn, and numeric values only resend the
+// glyphs that differ. A streamed price tick costs one or two digits.
+//
+// Widgets draw into gfx() and never clear their own bounds: a redrawn
+// rect is cleared to CAT_BG and every widget overlapping it is drawn
+// again in table order, so later entries sit on top of earlier ones.
+// =========================================================================
+
+enum WidgetKind : uint8_t {
+  WIDGET_LABEL,  // Text, redrawn whole when it changes
+  WIDGET_VALUE,  // Numeric text; only the changed glyphs are redrawn
+  WIDGET_BAR,    // Low/high range bar with a position dot
+  WIDGET_ICON,   // Weather icon
+  WIDGET_CUSTOM, // Drawn by the page, diffed on a content hash
+};
+
+enum FontId : uint8_t {
+  FONT_SMALL,       // FSS9 / font 2
+  FONT_SMALL_BOLD,  // FSSB9 / font 2
+  FONT_MEDIUM,      // FSS12 / font 4
+  FONT_MEDIUM_BOLD, // FSSB12 / font 4
+  FONT_LARGE_BOLD,  // FSSB24 / font 8
+};
+
+// Where and how a widget is drawn (one row of a layout table)
+struct WidgetSpec {
+  WidgetKind kind;
+  int16_t x, y, w, h; // Bounds: every pixel the widget can touch
+  int16_t ax, ay;     // Anchor: text datum point, icon centre, bar start
+  uint8_t datum;      // Text datum (MC_DATUM, ...)
+  FontId font;
+  int16_t size;       // Icon size, bar length
+};
+
+// What a widget shows. Compared field by field with the last frame.
+struct WidgetContent {
+  String text;
+  uint16_t color = 0;
+  float lo = 0, hi = 0, pos = 0; // Bar
+  int code = 0;                  // Icon: WMO weather code, -1 for none
+  bool night = false;            // Icon
+  uint32_t hash = 0;             // Custom: must change when the drawing does
+  std::function<void()> draw;    // Custom; kept by the frame, so capture by value
+};
+
+class WidgetPage {
+public:
+  WidgetPage() {}
+  WidgetPage(const WidgetSpec* specs, size_t count) { setLayout(specs, count); }
+
+  // Copies the table; the next render() draws the whole page
+  void setLayout(const WidgetSpec* specs, size_t count);
+
+  // Content for the next render()
+  WidgetContent& operator[](size_t i) { return next[i]; }
+
+  // Draws whatever changed since the last render()
+  void render();
+
+private:
+  std::vector<WidgetSpec> specs;
+  size_t count = 0;
+  std::vector<WidgetContent> next;
+  std::vector<WidgetContent> drawn;
+  std::vector<uint8_t> drawnSlots; // Theme slot of each drawn colour: the same after a theme switch
+  uint32_t drawnFrame = 0; // renderFrameId() when we were last drawn in full
+
+  bool changed(size_t i) const;
+  void keepDrawn();
+  bool glyphSpan(size_t i, int& x0, int& x1) const;
+};
+
+// Selects a FontId on `target` (the panel, the frame or a sprite)
+void applyFont(TFT_eSPI& target, FontId font);
+
+// FNV-1a, for custom widget hashes
+uint32_t widgetHash(const void* data, size_t len, uint32_t seed = 2166136261u);
+uint32_t widgetHash(const String& text, uint32_t seed = 2166136261u);
+// ...of a colour's theme slot, so switching theme does not count as a change
+uint32_t widgetHashColor(uint16_t color, uint32_t seed = 2166136261u);
@@ -0,0 +1,202 @@
+#include "wifi_switch.h"
+#include "globals.h"     // For currentSsid, currentPass, needsRedraw
+#include "config.h"      // For WIFI_SWITCH_* settings
+#include "secrets.h"     // For the default ssid / password
+#include "persistence.h" // For saveWifiConfig
+#include "drawing.h"     // For drawStatusMessage
+#include "power.h"       // For powerWake, powerWakeAt, powerPanelOn
+#include "web_server.h"  // For publishWebSnapshot
+#include <WiFi.h>
+#include <atomic>
+
+struct WifiNetwork {
+  String ssid;
+  String pass;
+  WifiSwitchState trying; // State while it is tried
+  WifiSwitchState joined; // ...and once it has an IP
+};
+
+// --- Request and status (any task, under `lock`) ---
+static SemaphoreHandle_t lock = nullptr;
+static bool requestPending = false;
+static WifiNetwork requested;
+static uint32_t lastJob = 0;
+static WifiSwitchStatus status = {};
+static unsigned long jobStartedAt = 0;
+
+// --- The switch under way (loop() task) ---
+static bool running = false;
+static WifiNetwork networks[3];
+static int networkCount = 0;
+static int tryingIndex = 0;
+static unsigned long tryDeadline = 0;
+
+// --- From the WiFi event task, for the network being tried ---
+static std::atomic<bool> gotIp(false);
+static std::atomic<int> refusals(0);
+static std::atomic<int> lastReason(0);
+
+// Disconnect reasons that mean this network will not work as asked
+static bool isRefusal(int reason) {
+  return reason == WIFI_REASON_NO_AP_FOUND || reason == WIFI_REASON_AUTH_FAIL ||
+         reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT || reason == WIFI_REASON_HANDSHAKE_TIMEOUT;
+}
+
+static void onWifiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    gotIp = true;
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    int reason = info.wifi_sta_disconnected.reason;
+    if (reason == WIFI_REASON_ASSOC_LEAVE) return; // Our own disconnect() before begin()
+    lastReason = reason;
+    if (isRefusal(reason)) refusals++;
+  } else {
+    return;
+  }
+  if (running) powerWake(); // loop() moves the switch along
+}
+
+// --- HELPER: Publish the state for /wifi_status ---
+static void setStatus(WifiSwitchState state, const String& ssid, bool done) {
+  xSemaphoreTake(lock, portMAX_DELAY);
+  status.state = state;
+  strlcpy(status.ssid, ssid.c_str(), sizeof(status.ssid));
+  status.attempt = tryingIndex + 1;
+  status.attempts = networkCount;
+  status.lastReason = lastReason;
+  status.done = done;
+  if (done) status.elapsedMs = millis() - jobStartedAt; // Stops counting
+  xSemaphoreGive(lock);
+}
+
+// --- HELPER: Start on networks[index] ---
+static void tryNetwork(int index) {
+  tryingIndex = index;
+  const WifiNetwork& network = networks[index];
+  Serial.printf("[wifi] %s %s (%d of %d)\n", wifiSwitchStateName(network.trying), network.ssid.c_str(), index + 1, networkCount);
+  if (powerPanelOn()) {
+    drawStatusMessage(index == 0 ? "Connecting..." : (network.trying == WIFI_SWITCH_FALLING_BACK ? "Falling back..." : "Reverting..."),
+                      index == 0 ? CAT_ACCENT : CAT_YELLOW);
+  }
+
+  gotIp = false;
+  refusals = 0;
+  lastReason = 0;
+  WiFi.disconnect();
+  WiFi.begin(network.ssid.c_str(), network.pass.c_str());
+  tryDeadline = millis() + WIFI_SWITCH_TIMEOUT_MS;
+  setStatus(network.trying, network.ssid, false);
+}
+
+// --- HELPER: End the job on networks[tryingIndex] ---
+static void finish(bool joined) {
+  const WifiNetwork& network = networks[tryingIndex];
+  running = false;
+
+  // The radio stays on the last network tried, and keeps retrying it if it failed
+  currentSsid = network.ssid;
+  currentPass = network.pass;
+  publishWebSnapshot(); // The network the GUI shows
+  if (joined) {
+    Serial.printf("[wifi] On %s (%s)\n", network.ssid.c_str(), WiFi.localIP().toString().c_str());
+    saveWifiConfig();
+    needsRedraw = true; // The header shows the network and IP
+  } else {
+    Serial.printf("[wifi] No network connected (last reason %d); retrying %s\n", (int)lastReason, network.ssid.c_str());
+    if (powerPanelOn()) drawStatusMessage("Connection Failed", CAT_RED); // Until the next page
+  }
+  setStatus(joined ? network.joined : WIFI_SWITCH_FAILED, network.ssid, true);
+}
+
+void startWifiSwitch() {
+  lock = xSemaphoreCreateMutex();
+  WiFi.onEvent(onWifiEvent);
+}
+
+uint32_t wifiSwitchRequest(const String& ssid, const String& pass) {
+  xSemaphoreTake(lock, portMAX_DELAY);
+  bool busy = requestPending || (status.job != 0 && !status.done);
+  uint32_t job = 0;
+  if (!busy) {
+    job = ++lastJob;
+    requested.ssid = ssid;
+    requested.pass = pass;
+    requestPending = true;
+    jobStartedAt = millis();
+    status = {};
+    status.job = job;
+    status.state = WIFI_SWITCH_CONNECTING;
+    strlcpy(status.ssid, ssid.c_str(), sizeof(status.ssid));
+  }
+  xSemaphoreGive(lock);
+  if (job != 0) powerWake(); // loop() starts it
+  return job;
+}
+
+void wifiSwitchTick() {
+  // 1. Start a requested switch: the new network, then the one we were on, then the default
+  if (!running) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool start = requestPending;
+    WifiNetwork wanted = requested;
+    requestPending = false;
+    requested.pass = ""; // Held in networks[] from here on
+    xSemaphoreGive(lock);
+    if (!start) return;
+
+    networkCount = 0;
+    networks[networkCount++] = {wanted.ssid, wanted.pass, WIFI_SWITCH_CONNECTING, WIFI_SWITCH_CONNECTED};
+    bool wasOn = WiFi.status() == WL_CONNECTED;
+    if (wasOn && (currentSsid != wanted.ssid || currentPass != wanted.pass)) {
+      networks[networkCount++] = {currentSsid, currentPass, WIFI_SWITCH_FALLING_BACK, WIFI_SWITCH_FELL_BACK};
+    }
+    String defaultSsid = ssid, defaultPass = password;
+    bool tried = false;
+    for (int i = 0; i < networkCount; i++) tried |= networks[i].ssid == defaultSsid && networks[i].pass == defaultPass;
+    if (!tried) networks[networkCount++] = {defaultSsid, defaultPass, WIFI_SWITCH_REVERTING, WIFI_SWITCH_REVERTED};
+
+    running = true;
+    tryNetwork(0);
+    powerWakeAt(tryDeadline);
+    return;
+  }
+
+  // 2. Joined
+  if (gotIp && WiFi.status() == WL_CONNECTED) {
+    finish(true);
+    return;
+  }
+
+  // 3. Refused or out of time: the next network, if there is one
+  bool timedOut = (long)(millis() - tryDeadline) >= 0;
+  if (refusals >= WIFI_SWITCH_MAX_REFUSALS || timedOut) {
+    Serial.printf("[wifi] %s: %s\n", networks[tryingIndex].ssid.c_str(), timedOut ? "timed out" : "refused");
+    if (tryingIndex + 1 < networkCount) tryNetwork(tryingIndex + 1);
+    else finish(false);
+  }
+  if (running) powerWakeAt(tryDeadline);
+}
+
+WifiSwitchStatus getWifiSwitchStatus() {
+  xSemaphoreTake(lock, portMAX_DELAY);
+  WifiSwitchStatus copy = status;
+  if (copy.job != 0 && !copy.done) {
+    copy.elapsedMs = millis() - jobStartedAt;
+    copy.lastReason = lastReason;
+  }
+  xSemaphoreGive(lock);
+  return copy;
+}
+
+const char* wifiSwitchStateName(WifiSwitchState state) {
+  switch (state) {
+    case WIFI_SWITCH_CONNECTING: return "connecting";
+    case WIFI_SWITCH_FALLING_BACK: return "falling_back";
+    case WIFI_SWITCH_REVERTING: return "reverting";
+    case WIFI_SWITCH_CONNECTED: return "connected";
+    case WIFI_SWITCH_FELL_BACK: return "fell_back";
+    case WIFI_SWITCH_REVERTED: return "reverted";
+    case WIFI_SWITCH_FAILED: return "failed";
+    default: return "idle";
+  }
+}
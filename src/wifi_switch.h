@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+
+// =========================================================================
+// WIFI SWITCH
+// /connect_wifi asks for a new network and answers at once with a job
+// id; the switch itself runs on the loop() task as a small state
+// machine, driven by WiFi events (got an IP, disconnected and why) and
+// one timeout per network, so no task ever waits for the radio. It
+// tries, in order:
+//   connecting    the requested network
+//   falling back  the network the device was on, if it was connected
+//   reverting     the default network (secrets.h)
+// each for up to WIFI_SWITCH_TIMEOUT_MS, or until the access point has
+// refused it WIFI_SWITCH_MAX_REFUSALS times (not found, wrong password).
+// The first one that gets an IP is saved to /wifi.json. If none does,
+// the radio keeps retrying the default on its own.
+//
+// /wifi_status reports the job's progress. Switching networks may move
+// the device to another IP, or another LAN, mid-job.
+// =========================================================================
+
+enum WifiSwitchState {
+  WIFI_SWITCH_IDLE,         // No job since boot
+  WIFI_SWITCH_CONNECTING,
+  WIFI_SWITCH_FALLING_BACK,
+  WIFI_SWITCH_REVERTING,
+  WIFI_SWITCH_CONNECTED,    // Done: on the requested network
+  WIFI_SWITCH_FELL_BACK,    // Done: back on the previous one
+  WIFI_SWITCH_REVERTED,     // Done: on the default one
+  WIFI_SWITCH_FAILED,       // Done: on none of them
+};
+
+struct WifiSwitchStatus {
+  uint32_t job;             // 0 before the first request
+  WifiSwitchState state;
+  char ssid[33];            // Network being tried, or the one it ended on
+  int attempt;              // 1-based, of `attempts` networks to try
+  int attempts;
+  int lastReason;           // Last disconnect reason (esp_wifi_types.h), 0 if none
+  unsigned long elapsedMs;  // Since the request
+  bool done;
+};
+
+// Registers for WiFi events. Call once from setup().
+void startWifiSwitch();
+
+// Any task: queues a switch to `ssid` and returns its job id, or 0 if a
+// switch is already under way.
+uint32_t wifiSwitchRequest(const String& ssid, const String& pass);
+
+// loop() task, every pass: starts a queued switch and moves the one
+// under way along.
+void wifiSwitchTick();
+
+WifiSwitchStatus getWifiSwitchStatus();
+
+// "idle", "connecting", "falling_back", "reverting", "connected",
+// "fell_back", "reverted", "failed"
+const char* wifiSwitchStateName(WifiSwitchState state);
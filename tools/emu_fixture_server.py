@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""
+Canned API responses for the native emulator (pio run -e native).
+
+The emulator sends every HTTPS fetch here as plain HTTP, with the real
+host folded into the path:
+
+  https://finnhub.io/api/v1/quote?symbol=SPY&token=...
+    -> GET /finnhub.io/api/v1/quote?symbol=SPY&token=...
+
+and this server answers from a fixture file. For that request the first
+existing file of these wins:
+
+  emu/fixtures/finnhub.io/api/v1/quote.symbol=SPY.json   (one per query value)
+  emu/fixtures/finnhub.io/api/v1/quote.json
+
+Batched requests (latitude=51.5,40.7) get the object fixture repeated once
+per comma-separated value, as a JSON array, like Open-Meteo returns them.
+Unknown paths are a 404, which the firmware shows as its usual API error.
+
+Usage:
+  python tools/emu_fixture_server.py [--port 8089] [--delay-ms 0] [fixtures_dir]
+"""
+import argparse
+import http.server
+import json
+import pathlib
+import time
+import urllib.parse
+
+DEFAULT_FIXTURES = pathlib.Path(__file__).resolve().parent.parent / "emu" / "fixtures"
+
+
+def find_fixture(root, path, raw_query):
+    base = root / path.lstrip("/")
+    for pair in filter(None, raw_query.split("&")):  # As sent, e.g. name=New+York
+        if "/" in pair:
+            continue  # Not a file name (timezone=Europe/London)
+        candidate = base.with_name(f"{base.name}.{pair}.json")
+        if candidate.is_file():
+            return candidate
+    candidate = base.with_name(base.name + ".json")
+    return candidate if candidate.is_file() else None
+
+
+def batch_size(query):
+    # Only coordinates batch; other comma lists (current=a,b,c) are field names
+    return len(query.get("latitude", [""])[0].split(","))
+
+
+def make_handler(root, delay_ms):
+    class Handler(http.server.BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"  # Keep-alive, like the device's connection pool
+
+        def do_GET(self):
+            url = urllib.parse.urlsplit(self.path)
+            query = urllib.parse.parse_qs(url.query)
+            fixture = find_fixture(root, urllib.parse.unquote(url.path), url.query)
+            if fixture is None:
+                self.reply(404, b'{"error":"no fixture"}')
+                return
+
+            body = fixture.read_bytes()
+            count = batch_size(query)
+            if count > 1 and body.lstrip().startswith(b"{"):
+                body = json.dumps([json.loads(body)] * count).encode()
+            if delay_ms:
+                time.sleep(delay_ms / 1000.0)
+            self.reply(200, body)
+
+        def reply(self, code, body):
+            self.send_response(code)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, fmt, *args):
+            print(f"{self.command} {self.path} -> {args[1] if len(args) > 1 else ''}")
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("fixtures", nargs="?", type=pathlib.Path, default=DEFAULT_FIXTURES)
+    parser.add_argument("--port", type=int, default=8089)
+    parser.add_argument("--delay-ms", type=int, default=0, help="Added latency per response")
+    args = parser.parse_args()
+
+    print(f"Serving fixtures from {args.fixtures} on http://127.0.0.1:{args.port}")
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", args.port), make_handler(args.fixtures, args.delay_ms))
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for Finnhub's trade WebSocket (wss://ws.finnhub.io).
+
+Replays recorded trade messages to the device so live prices can be
+tested without network access or an API key. Only trades for symbols the
+device has subscribed to are sent, so /add_stock and /remove_stock can be
+checked too.
+
+Usage:
+  pip install websockets
+  python tools/finnhub_ws_replay.py [--port 8765] [--speed 1.0] [recording.jsonl]
+
+Then, in the web GUI's Rotation tab, enable Live Prices and set the
+stream URL to ws://<this-pc-ip>:8765
+"""
+import argparse
+import asyncio
+import json
+import pathlib
+
+import websockets
+
+DEFAULT_RECORDING = pathlib.Path(__file__).with_name("finnhub_trades.jsonl")
+
+
+def load_recording(path):
+    messages = []
+    for line in path.read_text().splitlines():
+        line = line.strip()
+        if line:
+            messages.append(json.loads(line))
+    return messages
+
+
+def trade_time(msg):
+    data = msg.get("data") or []
+    return data[0]["t"] if data else None
+
+
+async def replay(ws, messages, speed):
+    subscribed = set()
+
+    async def read_subscriptions():
+        async for raw in ws:
+            req = json.loads(raw)
+            symbol = req.get("symbol", "")
+            if req.get("type") == "subscribe":
+                subscribed.add(symbol)
+            elif req.get("type") == "unsubscribe":
+                subscribed.discard(symbol)
+            print(f"{req.get('type')} {symbol} -> {sorted(subscribed)}")
+
+    reader = asyncio.create_task(read_subscriptions())
+    try:
+        while True:  # Loop the recording forever
+            last_t = None
+            for msg in messages:
+                t = trade_time(msg)
+                delay = 1.0 if t is None or last_t is None else (t - last_t) / 1000.0
+                last_t = t if t is not None else last_t
+                await asyncio.sleep(max(delay, 0.05) / speed)
+
+                if msg.get("type") != "trade":
+                    await ws.send(json.dumps(msg))
+                    continue
+                trades = [d for d in msg["data"] if d["s"] in subscribed]
+                if trades:
+                    await ws.send(json.dumps({"data": trades, "type": "trade"}))
+    except websockets.ConnectionClosed:
+        print("Device disconnected")
+    finally:
+        reader.cancel()
+
+
+async def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("recording", nargs="?", type=pathlib.Path, default=DEFAULT_RECORDING)
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--speed", type=float, default=1.0, help="Playback speed multiplier")
+    args = parser.parse_args()
+
+    messages = load_recording(args.recording)
+    print(f"Replaying {len(messages)} messages from {args.recording} on ws://0.0.0.0:{args.port}")
+
+    async def handler(ws, *_):
+        print(f"Device connected: {ws.remote_address}")
+        await replay(ws, messages, args.speed)
+
+    async with websockets.serve(handler, "0.0.0.0", args.port):
+        await asyncio.Future()
+
+
+if __name__ == "__main__":
+    asyncio.run(main())